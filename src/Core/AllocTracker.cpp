@@ -0,0 +1,129 @@
+#include "AllocTracker.h"
+#include "raylib.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    constexpr int TagCount = (int)AllocTracker::Tag::Count;
+
+    struct Counters {
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> frees{0};
+        std::atomic<size_t> bytesAllocated{0};
+        std::atomic<size_t> liveBytes{0};
+    };
+
+    // Constant-initialized, so usable by allocations made before main()
+    Counters counters[TagCount];
+    thread_local AllocTracker::Tag currentTag = AllocTracker::Tag::Other;
+
+    // Every block carries its size and tag so frees are attributed to the
+    // subsystem that allocated them. The header sits right before the user
+    // block and remembers where the malloc'd block starts, which differs
+    // from the header for over-aligned allocations.
+    struct alignas(alignof(std::max_align_t)) Header {
+        void* base;
+        size_t size;
+        int tag;
+    };
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        size_t padding = alignment > alignof(std::max_align_t) ? alignment : 0;
+        char* base = (char*)std::malloc(sizeof(Header) + padding + size);
+        if (!base) return nullptr;
+
+        uintptr_t user = (uintptr_t)(base + sizeof(Header));
+        if (padding) user = (user + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+        Header* header = (Header*)user - 1;
+        header->base = base;
+        header->size = size;
+        header->tag = (int)currentTag;
+
+        Counters& c = counters[header->tag];
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+        c.liveBytes.fetch_add(size, std::memory_order_relaxed);
+        return (void*)user;
+    }
+
+    void* AllocateOrThrow(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        void* p = Allocate(size, alignment);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+
+    void Free(void* p) {
+        if (!p) return;
+        Header* header = (Header*)p - 1;
+        Counters& c = counters[header->tag];
+        c.frees.fetch_add(1, std::memory_order_relaxed);
+        c.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+        std::free(header->base);
+    }
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size); }
+void* operator new[](size_t size) { return AllocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Free(p); }
+void* operator new(size_t size, std::align_val_t align) { return AllocateOrThrow(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align) { return AllocateOrThrow(size, (size_t)align); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return Allocate(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return Allocate(size, (size_t)align); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+
+namespace AllocTracker {
+    const char* GetTagName(Tag tag) {
+        static const char* names[TagCount] = { "Other", "Arena", "Level", "Entities", "Snapshot", "Render" };
+        return names[(int)tag];
+    }
+
+    Stats GetStats(Tag tag) {
+        const Counters& c = counters[(int)tag];
+        return { c.allocations.load(std::memory_order_relaxed), c.frees.load(std::memory_order_relaxed),
+                 c.bytesAllocated.load(std::memory_order_relaxed), c.liveBytes.load(std::memory_order_relaxed) };
+    }
+
+    Stats GetTotals() {
+        Stats total = {};
+        for (int i = 0; i < TagCount; i++) {
+            Stats s = GetStats((Tag)i);
+            total.allocations += s.allocations;
+            total.frees += s.frees;
+            total.bytesAllocated += s.bytesAllocated;
+            total.liveBytes += s.liveBytes;
+        }
+        return total;
+    }
+
+    Scope::Scope(Tag tag) : previous(currentTag) {
+        currentTag = tag;
+    }
+
+    Scope::~Scope() {
+        currentTag = previous;
+    }
+
+    void Log(const char* prefix) {
+        TraceLog(LOG_INFO, "%s: %-9s %10s %10s %12s %10s", prefix, "tag", "allocs", "frees", "bytes", "live");
+        for (int i = 0; i < TagCount; i++) {
+            Stats s = GetStats((Tag)i);
+            TraceLog(LOG_INFO, "%s: %-9s %10zu %10zu %12zu %10zu", prefix, GetTagName((Tag)i),
+                     s.allocations, s.frees, s.bytesAllocated, s.liveBytes);
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+
+// Counts every heap allocation made through global new/delete, attributed to
+// the subsystem tag that is current on the allocating thread. raylib's own
+// buffers (textures, audio) come from malloc and are not included.
+namespace AllocTracker {
+    enum class Tag {
+        Other,
+        Arena,      // Blocks reserved by a RunArena
+        Level,
+        Entities,
+        Snapshot,   // Copies published to the render thread
+        Render,
+        Count
+    };
+
+    struct Stats {
+        size_t allocations;     // Total since startup
+        size_t frees;
+        size_t bytesAllocated;  // Total since startup
+        size_t liveBytes;       // Currently allocated
+    };
+
+    const char* GetTagName(Tag tag);
+    Stats GetStats(Tag tag);
+    Stats GetTotals();
+
+    // Attributes allocations on this thread to `tag` until destroyed
+    class Scope {
+    public:
+        explicit Scope(Tag tag);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Tag previous;
+    };
+
+    // Logs one line per tag
+    void Log(const char* prefix);
+}
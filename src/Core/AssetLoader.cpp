@@ -0,0 +1,68 @@
+#include "AssetLoader.h"
+#include <type_traits>
+
+namespace {
+    // raylib releases differ on whether LoadFontData() also reports the glyph count
+    template <typename Fn>
+    GlyphInfo* LoadGlyphs(Fn fn, const unsigned char* data, int size, int fontSize, int* glyphCount) {
+        if constexpr (std::is_invocable_v<Fn, const unsigned char*, int, int, int*, int, int, int*>) {
+            return fn(data, size, fontSize, nullptr, AssetLoader::DefaultGlyphCount, FONT_DEFAULT, glyphCount);
+        } else {
+            *glyphCount = AssetLoader::DefaultGlyphCount;
+            return fn(data, size, fontSize, nullptr, AssetLoader::DefaultGlyphCount, FONT_DEFAULT);
+        }
+    }
+}
+
+FontData AssetLoader::DecodeFont(const char* fileName, int fontSize) {
+    FontData data;
+    int size = 0;
+    unsigned char* file = LoadFileData(fileName, &size);
+    if (!file) return data;
+
+    data.baseSize = fontSize;
+    data.glyphPadding = DefaultGlyphPadding;
+    data.glyphs = LoadGlyphs(LoadFontData, file, size, fontSize, &data.glyphCount);
+    UnloadFileData(file);
+
+    if (data.glyphs) {
+        data.atlas = GenImageFontAtlas(data.glyphs, &data.recs, data.glyphCount, data.baseSize, data.glyphPadding, 0);
+    }
+    return data;
+}
+
+Font AssetLoader::UploadFont(FontData& data) {
+    // Fall back to the built-in font if decoding failed (mirrors LoadFont())
+    if (!data.glyphs || !data.atlas.data) return GetFontDefault();
+
+    Font font = {};
+    font.baseSize = data.baseSize;
+    font.glyphCount = data.glyphCount;
+    font.glyphPadding = data.glyphPadding;
+    font.glyphs = data.glyphs;
+    font.recs = data.recs;
+    font.texture = LoadTextureFromImage(data.atlas);
+
+    UnloadImage(data.atlas);
+    data = FontData{};
+    return font;
+}
+
+Font AssetLoader::WrapFont(FontData& data) {
+    Font font = {};
+    font.baseSize = data.baseSize;
+    font.glyphCount = data.glyphCount;
+    font.glyphPadding = data.glyphPadding;
+    font.glyphs = data.glyphs;
+    font.recs = data.recs;
+
+    if (data.atlas.data) UnloadImage(data.atlas);
+    data = FontData{};
+    return font;
+}
+
+void AssetLoader::UnloadSoftwareFont(Font& font) {
+    if (font.glyphs) UnloadFontData(font.glyphs, font.glyphCount);
+    if (font.recs) MemFree(font.recs);
+    font = Font{};
+}
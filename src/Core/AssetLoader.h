@@ -0,0 +1,32 @@
+#pragma once
+#include "raylib.h"
+
+// CPU-side font data: glyphs rasterized and packed into an atlas image,
+// ready for the GPU upload in AssetLoader::UploadFont().
+struct FontData {
+    GlyphInfo* glyphs = nullptr;
+    Rectangle* recs = nullptr;
+    Image atlas = {};
+    int glyphCount = 0;
+    int baseSize = 0;
+    int glyphPadding = 0;
+};
+
+namespace AssetLoader {
+    // Same defaults LoadFont() uses for TTF files
+    constexpr int DefaultFontSize = 32;
+    constexpr int DefaultGlyphCount = 95;
+    constexpr int DefaultGlyphPadding = 4;
+
+    // Reads and rasterizes the font; touches no GL state, safe on any thread
+    FontData DecodeFont(const char* fileName, int fontSize = DefaultFontSize);
+
+    // Uploads the atlas texture; must run on the thread that owns the GL context.
+    // Ownership of glyphs/recs moves into the returned Font (release with UnloadFont).
+    Font UploadFont(FontData& data);
+
+    // Builds a Font with glyph bitmaps but no texture, for software rendering.
+    // Release with UnloadSoftwareFont().
+    Font WrapFont(FontData& data);
+    void UnloadSoftwareFont(Font& font);
+}
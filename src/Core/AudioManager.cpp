@@ -1,4 +1,5 @@
 #include "AudioManager.h"
+#include "Constants.h"
 
 AudioManager::AudioManager() {
 }
@@ -7,46 +8,81 @@ AudioManager::~AudioManager() {
 }
 
 void AudioManager::Init() {
+    InitDevice();
+    Decode();
+    Upload();
+}
+
+void AudioManager::InitDevice() {
     InitAudioDevice();
+}
 
+void AudioManager::Decode() {
     // Load Audio
     // NOTE: These files are placeholders. Raylib logs warnings if not found.
-    shootSound = LoadSound("assets/shoot.wav");
-    explodeSound = LoadSound("assets/explode.wav");
-    gameOverSound = LoadSound("assets/gameover.wav");
-    
-    bgm = LoadMusicStream("assets/music.mp3");
-    menu = LoadMusicStream("assets/menu.mp3");
+    shootWave = LoadWave("assets/shoot.wav");
+    explodeWave = LoadWave("assets/explode.wav");
+    gameOverWave = LoadWave("assets/gameover.wav");
+
+    // Music is streamed, so only the compressed file is read here
+    bgmData = LoadFileData("assets/music.mp3", &bgmDataSize);
+    menuData = LoadFileData("assets/menu.mp3", &menuDataSize);
+}
+
+void AudioManager::Upload() {
+    shootSound = LoadSoundFromWave(shootWave);
+    explodeSound = LoadSoundFromWave(explodeWave);
+    gameOverSound = LoadSoundFromWave(gameOverWave);
+    UnloadWave(shootWave);
+    UnloadWave(explodeWave);
+    UnloadWave(gameOverWave);
+
+    // The decoder reads from these buffers for as long as the stream lives.
+    // Stream buffers hold enough audio to play through an idle frame.
+    SetAudioStreamBufferSizeDefault(Constants::Idle::MusicBufferFrames);
+    bgm = LoadMusicStreamFromMemory(".mp3", bgmData, bgmDataSize);
+    menu = LoadMusicStreamFromMemory(".mp3", menuData, menuDataSize);
+    SetAudioStreamBufferSizeDefault(0);
     
     bgm.looping = true;
     menu.looping = true;
 
-    delay = 0;
+    delay = 0.0f;
+    ready = true;
 }
 
 void AudioManager::Shutdown() {
+    if (!ready) return;
+    ready = false;
+
     UnloadSound(shootSound);
     UnloadSound(explodeSound);
     UnloadSound(gameOverSound);
     
     UnloadMusicStream(bgm);
     UnloadMusicStream(menu);
+    UnloadFileData(bgmData);
+    UnloadFileData(menuData);
+    bgmData = nullptr;
+    menuData = nullptr;
     
     CloseAudioDevice();
 }
 
-void AudioManager::UpdateMusic(bool isStarted, bool isGameOver, int delayTarget) {
+void AudioManager::UpdateMusic(bool isStarted, bool isGameOver, float menuDelay, float dt) {
+    if (!ready) return;
+
     // While the game is started and not game over, play bgm
     if (isStarted && !isGameOver) {
         if (IsMusicStreamPlaying(menu)) StopMusicStream(menu);
         if (!IsMusicStreamPlaying(bgm)) PlayMusicStream(bgm);
         UpdateMusicStream(bgm);
-        delay = 0;
+        delay = 0.0f;
     // If the game is over, stop bgm and delay menu music
     } else if (isStarted && isGameOver) {
         if (IsMusicStreamPlaying(bgm)) StopMusicStream(bgm);
-        if (delay < delayTarget) {
-            delay++;
+        if (delay < menuDelay) {
+            delay += dt;
             return;
         }
         if (!IsMusicStreamPlaying(menu)) PlayMusicStream(menu);
@@ -60,13 +96,25 @@ void AudioManager::UpdateMusic(bool isStarted, bool isGameOver, int delayTarget)
 }
 
 void AudioManager::PlayShoot() {
-    PlaySound(shootSound);
+    pendingShoot++;
 }
 
 void AudioManager::PlayExplode() {
-    PlaySound(explodeSound);
+    pendingExplode++;
 }
 
 void AudioManager::PlayGameOver() {
-    PlaySound(gameOverSound);
+    pendingGameOver++;
+}
+
+void AudioManager::FlushSounds() {
+    // Overlapping plays of the same Sound restart it, so one play per frame is enough
+    bool shoot = pendingShoot.exchange(0) > 0;
+    bool explode = pendingExplode.exchange(0) > 0;
+    bool gameOver = pendingGameOver.exchange(0) > 0;
+    if (!ready) return;
+
+    if (shoot) PlaySound(shootSound);
+    if (explode) PlaySound(explodeSound);
+    if (gameOver) PlaySound(gameOverSound);
 }
@@ -1,28 +1,56 @@
 #pragma once
 #include "raylib.h"
+#include <atomic>
 
 class AudioManager {
 public:
     AudioManager();
     ~AudioManager();
 
+    // Init() runs the three loading stages below back to back. They can also be
+    // called separately: InitDevice() and Decode() are safe on worker threads,
+    // Upload() needs both to have finished.
     void Init();
+    void InitDevice();
+    void Decode();
+    void Upload();
     void Shutdown();
     
-    // Updates music streaming and switching logic based on game state
-    void UpdateMusic(bool isStarted, bool isGameOver, int delayTarget);
+    // Updates music streaming and switching logic based on game state. The
+    // menu music starts `menuDelay` seconds after a game over; `dt` is the
+    // time since the last call.
+    void UpdateMusic(bool isStarted, bool isGameOver, float menuDelay, float dt);
 
+    // Safe to call from the simulation thread: sounds are queued and played
+    // by the next FlushSounds() on the main thread
     void PlayShoot();
     void PlayExplode();
     void PlayGameOver();
+    void FlushSounds();
 
 private:
-    Sound shootSound;
-    Sound explodeSound;
-    Sound gameOverSound;
+    Sound shootSound = {};
+    Sound explodeSound = {};
+    Sound gameOverSound = {};
     
-    Music bgm;
-    Music menu;
+    Music bgm = {};
+    Music menu = {};
 
-    int delay = 0;
+    // False until Upload() has run (and in headless mode, where there is no device)
+    bool ready = false;
+
+    // Decoded on a worker, turned into Sounds/Music streams by Upload()
+    Wave shootWave = {};
+    Wave explodeWave = {};
+    Wave gameOverWave = {};
+    unsigned char* bgmData = nullptr;
+    unsigned char* menuData = nullptr;
+    int bgmDataSize = 0;
+    int menuDataSize = 0;
+
+    float delay = 0.0f;    // Seconds since the game over, until the menu music starts
+
+    std::atomic<int> pendingShoot{0};
+    std::atomic<int> pendingExplode{0};
+    std::atomic<int> pendingGameOver{0};
 };
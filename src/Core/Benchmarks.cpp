@@ -0,0 +1,239 @@
+#include "Benchmarks.h"
+#include "JobSystem.h"
+#include "Constants.h"
+#include "Level.h"
+#include "MissileFactory.h"
+#include "GameRandom.h"
+#include "Projectile.h"
+#include "ParticleSystem.h"
+#include "CavernGrade.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int MissileCount = 4096;
+    constexpr int ProjectileCount = 4096;
+    constexpr int Ticks = 120;
+
+    struct JobRun {
+        double ms;
+        double checksum;
+    };
+
+    // Same phases as EntityManager::Update, at a scale where the split matters
+    JobRun RunEntityTicks(const Level& level) {
+        GameRandom::Seed(1);
+        std::vector<std::unique_ptr<Missile>> missiles;
+        for (int i = 0; i < MissileCount; i++) {
+            Vector2 pos = { (float)(i % Constants::ScreenWidth), (float)GameRandom::Range(100, 500) };
+            missiles.push_back(MissileFactory::CreateRandomMissile(pos));
+        }
+        std::vector<Projectile> projectiles;
+        for (int i = 0; i < ProjectileCount; i++) {
+            Vector2 pos = { (float)(i % Constants::ScreenWidth), (float)GameRandom::Range(100, 500) };
+            projectiles.emplace_back(pos, Vector2{Constants::Physics::ProjectileSpeed, 0.0f}, (i & 1) == 0);
+        }
+
+        std::vector<char> missileHits(missiles.size());
+        std::vector<char> projectileHits(projectiles.size());
+        const SimVec2 playerPos = SimVec2::From(Constants::Helicopter::StartPos);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < Ticks; tick++) {
+            Jobs::ParallelFor((int)missiles.size(), Constants::Jobs::EntityGrain, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    missiles[i]->Update(playerPos);
+                    missileHits[i] = level.CheckCollision(missiles[i]->GetHitbox());
+                }
+            });
+            Jobs::ParallelFor((int)projectiles.size(), Constants::Jobs::EntityGrain, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    Projectile& p = projectiles[i];
+                    p.Update();
+                    Vector2 from = p.GetPreviousPosition();
+                    from.x -= Constants::ScrollSpeed;
+                    projectileHits[i] = level.CheckProjectileCollision(from, p.GetPosition(), p.GetRadius());
+                }
+            });
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Summed in index order, so any scheduling difference in the results shows up here
+        double checksum = 0.0;
+        for (size_t i = 0; i < missiles.size(); i++) {
+            Rectangle r = missiles[i]->GetRect();
+            checksum += r.x * 3.0 + r.y * 7.0 + missileHits[i];
+        }
+        for (size_t i = 0; i < projectiles.size(); i++) {
+            Vector2 p = projectiles[i].GetPosition();
+            checksum += p.x * 5.0 + p.y * 11.0 + projectileHits[i];
+        }
+        return { ms, checksum };
+    }
+
+    // Opaque noise, so every channel value and vignette distance is exercised
+    std::vector<uint32_t> NoiseImage(int width, int height) {
+        std::vector<uint32_t> pixels((size_t)width * height);
+        uint32_t state = 0x2545F491u;
+        for (uint32_t& p : pixels) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            p = state | 0xff000000u;
+        }
+        return pixels;
+    }
+
+    // Largest per-channel difference from CavernGrade::Reference()
+    int GradeError(const std::vector<uint32_t>& source, const std::vector<uint32_t>& graded, int width, int height) {
+        int worst = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                size_t i = (size_t)y * width + x;
+                uint32_t expected = CavernGrade::Reference(source[i], x, y, width, height);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    int diff = std::abs((int)((graded[i] >> shift) & 0xff) - (int)((expected >> shift) & 0xff));
+                    worst = std::max(worst, diff);
+                }
+            }
+        }
+        return worst;
+    }
+
+    // Mean ms per frame over `frames`, after one warm-up frame
+    template <typename Fn>
+    double TimeFrames(int frames, Fn&& fn) {
+        fn();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+}
+
+namespace Benchmarks {
+    int RunJobs() {
+        const int previousWorkers = Jobs::GetWorkerCount();
+        const int maxThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+        // A level that has scrolled far enough to contain walls and spikes
+        GameRandom::Seed(1);
+        Level level;
+        level.Init();
+        for (int i = 0; i < 2000; i++) level.Update();
+
+        TraceLog(LOG_INFO, "BENCH: %d missiles + %d projectiles, %d ticks", MissileCount, ProjectileCount, Ticks);
+        TraceLog(LOG_INFO, "BENCH: threads   ms/tick   speedup   result");
+
+        double baseline = 0.0;
+        double baselineChecksum = 0.0;
+        bool deterministic = true;
+        for (int threads = 1; threads <= maxThreads; threads++) {
+            Jobs::Start(threads - 1);
+            RunEntityTicks(level); // Warm up caches and worker threads
+            JobRun run = RunEntityTicks(level);
+
+            if (threads == 1) {
+                baseline = run.ms;
+                baselineChecksum = run.checksum;
+            }
+            bool match = run.checksum == baselineChecksum;
+            deterministic = deterministic && match;
+            TraceLog(LOG_INFO, "BENCH: %7d %9.3f %8.2fx   %s", threads, run.ms / Ticks, baseline / run.ms,
+                     match ? "match" : "MISMATCH");
+        }
+
+        Jobs::Start(previousWorkers);
+        if (!deterministic) TraceLog(LOG_ERROR, "BENCH: Results depend on the thread count");
+        return deterministic ? 0 : 1;
+    }
+
+    int RunParticles() {
+        using ParticleConst = Constants::Particles;
+        constexpr int Frames = 600;
+        ParticleSystem particles;
+        std::vector<double> frameMs;
+        frameMs.reserve(Frames);
+
+        // Bursts over the whole screen, topped up before every frame so the
+        // update always sees the full count
+        GameRandom::Seed(1);
+        auto refill = [&] {
+            while (particles.GetCount() < ParticleConst::BenchCount) {
+                Vector2 pos = { (float)GameRandom::Range(100, Constants::ScreenWidth - 100),
+                                (float)GameRandom::Range(100, Constants::ScreenHeight - 100) };
+                particles.Emit({pos, (ParticleBurst::Kind)GameRandom::Range(0, 3)});
+            }
+        };
+
+        long updated = 0;
+        for (int frame = 0; frame < Frames + 60; frame++) {
+            refill();
+            updated += particles.GetCount();
+            auto start = std::chrono::steady_clock::now();
+            particles.Update(Constants::TickTime, Constants::ScrollSpeed);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (frame >= 60) frameMs.push_back(ms); // The first frames warm the caches
+        }
+
+        std::sort(frameMs.begin(), frameMs.end());
+        double mean = 0.0;
+        for (double ms : frameMs) mean += ms;
+        mean /= frameMs.size();
+        double p99 = frameMs[frameMs.size() * 99 / 100];
+
+        TraceLog(LOG_INFO, "BENCH: %s kernel, %.0f particles per frame, %d frames",
+                 ParticleSystem::GetKernelName(), (double)updated / (Frames + 60), Frames);
+        TraceLog(LOG_INFO, "BENCH: update mean %.3f ms, p99 %.3f ms, %.1f ns/particle (budget %.1f ms)",
+                 mean, p99, mean * 1e6 / ParticleConst::BenchCount, ParticleConst::BudgetMs);
+
+        bool withinBudget = p99 <= ParticleConst::BudgetMs;
+        if (!withinBudget) TraceLog(LOG_ERROR, "BENCH: Particle update over budget");
+        return withinBudget ? 0 : 1;
+    }
+
+    int RunPost() {
+        struct Size { int width, height, frames; };
+        const Size sizes[] = { { Constants::ScreenWidth, Constants::ScreenHeight, 200 }, { 3840, 2160, 20 } };
+        std::vector<CavernGrade::Kernel> kernels = { CavernGrade::Kernel::Scalar };
+        if (CavernGrade::BestKernel() != CavernGrade::Kernel::Scalar) kernels.push_back(CavernGrade::BestKernel());
+
+        TraceLog(LOG_INFO, "BENCH: cavern grade, %d pool workers", Jobs::GetWorkerCount());
+        TraceLog(LOG_INFO, "BENCH: size        kernel   1 thread ms   pool ms   speedup   max error");
+
+        bool accurate = true;
+        for (const Size& size : sizes) {
+            const std::vector<uint32_t> source = NoiseImage(size.width, size.height);
+            std::vector<uint32_t> first;
+            for (CavernGrade::Kernel kernel : kernels) {
+                CavernGrade grade(size.width, size.height);
+                grade.SetKernel(kernel);
+
+                std::vector<uint32_t> pixels = source;
+                grade.ApplyRows(pixels.data(), 0, size.height);
+                int error = GradeError(source, pixels, size.width, size.height);
+                accurate = accurate && error <= 1;
+                // The kernels share their arithmetic, so headless frames match on any CPU
+                if (first.empty()) first = pixels;
+                else if (pixels != first) {
+                    TraceLog(LOG_ERROR, "BENCH: %s kernel differs from %s", CavernGrade::GetKernelName(kernel),
+                             CavernGrade::GetKernelName(kernels[0]));
+                    accurate = false;
+                }
+
+                // Graded again in place; the timing doesn't depend on the contents
+                double single = TimeFrames(size.frames, [&] { grade.ApplyRows(pixels.data(), 0, size.height); });
+                double pooled = TimeFrames(size.frames, [&] { grade.Apply(pixels.data()); });
+                TraceLog(LOG_INFO, "BENCH: %4dx%-6d %-8s %11.3f %9.3f %8.2fx %11d", size.width, size.height,
+                         CavernGrade::GetKernelName(kernel), single, pooled, single / pooled, error);
+            }
+        }
+
+        if (!accurate) TraceLog(LOG_ERROR, "BENCH: CPU cavern grade doesn't match the shader");
+        return accurate ? 0 : 1;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Command line benchmark modes. Each returns the process exit code.
+namespace Benchmarks {
+    // --bench-jobs: per-tick entity work on 1..N threads, reporting speedup
+    // and failing if any thread count changes the result
+    int RunJobs();
+    // --bench-particles: particle update time with the pool held at
+    // Constants::Particles::BenchCount, failing if it exceeds the budget
+    int RunParticles();
+    // --bench-post: CPU cavern grade at 1000x600 and 4K, failing if a kernel
+    // is more than one step off the shader's formula in any channel
+    int RunPost();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "raylib.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Appending writer and bounds-checked reader for the game's binary formats
+// (spectator packets, rewind states). Values are copied as-is: every
+// platform the game ships on is little-endian. A reader that runs past the
+// end returns zeros from then on and reports !Ok().
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    template<typename T>
+    void Put(T value) {
+        size_t at = out.size();
+        out.resize(at + sizeof(T));
+        memcpy(out.data() + at, &value, sizeof(T));
+    }
+    void PutU8(int value) { Put((uint8_t)value); }
+    void PutU16(size_t value) { Put((uint16_t)std::min<size_t>(value, 0xFFFF)); }
+    void PutRect(Rectangle r) { Put(r.x); Put(r.y); Put(r.width); Put(r.height); }
+    void PutVector(Vector2 v) { Put(v.x); Put(v.y); }
+    void PutBytes(const void* bytes, size_t count) {
+        size_t at = out.size();
+        out.resize(at + count);
+        memcpy(out.data() + at, bytes, count);
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template<typename T>
+    T Get() {
+        T value = {};
+        if (at + sizeof(T) > size) {
+            ok = false;
+            return value;
+        }
+        memcpy(&value, data + at, sizeof(T));
+        at += sizeof(T);
+        return value;
+    }
+    int GetU8() { return Get<uint8_t>(); }
+    int GetU16() { return Get<uint16_t>(); }
+    float GetF32() { return Get<float>(); }
+    Rectangle GetRect() { Rectangle r; r.x = GetF32(); r.y = GetF32(); r.width = GetF32(); r.height = GetF32(); return r; }
+    Vector2 GetVector() { Vector2 v; v.x = GetF32(); v.y = GetF32(); return v; }
+    const uint8_t* GetBytes(size_t count) {
+        if (at + count > size) {
+            ok = false;
+            return nullptr;
+        }
+        at += count;
+        return data + at - count;
+    }
+    bool Ok() const { return ok; }
+    size_t Remaining() const { return size - at; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t at = 0;
+    bool ok = true;
+};
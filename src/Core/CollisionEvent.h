@@ -0,0 +1,20 @@
+#pragma once
+#include "raylib.h"
+
+// One collision found while updating the entities. Detection only records
+// these; EntityManager resolves the tick's list afterwards, in order, into
+// deactivations, broken walls, explosions, particle bursts and sounds.
+struct CollisionEvent {
+    enum class Kind : unsigned char {
+        ProjectileTerrain,  // Projectile hit terrain, a spike, a wall or the floor
+        MissileTerrain,     // Missile flew into the terrain
+        MissileProjectile,  // Missile shot down
+        RockProjectile      // Rock shot
+    };
+
+    Kind kind;
+    int entity;         // Index of the missile or rock this tick, or -1
+    int projectile;     // Index of the projectile this tick, or -1
+    int wall;           // Wall whose weak spot was hit, or -1
+    Vector2 position;   // Where the explosion goes
+};
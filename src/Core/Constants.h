@@ -6,6 +6,7 @@ namespace Constants {
     constexpr int ScreenHeight = 600;
     constexpr int ControlPanelHeight = 50;
     constexpr int TargetFPS = 60;
+    constexpr float TickTime = 1.0f / TargetFPS; // Fixed simulation step
     constexpr float ScrollSpeed = 3.0f;
     constexpr int TerrainStep = 10;
     constexpr int GapHeight = 160;
@@ -30,9 +31,114 @@ namespace Constants {
         static constexpr float RockSpeed = 2.0f;
     };
     
+    struct Render {
+        static constexpr float MinScale = 0.5f;
+        static constexpr float MaxScale = 1.0f;
+        static constexpr float ScaleStep = 0.05f;
+        // rlgl's default batch: vertex buffer size and draw calls before it flushes
+        static constexpr int BatchVertices = 8192 * 4;
+        static constexpr int BatchDrawCalls = 256;
+        // CPU cavern grade: vignette table entries over the squared distance
+        // from the center, and rows per job
+        static constexpr int VignetteLutSize = 4096;
+        static constexpr int PostRowGrain = 16;
+    };
+
+    struct Jobs {
+        // Below these counts the work runs inline; handing it out costs more
+        static constexpr int EntityGrain = 32;
+        static constexpr int CellGrain = 8;
+    };
+
     struct Level {
         static constexpr int MinGapHeight = 100;
         static constexpr int TargetWidth = 30;
         static constexpr int WeakSpotHeight = 30;
+        // Columns of the terrain occupancy ring; must cover the screen plus
+        // the generation lookahead and whatever has scrolled off to the left
+        static constexpr int OccupancyWidth = 2048;
+        // TerrainHistory: columns per independently decodable chunk, and
+        // log2 of the columns summarized by one entry of the pyramid's base
+        static constexpr int HistoryChunkColumns = 256;
+        static constexpr int HistoryBlockShift = 5;
+    };
+
+    // Strip showing the whole run on the game over screen
+    struct Minimap {
+        static constexpr int X = 50;
+        static constexpr int Y = 430;
+        static constexpr int Width = 900;
+        static constexpr int Height = 60;
+    };
+
+    // Idle power mode: before the first input and behind the game over
+    // screens the loop slows down and only draws frames that changed
+    struct Idle {
+        static constexpr int FramesPerSecond = 20;
+        // How long the screen has to stay unchanged before the loop slows down
+        static constexpr float Linger = 0.5f;
+        // Frames per music stream buffer, so one outlasts a slow frame
+        static constexpr int MusicBufferFrames = 8192;
+    };
+
+    struct World {
+        // Entities entirely outside the screen grown by this margin are removed
+        static constexpr float CullMargin = 100.0f;
+        // Hard caps per entity kind; spawns past them are dropped
+        static constexpr int MaxMissiles = 128;
+        static constexpr int MaxProjectiles = 32;
+        static constexpr int MaxRocks = 64;
+        static constexpr int MaxExplosions = 64;
+        static constexpr int MaxBursts = 32; // Per tick
+    };
+
+    struct Soak {
+        static constexpr long DefaultTicks = 2000000;
+        static constexpr int SampleInterval = 1000;   // Ticks between heap samples
+        // A metric grows without bound if its peak over the last quarter of the
+        // run exceeds the first half's by this factor plus an allowance
+        static constexpr double GrowthFactor = 1.25;
+        // ...or if an entity kind sits at its cap for more of the ticks than this
+        static constexpr double MaxPercentAtCap = 1.0;
+    };
+
+    struct Particles {
+        // Pool size; bursts past it are cut short
+        static constexpr int Capacity = 65536;
+        // --bench-particles: live particles and the update budget they must fit
+        static constexpr int BenchCount = 50000;
+        static constexpr double BudgetMs = 1.0;
+    };
+
+    struct Replay {
+        static constexpr int HashInterval = 60;     // Ticks between state hashes in an input log
+    };
+
+    // --analyze: results are kept per stretch of distance
+    struct Analysis {
+        static constexpr int BucketDistance = 500;  // Pixels of distance per row
+        static constexpr int MaxBuckets = 400;      // Later distances share the last row
+    };
+
+    struct Rewind {
+        static constexpr int Interval = 2;           // Ticks between recorded states
+        static constexpr int HistorySeconds = 10;
+        static constexpr int MaxEntries = HistorySeconds * TargetFPS / Interval;
+        // Delta storage; past this the oldest states go first
+        static constexpr int RingBytes = 1 << 20;
+    };
+
+    struct Capture {
+        // Frames that can wait for the disk before new ones are dropped
+        static constexpr int RingFrames = 3;
+    };
+
+    struct Spectator {
+        static constexpr int DefaultPort = 47611;
+        // Shared packet ring; a viewer further behind than half of it skips
+        // ahead to the newest keyframe
+        static constexpr int RingBytes = 1 << 20;
+        static constexpr int KeyframeInterval = 300; // Ticks
+        static constexpr int KeyframeHistory = 8;
     };
 }
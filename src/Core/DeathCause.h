@@ -0,0 +1,21 @@
+#pragma once
+
+// What ended a run, as the simulation saw it at the colliding tick
+enum class DeathCause : unsigned char {
+    None,
+    Terrain,            // Ceiling, floor or the bottom of the screen
+    Spike,              // Stalactite or stalagmite
+    Wall,
+    StandardMissile,
+    OscillatorMissile,
+    LooperMissile,
+    SeekerMissile,
+    Rock,
+    Count
+};
+
+inline const char* DeathCauseName(DeathCause cause) {
+    static const char* const Names[] = { "none", "terrain", "spike", "wall", "standard missile",
+                                         "oscillator missile", "looper missile", "seeker missile", "rock" };
+    return (int)cause < (int)DeathCause::Count ? Names[(int)cause] : "?";
+}
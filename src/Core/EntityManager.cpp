@@ -1,11 +1,35 @@
 #include "EntityManager.h"
 #include "Constants.h"
-#include "MissileFactory.h"
+#include "JobSystem.h"
+#include "DrawList.h"
 #include <algorithm>
 
 using PhysConst = Constants::Physics;
+using JobConst = Constants::Jobs;
+using WorldConst = Constants::World;
 
-EntityManager::EntityManager() {}
+EntityManager::EntityManager(std::pmr::memory_resource* resource)
+    : missiles(resource), projectiles(resource), rocks(resource), explosions(resource), bursts(resource) {}
+
+EntityManager::EntityManager(const EntityManager& other) {
+    *this = other;
+}
+
+EntityManager& EntityManager::operator=(const EntityManager& other) {
+    if (this == &other) return *this;
+
+    missiles.clear();
+    missiles.reserve(other.missiles.size());
+    for (const auto& m : other.missiles) missiles.push_back(m->Clone());
+
+    projectiles = other.projectiles;
+    rocks = other.rocks;
+    explosions = other.explosions;
+    bursts = other.bursts;
+    nextId = other.nextId;
+    dropped = other.dropped;
+    return *this;
+}
 
 void EntityManager::Init() {
     Reset();
@@ -16,132 +40,225 @@ void EntityManager::Reset() {
     projectiles.clear();
     rocks.clear();
     explosions.clear();
-    missileSpawnTimer = 0.0f;
-    rockSpawnTimer = 0.0f;
+    bursts.clear();
+    nextId = 0;
+    dropped = 0;
 }
 
-void EntityManager::SpawnProjectile(Vector2 pos, bool isFacingRight) {
+bool EntityManager::SpawnProjectile(Vector2 pos, bool isFacingRight) {
+    if ((int)projectiles.size() >= WorldConst::MaxProjectiles) {
+        dropped++;
+        return false;
+    }
     projectiles.emplace_back(pos, Vector2{PhysConst::ProjectileSpeed, 0.0f}, isFacingRight);
+    projectiles.back().SetId(nextId++);
+    return true;
 }
 
 void EntityManager::Update(float dt, Level& level, const Helicopter& helicopter, AudioManager& audioManager) {
-    SpawnEnemies(dt, level);
-    
-    UpdateProjectiles(level, audioManager);
-    UpdateMissiles(helicopter.GetPosition(), level, audioManager);
-    UpdateRocks(audioManager);
-    UpdateExplosions();
+    collisions.clear();
+    projectileClaimed.assign(projectiles.size(), 0);
+
+    UpdateProjectiles(level);
+    UpdateMissiles(helicopter.GetSimPosition(), level);
+    UpdateRocks();
+    ResolveCollisions(level, audioManager);
+    UpdateExplosions(dt);
     
     Cleanup();
 }
 
-void EntityManager::SpawnEnemies(float dt, const Level& level) {
-    if (level.GetDistance() < 1500.0f) return; // Warmup
+bool EntityManager::SpawnMissile(std::unique_ptr<Missile> missile) {
+    if ((int)missiles.size() >= WorldConst::MaxMissiles) {
+        dropped++;
+        return false;
+    }
+    missile->SetId(nextId++);
+    missiles.push_back(std::move(missile));
+    return true;
+}
 
-    // Missiles
-    missileSpawnTimer += dt;
-    if (missileSpawnTimer > 3.0f) {
-        missileSpawnTimer = 0.0f;
-        float targetY = level.GetCurrentGapCenter();
-        Vector2 spawnPos = {(float)Constants::ScreenWidth + 50.0f, targetY};
-        missiles.push_back(MissileFactory::CreateRandomMissile(spawnPos));
+bool EntityManager::SpawnRock(Vector2 pos, float radius) {
+    if ((int)rocks.size() >= WorldConst::MaxRocks) {
+        dropped++;
+        return false;
     }
+    rocks.push_back(Rock(pos, radius));
+    rocks.back().SetId(nextId++);
+    return true;
+}
 
-    // Rocks
-    if (level.GetDistance() > 2500.0f) {
-        rockSpawnTimer += dt;
-        if (rockSpawnTimer > 5.0f) {
-            rockSpawnTimer = 0.0f;
-            float targetY = level.GetCurrentGapCenter();
-            Vector2 spawnPos = {0, targetY};
-            rocks.push_back(Rock(spawnPos, 15.0f));
-        }
+void EntityManager::AddExplosion(Vector2 pos, ParticleBurst::Kind kind) {
+    // Only the effects are capped; the hit itself has already been applied
+    if ((int)explosions.size() < WorldConst::MaxExplosions) {
+        explosions.emplace_back(pos);
+        explosions.back().SetId(nextId++);
+    } else {
+        dropped++;
     }
+    if ((int)bursts.size() < WorldConst::MaxBursts) bursts.push_back({pos, kind});
 }
 
-void EntityManager::UpdateProjectiles(Level& level, AudioManager& audioManager) {
-    for (auto& p : projectiles) {
-        if (!p.IsActive()) continue;
-        p.Update();
+EntityManager::Counts EntityManager::GetCounts() const {
+    return { (int)missiles.size(), (int)projectiles.size(), (int)rocks.size(), (int)explosions.size() };
+}
 
-        if (level.CheckProjectileCollision(p.GetRect())) {
-            p.Deactivate();
-            explosions.emplace_back(p.GetPosition());
-            audioManager.PlayExplode();
+namespace {
+    // The terrain scrolled this tick too, so projectiles sweep in its frame of reference
+    bool SweepProjectile(const Level& level, const Projectile& p, Level::ProjectileHit* hit,
+                         const std::vector<char>* brokenWalls = nullptr) {
+        Vector2 from = p.GetPreviousPosition();
+        from.x -= Constants::ScrollSpeed;
+        return level.CheckProjectileCollision(from, p.GetPosition(), p.GetRadius(), hit, brokenWalls);
+    }
+}
+
+void EntityManager::UpdateProjectiles(const Level& level) {
+    // Move and sweep in parallel; the level is only read here
+    projectileResults.resize(projectiles.size());
+    Jobs::ParallelFor((int)projectiles.size(), JobConst::EntityGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Projectile& p = projectiles[i];
+            projectileResults[i].hit = false;
+            if (!p.IsActive()) continue;
+            p.Update();
+            projectileResults[i].hit = SweepProjectile(level, p, &projectileResults[i].info);
         }
+    });
+
+    // Record hits in spawn order so the outcome does not depend on scheduling
+    wallsBroken.clear();
+    for (size_t i = 0; i < projectiles.size(); i++) {
+        ProjectileResult& result = projectileResults[i];
+        if (!result.hit) continue;
+
+        // An earlier shot already broke this wall; the sweep has to see the gap
+        if (result.info.wall >= 0 && !wallsBroken.empty() && wallsBroken[result.info.wall]) {
+            result.hit = SweepProjectile(level, projectiles[i], &result.info, &wallsBroken);
+            if (!result.hit) continue;
+        }
+
+        int wall = -1;
+        if (result.info.weakSpot) {
+            wall = result.info.wall;
+            wallsBroken.resize(level.GetWallCount(), 0);
+            wallsBroken[wall] = 1;
+        }
+        projectileClaimed[i] = 1;
+        collisions.push_back({CollisionEvent::Kind::ProjectileTerrain, -1, (int)i, wall, result.info.point});
     }
 }
 
-void EntityManager::UpdateMissiles(const Vector2& playerPos, Level& level, AudioManager& audioManager) {
-    for (auto& m : missiles) {
-        if (!m->IsActive()) continue;
+void EntityManager::UpdateMissiles(const SimVec2& playerPos, const Level& level) {
+    missileTerrainHits.resize(missiles.size());
+    Jobs::ParallelFor((int)missiles.size(), JobConst::EntityGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Missile& m = *missiles[i];
+            missileTerrainHits[i] = false;
+            if (!m.IsActive()) continue;
+            m.Update(playerPos);
+            missileTerrainHits[i] = level.CheckCollision(m.GetHitbox());
+        }
+    });
 
-        m->Update(playerPos);
+    for (size_t i = 0; i < missiles.size(); i++) {
+        const Missile& m = *missiles[i];
+        if (!m.IsActive()) continue;
+        Rectangle rect = m.GetRect();
+        CompositeHitbox hitbox = m.GetHitbox();
 
         // Wall/Obstacle Collision
-        if (level.CheckCollision(m->GetRect())) {
-            m->Deactivate();
-            explosions.emplace_back(Vector2{m->GetRect().x + 15, m->GetRect().y + 5});
-            audioManager.PlayExplode();
+        if (missileTerrainHits[i]) {
+            collisions.push_back({CollisionEvent::Kind::MissileTerrain, (int)i, -1, -1, Vector2{rect.x + 15, rect.y + 5}});
         }
         
         // Projectile Collision
-        for (auto& p : projectiles) {
-            if (!p.IsActive()) continue;
-            if (CheckCollisionRecs(m->GetRect(), p.GetRect())) {
-                m->Deactivate();
-                p.Deactivate();
-                Vector2 mid = { (m->GetRect().x + p.GetPosition().x)/2, (m->GetRect().y + p.GetPosition().y)/2 };
-                explosions.emplace_back(mid);
-                audioManager.PlayExplode();
+        for (size_t j = 0; j < projectiles.size(); j++) {
+            const Projectile& p = projectiles[j];
+            if (!p.IsActive() || projectileClaimed[j]) continue;
+            if (hitbox.Overlaps(p.GetRect())) {
+                projectileClaimed[j] = 1;
+                Vector2 mid = { (rect.x + p.GetPosition().x)/2, (rect.y + p.GetPosition().y)/2 };
+                collisions.push_back({CollisionEvent::Kind::MissileProjectile, (int)i, (int)j, -1, mid});
                 break;
             }
         }
     }
 }
 
-void EntityManager::UpdateRocks(AudioManager& audioManager) {
-    for (auto& r : rocks) {
+void EntityManager::UpdateRocks() {
+    Jobs::ParallelFor((int)rocks.size(), JobConst::EntityGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (rocks[i].IsActive()) rocks[i].Update();
+        }
+    });
+
+    for (size_t i = 0; i < rocks.size(); i++) {
+        const Rock& r = rocks[i];
         if (!r.IsActive()) continue;
-        r.Update();
+        Rectangle rect = r.GetRect();
 
         // Projectile Collision
-        for (auto& p : projectiles) {
-            if (!p.IsActive()) continue;
-            if (CheckCollisionRecs(r.GetRect(), p.GetRect())) {
-                r.Deactivate();
-                p.Deactivate();
-                Vector2 mid = { (r.GetRect().x + p.GetPosition().x)/2, (r.GetRect().y + p.GetPosition().y)/2 };
-                explosions.emplace_back(mid);
-                audioManager.PlayExplode();
+        for (size_t j = 0; j < projectiles.size(); j++) {
+            const Projectile& p = projectiles[j];
+            if (!p.IsActive() || projectileClaimed[j]) continue;
+            if (CheckCollisionRecs(rect, p.GetRect())) {
+                projectileClaimed[j] = 1;
+                Vector2 mid = { (rect.x + p.GetPosition().x)/2, (rect.y + p.GetPosition().y)/2 };
+                collisions.push_back({CollisionEvent::Kind::RockProjectile, (int)i, (int)j, -1, mid});
                 break;
             }
         }
     }
 }
 
-void EntityManager::UpdateExplosions() {
-    for (auto it = explosions.begin(); it != explosions.end(); ) {
-        it->Update();
-        if (!it->IsActive()) {
-             it = explosions.erase(it);
-        } else {
-             ++it;
+void EntityManager::ResolveCollisions(Level& level, AudioManager& audioManager) {
+    for (const CollisionEvent& e : collisions) {
+        if (e.projectile >= 0) projectiles[e.projectile].Deactivate();
+
+        ParticleBurst::Kind burst = ParticleBurst::Kind::MissileKill;
+        switch (e.kind) {
+            case CollisionEvent::Kind::ProjectileTerrain:
+                if (e.wall >= 0) level.DestroyWall(e.wall);
+                burst = e.wall >= 0 ? ParticleBurst::Kind::WallBreak : ParticleBurst::Kind::Impact;
+                break;
+            case CollisionEvent::Kind::MissileTerrain:
+            case CollisionEvent::Kind::MissileProjectile:
+                missiles[e.entity]->Deactivate();
+                break;
+            case CollisionEvent::Kind::RockProjectile:
+                rocks[e.entity].Deactivate();
+                burst = ParticleBurst::Kind::RockHit;
+                break;
         }
+        AddExplosion(e.position, burst);
+        audioManager.PlayExplode();
     }
 }
 
-bool EntityManager::CheckPlayerCollisions(Rectangle playerRect) {
+void EntityManager::UpdateExplosions(float dt) {
+    Jobs::ParallelFor((int)explosions.size(), JobConst::EntityGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) explosions[i].Update(dt);
+    });
+
+    explosions.erase(std::remove_if(explosions.begin(), explosions.end(),
+        [](const Explosion& e) { return !e.IsActive(); }), explosions.end());
+}
+
+bool EntityManager::CheckPlayerCollisions(const CompositeHitbox& player, DeathCause* cause) const {
     // Missiles
     for (const auto& m : missiles) {
-        if (m->IsActive() && CheckCollisionRecs(playerRect, m->GetRect())) {
+        if (m->IsActive() && player.Overlaps(m->GetHitbox())) {
+            // MissileType lists the concrete kinds in the same order, after Random
+            if (cause) *cause = (DeathCause)((int)DeathCause::StandardMissile + (int)m->GetType() - (int)MissileType::Standard);
             return true;
         }
     }
     
     // Rocks
     for (const auto& r : rocks) {
-        if (r.IsActive() && CheckCollisionRecs(playerRect, r.GetRect())) {
+        if (r.IsActive() && player.Overlaps(r.GetRect())) {
+            if (cause) *cause = DeathCause::Rock;
             return true;
         }
     }
@@ -149,20 +266,31 @@ bool EntityManager::CheckPlayerCollisions(Rectangle playerRect) {
     return false;
 }
 
+namespace {
+    // One bounds test for every entity kind, whichever way it is moving
+    bool InsideWorld(Rectangle rect) {
+        constexpr float Margin = WorldConst::CullMargin;
+        return rect.x + rect.width > -Margin && rect.x < Constants::ScreenWidth + Margin &&
+               rect.y + rect.height > -Margin && rect.y < Constants::ScreenHeight + Margin;
+    }
+}
+
 void EntityManager::Cleanup() {
     projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(), 
-        [](const auto& p) { return !p.IsActive(); }), projectiles.end());
+        [](const auto& p) { return !p.IsActive() || !InsideWorld(p.GetRect()); }), projectiles.end());
 
     missiles.erase(std::remove_if(missiles.begin(), missiles.end(), 
-        [](const auto& m) { return !m->IsActive(); }), missiles.end());
+        [](const auto& m) { return !m->IsActive() || !InsideWorld(m->GetRect()); }), missiles.end());
 
     rocks.erase(std::remove_if(rocks.begin(), rocks.end(), 
-        [](const auto& r) { return !r.IsActive(); }), rocks.end());
+        [](const auto& r) { return !r.IsActive() || !InsideWorld(r.GetRect()); }), rocks.end());
 }
 
-void EntityManager::Draw() {
-    for (auto& missile : missiles) missile->Draw();
-    for (const auto& p : projectiles) p.Draw();
-    for (const auto& e : explosions) e.Draw();
-    for (const auto& r : rocks) r.Draw();
+void EntityManager::Draw(DrawList& list, unsigned long tick) const {
+    // Missiles spawn off screen to the right; the list culls them until they arrive
+    list.SetLayer(DrawLayer::Entities);
+    for (auto& missile : missiles) missile->Draw(list, tick);
+    for (const auto& p : projectiles) p.Draw(list);
+    for (const auto& e : explosions) e.Draw(list);
+    for (const auto& r : rocks) r.Draw(list);
 }
@@ -2,6 +2,7 @@
 #include "raylib.h"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include "Missile.h"
 #include "Projectile.h"
 #include "Rock.h"
@@ -9,34 +10,83 @@
 #include "Level.h"
 #include "Helicopter.h"
 #include "AudioManager.h"
+#include "ParticleBurst.h"
+#include "CollisionEvent.h"
+#include "DeathCause.h"
 
 class EntityManager {
+    friend class SpectatorEncoder;
+    friend class SpectatorDecoder;
+    friend class StateSerializer;
+
 public:
-    EntityManager();
+    // Entity lists allocate from `resource`; copies use the default heap
+    explicit EntityManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Copies clone every missile; used to publish simulation snapshots
+    EntityManager(const EntityManager& other);
+    EntityManager& operator=(const EntityManager& other);
     
     void Init();
     void Reset();
     void Update(float dt, Level& level, const Helicopter& helicopter, AudioManager& audioManager);
-    void Draw();
+    // `tick` animates the missile flames, so a snapshot always draws the same way
+    void Draw(DrawList& list, unsigned long tick) const;
     
-    void SpawnProjectile(Vector2 pos, bool isFacingRight);
+    // Spawns past the per-kind caps in Constants::World are dropped; the
+    // return value says whether the entity was added
+    bool SpawnProjectile(Vector2 pos, bool isFacingRight);
+    bool SpawnMissile(std::unique_ptr<Missile> missile);
+    bool SpawnRock(Vector2 pos, float radius);
     
-    // Returns true if player Collides with an entity
-    bool CheckPlayerCollisions(Rectangle playerRect);
+    // Returns true if player Collides with an entity, and which kind in `cause`
+    bool CheckPlayerCollisions(const CompositeHitbox& player, DeathCause* cause = nullptr) const;
+
+    // Hits of the last Update(), for the renderer's particle effects
+    const std::pmr::vector<ParticleBurst>& GetBursts() const { return bursts; }
+    void ClearBursts() { bursts.clear(); }
+
+    struct Counts {
+        int missiles;
+        int projectiles;
+        int rocks;
+        int explosions;
+    };
+    Counts GetCounts() const;
+    // Spawns and effects turned away by the caps since Init()
+    unsigned long GetDroppedCount() const { return dropped; }
 
 private:
-    std::vector<std::unique_ptr<Missile>> missiles;
-    std::vector<Projectile> projectiles;
-    std::vector<Rock> rocks;
-    std::vector<Explosion> explosions;
+    std::pmr::vector<std::unique_ptr<Missile>> missiles;
+    std::pmr::vector<Projectile> projectiles;
+    std::pmr::vector<Rock> rocks;
+    std::pmr::vector<Explosion> explosions;
+    std::pmr::vector<ParticleBurst> bursts;
+    unsigned int nextId = 0; // Shared by every entity kind
+    unsigned long dropped = 0;
+
+    // Per-entity results of the parallel update phases
+    struct ProjectileResult {
+        bool hit;
+        Level::ProjectileHit info;
+    };
+    std::vector<ProjectileResult> projectileResults;
+    std::vector<char> missileTerrainHits;
 
-    float missileSpawnTimer = 0.0f;
-    float rockSpawnTimer = 0.0f;
+    // This tick's collisions. Detection reads the world as it was when the
+    // tick started and only writes here; projectiles and weak spots already
+    // claimed by an earlier event are skipped instead of being deactivated.
+    std::vector<CollisionEvent> collisions;
+    std::vector<char> projectileClaimed;
+    std::vector<char> wallsBroken;
     
+    void AddExplosion(Vector2 pos, ParticleBurst::Kind kind);
+    // Removes inactive entities and those that left the world bounds
     void Cleanup();
-    void SpawnEnemies(float dt, const Level& level);
-    void UpdateProjectiles(Level& level, AudioManager& audioManager);
-    void UpdateMissiles(const Vector2& playerPos, Level& level, AudioManager& audioManager);
-    void UpdateRocks(AudioManager& audioManager);
-    void UpdateExplosions();
+    // Move one entity kind and record its collisions
+    void UpdateProjectiles(const Level& level);
+    void UpdateMissiles(const SimVec2& playerPos, const Level& level);
+    void UpdateRocks();
+    // Applies `collisions` in the order they were found
+    void ResolveCollisions(Level& level, AudioManager& audioManager);
+    void UpdateExplosions(float dt);
 };
@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Signed 48.16 fixed-point number. Results depend only on integer
+// arithmetic, so they are identical for every compiler, optimization level
+// and CPU. The range (±2^47) covers any session length.
+struct Fixed {
+    static constexpr int FracBits = 16;
+    static constexpr int64_t One = int64_t(1) << FracBits;
+
+    int64_t raw = 0;
+
+    constexpr Fixed() = default;
+    constexpr Fixed(int value) : raw(int64_t(value) * One) {}
+    // Rounds to the nearest step; the conversion is exact IEEE arithmetic, so
+    // it is as deterministic as the rest
+    constexpr explicit Fixed(float value) : raw(int64_t((double)value * One + (value < 0 ? -0.5 : 0.5))) {}
+    constexpr explicit Fixed(double value) : raw(int64_t(value * One + (value < 0 ? -0.5 : 0.5))) {}
+
+    static constexpr Fixed FromRaw(int64_t raw) { Fixed f; f.raw = raw; return f; }
+    constexpr float ToFloat() const { return (float)((double)raw / One); }
+    // Rounds toward negative infinity
+    constexpr int64_t Floor() const { return raw >> FracBits; }
+
+    constexpr Fixed operator-() const { return FromRaw(-raw); }
+    constexpr Fixed operator+(Fixed o) const { return FromRaw(raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const { return FromRaw(raw - o.raw); }
+    constexpr Fixed operator*(Fixed o) const { return FromRaw((raw * o.raw) >> FracBits); }
+    constexpr Fixed operator/(Fixed o) const { return FromRaw((raw * One) / o.raw); }
+    constexpr Fixed operator*(int o) const { return FromRaw(raw * o); }
+    constexpr Fixed operator/(int o) const { return FromRaw(raw / o); }
+
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+    Fixed& operator*=(Fixed o) { return *this = *this * o; }
+    Fixed& operator/=(Fixed o) { return *this = *this / o; }
+
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+    constexpr bool operator!=(Fixed o) const { return raw != o.raw; }
+    constexpr bool operator<(Fixed o) const { return raw < o.raw; }
+    constexpr bool operator>(Fixed o) const { return raw > o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
+};
+
+namespace FixedMath {
+    constexpr int SineTableSize = 1024; // Entries per full turn
+
+    // Built at compile time from a Taylor series, so the table is the same
+    // bit for bit regardless of the platform's libm
+    constexpr std::array<int64_t, SineTableSize + 1> BuildSineTable() {
+        std::array<int64_t, SineTableSize + 1> table = {};
+        constexpr double Pi = 3.14159265358979323846;
+        for (int i = 0; i <= SineTableSize; i++) {
+            // Reduce to [-pi/2, pi/2] where the series converges quickly
+            double x = 2.0 * Pi * i / SineTableSize;
+            if (x > 1.5 * Pi) x -= 2.0 * Pi;
+            else if (x > 0.5 * Pi) x = Pi - x;
+
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 12; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            table[i] = int64_t(sum * Fixed::One + (sum < 0 ? -0.5 : 0.5));
+        }
+        return table;
+    }
+
+    inline constexpr std::array<int64_t, SineTableSize + 1> SineTable = BuildSineTable();
+
+    // Sine of an angle in radians, linearly interpolated between table entries
+    constexpr Fixed Sin(Fixed radians) {
+        // Table steps per radian, in 16.16
+        constexpr Fixed StepsPerRadian = Fixed(SineTableSize / (2.0 * 3.14159265358979323846));
+        Fixed position = radians * StepsPerRadian;
+        int64_t index = position.Floor();
+        int64_t frac = position.raw & (Fixed::One - 1);
+        int64_t i = index & (SineTableSize - 1);
+        int64_t a = SineTable[i];
+        int64_t b = SineTable[i + 1];
+        return Fixed::FromRaw(a + (((b - a) * frac) >> Fixed::FracBits));
+    }
+
+    constexpr Fixed Cos(Fixed radians) {
+        constexpr Fixed QuarterTurn = Fixed(3.14159265358979323846 / 2.0);
+        return Sin(radians + QuarterTurn);
+    }
+}
@@ -0,0 +1,49 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+    constexpr double MinSpin = 0.3e-3;
+    constexpr double MaxSpin = 4e-3;
+}
+
+void FramePacer::Start(double periodSeconds) {
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(periodSeconds));
+    deadline = Clock::now();
+    precise = true;
+}
+
+void FramePacer::SetPeriod(double periodSeconds, bool precise) {
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(periodSeconds));
+    this->precise = precise;
+}
+
+double FramePacer::Wait() {
+    deadline += period;
+    Clock::time_point now = Clock::now();
+    if (now > deadline + period) {
+        // Hitched; start a fresh schedule instead of rushing frames out
+        deadline = now;
+        return 0.0;
+    }
+
+    if (!precise) {
+        std::this_thread::sleep_until(deadline);
+        return std::max(std::chrono::duration<double>(Clock::now() - deadline).count(), 0.0);
+    }
+
+    double spin = std::clamp(2.0 * overshoot + 0.2e-3, MinSpin, MaxSpin);
+    Clock::time_point wakeAt = deadline - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spin));
+    if (now < wakeAt) {
+        std::this_thread::sleep_until(wakeAt);
+        double late = std::chrono::duration<double>(Clock::now() - wakeAt).count();
+        overshoot += (std::max(late, 0.0) - overshoot) * 0.1;
+    }
+
+    while ((now = Clock::now()) < deadline) std::this_thread::yield();
+    return std::chrono::duration<double>(now - deadline).count();
+}
+
+double FramePacer::Now() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+
+// Paces the main loop to a fixed frame period. OS sleeps overshoot by up to
+// a scheduler quantum, so it sleeps through most of the wait and spins the
+// last stretch; the spin margin adapts to the overshoot actually observed.
+class FramePacer {
+public:
+    void Start(double periodSeconds);
+    // Changes the period from the next frame on. An imprecise pacer only
+    // sleeps, leaving the CPU idle at the cost of waking a little late.
+    void SetPeriod(double periodSeconds, bool precise);
+    // Blocks until the next frame deadline. Returns how late it woke, in
+    // seconds. A frame that overran by more than a period is not caught up.
+    double Wait();
+
+    // Seconds on the clock the pacer uses
+    static double Now();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration period{};
+    Clock::time_point deadline;
+    double overshoot = 1e-3;   // Running average of sleep overshoot, seconds
+    bool precise = true;
+};
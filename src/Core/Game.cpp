@@ -1,64 +1,423 @@
 #include "Game.h"
+#include "AssetLoader.h"
+#include "Gfx.h"
+#include "StartupTimeline.h"
+#include "AllocTracker.h"
+#include "GameRandom.h"
+#include "SpectatorClient.h"
+#include "StateHash.h"
+#include "rlgl.h"
 #include <ctime>
 #include <cstdio>
+#include <cstring>
 #include <algorithm>
+#include <future>
 
 using HeliConst = Constants::Helicopter;
 using GameConst = Constants::Game;
 using PhysConst = Constants::Physics;
 using LevelConst = Constants::Level;
+using IdleConst = Constants::Idle;
 
-Game::Game() : isGameOver(false), victory(false) {}
+Game::Game() : simulation(audioManager) {}
 
 Game::~Game() {
-    UnloadFont(gameFont);
-    CloseWindow();
+    // Resources are released in Shutdown()
 }
 
-void Game::Init() {
-    SetRandomSeed((unsigned int)time(NULL));
-    InitWindow(Constants::ScreenWidth, Constants::ScreenHeight, "Helicopter Game");
-    SetTargetFPS(Constants::TargetFPS);
-    audioManager.Init();
-    
-    helicopter.Init(HeliConst::StartPos); 
-    level.Init();
+void Game::Init(const LaunchOptions& options) {
+    this->options = options;
+    pipelined = !options.serial;
+    seed = options.hasSeed ? options.seed : (unsigned int)time(NULL);
+    // A replayed log brings its own seed
+    if (options.headless && !options.replayFile.empty() && headlessLog.Load(options.replayFile.c_str())) {
+        seed = headlessLog.GetSeed();
+    }
+    GameRandom::Seed(seed);
+
+    if (options.headless) {
+        InitHeadless();
+        return;
+    }
+
+    StartupTimeline timeline;
+    renderScaler.Configure(options.renderScale, options.autoRenderScale);
+
+    // CPU-side loading runs on workers while the window and GL context come up.
+    // Level::Init is the only user of the RNG until the first frame.
+    auto audioDevice = std::async(std::launch::async, [&] {
+        auto scope = timeline.Measure("InitAudioDevice");
+        audioManager.InitDevice();
+    });
+    auto audioDecode = std::async(std::launch::async, [&] {
+        auto scope = timeline.Measure("Decode audio");
+        audioManager.Decode();
+    });
+    auto fontDecode = std::async(std::launch::async, [&] {
+        auto scope = timeline.Measure("Rasterize font");
+        return AssetLoader::DecodeFont("assets/arial.ttf");
+    });
+    auto leaderboardLoad = std::async(std::launch::async, [&] {
+        auto scope = timeline.Measure("Read leaderboard");
+        leaderboard.Load();
+    });
+    auto levelInit = std::async(std::launch::async, [&] {
+        auto scope = timeline.Measure("Generate level");
+        simulation.GetLevel().Init();
+    });
+
+    {
+        auto scope = timeline.Measure("InitWindow");
+        InitWindow(Constants::ScreenWidth, Constants::ScreenHeight, "Helicopter Game");
+        // No SetTargetFPS(): Run() paces frames itself so input can be sampled after the wait
+    }
+
+    // Shader and render target only need the GL context
+    {
+        auto scope = timeline.Measure("Load shader + render target");
+        cavernShader = LoadShader(0, "assets/cavern.fs");
+        LoadSceneTarget();
+        hudTarget = LoadRenderTexture(Constants::ScreenWidth, Constants::ControlPanelHeight + 1);
+    }
+    if (!options.recordFile.empty()) {
+        recorder.Start(options.recordFile.c_str(), target.texture.width, target.texture.height, true);
+        if (options.autoRenderScale) TraceLog(LOG_WARNING, "CAPTURE: Frames are dropped while the render scale differs from the start");
+    }
+
+    {
+        auto scope = timeline.Measure("Loading screen");
+        auto ready = [](const auto& f) { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+        while (!(ready(audioDevice) && ready(audioDecode) && ready(fontDecode) && ready(leaderboardLoad) && ready(levelInit))
+               && !WindowShouldClose()) {
+            DrawLoadingFrame();
+        }
+    }
+
+    // GPU/audio uploads on the main thread
+    {
+        auto scope = timeline.Measure("Upload assets");
+        audioDevice.get();
+        audioDecode.get();
+        audioManager.Upload();
+
+        FontData fontData = fontDecode.get();
+        gameFont = AssetLoader::UploadFont(fontData);
+    }
+    leaderboardLoad.get();
+    levelInit.get();
+
+    simulation.Init();
+    simulation.Capture(serialView);
+    BeginInputLog();
     backgroundManager.Init();
-    entityManager.Init();
-    
-    currentAmmo = GameConst::MaxAmmo;
-    ammoRechargeTimer = 0.0f;
 
-    gameFont = LoadFont("assets/arial.ttf");
-    
-    // Load Shader
-    cavernShader = LoadShader(0, "assets/cavern.fs");
-    target = LoadRenderTexture(Constants::ScreenWidth, Constants::ScreenHeight);
+    if (options.broadcastPort > 0) {
+        spectatorServer = std::make_unique<SpectatorServer>();
+        if (!spectatorServer->Start(options.broadcastPort)) spectatorServer.reset();
+    }
+
+    timeline.Mark("First frame");
+    timeline.Log();
+}
+
+void Game::InitHeadless() {
+    headless = true;
+    softRenderer = std::make_unique<SoftRenderer>(Constants::ScreenWidth, Constants::ScreenHeight);
+    Gfx::BindSoftware(softRenderer.get());
+
+    // Same font, kept as glyph bitmaps; it also stands in for raylib's default font
+    FontData fontData = AssetLoader::DecodeFont("assets/arial.ttf");
+    gameFont = AssetLoader::WrapFont(fontData);
+    Gfx::SetFallbackFont(gameFont);
+
+    leaderboard.Load();
+    headlessPlayer = RandomPlayer(seed);
+    simulation.GetLevel().Init();
+    simulation.Init();
+    simulation.Capture(serialView);
+    BeginInputLog();
+    backgroundManager.Init();
+
+    // Deterministic frames: no worker thread
+    pipelined = false;
+}
+
+void Game::LoadSceneTarget() {
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = LoadRenderTexture(renderScaler.GetWidth(), renderScaler.GetHeight());
+    // The shader pass stretches target over the screen
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    if (options.cpuPost) {
+        if (postTexture.id != 0) UnloadTexture(postTexture);
+        Image blank = GenImageColor(target.texture.width, target.texture.height, BLANK);
+        postTexture = LoadTextureFromImage(blank);
+        UnloadImage(blank);
+        SetTextureFilter(postTexture, TEXTURE_FILTER_BILINEAR);
+        cpuGrade = std::make_unique<CavernGrade>(target.texture.width, target.texture.height);
+        TraceLog(LOG_INFO, "RENDER: CPU cavern grade, %s kernel", CavernGrade::GetKernelName(cpuGrade->GetKernel()));
+    }
+    TraceLog(LOG_INFO, "RENDER: Scene target %dx%d (scale %.2f)", target.texture.width, target.texture.height, renderScaler.GetScale());
+}
+
+void Game::DrawLoadingFrame() {
+    const char* text = "Loading...";
+    int width = MeasureText(text, 20);
+    BeginDrawing();
+        ClearBackground((Color){25, 25, 30, 255});
+        DrawText(text, Constants::ScreenWidth/2 - width/2, Constants::ScreenHeight/2 - 10, 20, LIGHTGRAY);
+    EndDrawing();
+}
+
+void Game::BeginInputLog() {
+    if (options.inputLogFile.empty()) return;
+    inputLog.Begin(seed, Constants::Replay::HashInterval, simulation.GetStateHash());
+    simulation.SetInputLog(&inputLog);
 }
 
 void Game::Shutdown() {
+    // The simulation thread has stopped; the log is complete
+    if (!options.inputLogFile.empty()) inputLog.Save(options.inputLogFile.c_str());
+
+    if (headless) {
+        Gfx::BindSoftware(nullptr);
+        AssetLoader::UnloadSoftwareFont(gameFont);
+        softRenderer.reset();
+        return;
+    }
+
+    // The last frames are still on their way back from the GPU
+    if (recorder.IsRecording()) CollectRecordedFrames(true);
+    recordReadback.Unload();
+    recorder.Stop();
     audioManager.Shutdown();
     UnloadFont(gameFont);
     UnloadShader(cavernShader);
     UnloadRenderTexture(target);
+    if (postTexture.id != 0) UnloadTexture(postTexture);
+    UnloadRenderTexture(hudTarget);
     CloseWindow();
 }
 
-void Game::Run() {
+int Game::Run() {
+    if (headless) return RunHeadless();
+    if (options.spectatePort > 0) return RunSpectator();
+
+    if (pipelined) simThread.Start(simulation);
+    framePacer.Start(Constants::TickTime);
+
     while (!WindowShouldClose()) {
-        Update();
-        Draw();
+        // Wait out the frame first, then sample input as late as possible
+        double pacingError = framePacer.Wait();
+        PollInputEvents();
+        inputLatch.Capture();
+        double sampledAt = FramePacer::Now();
+
+        const SimSnapshot& view = pipelined ? simThread.AcquireLatest() : serialView;
+        if (spectatorServer) spectatorServer->Publish(view);
+
+        // Music Control
+        float frameTime = idle ? 1.0f / IdleConst::FramesPerSecond : Constants::TickTime;
+        audioManager.UpdateMusic(view.helicopter.HasStarted(), view.isGameOver, 1.5f, frameTime);
+        audioManager.FlushSounds();
+
+        if (inputLatch.Pressed(KEY_F3)) debugOverlay.Toggle();
+        debugOverlay.Sample();
+
+        InputFrame input = Update(view);
+        inputLatch.Clear();
+        // An idle frame stands for several ticks, so simulation time keeps up with the clock
+        int ticks = idle ? Constants::TargetFPS / IdleConst::FramesPerSecond : 1;
+        ticksSubmitted += ticks;
+        latency.InputSampled(ticksSubmitted, sampledAt);
+
+        const SimSnapshot& shown = Step(input, ticks);
+        UpdateParticles(shown);
+
+        // Slow down once the world has stayed still for a moment; an input or
+        // a change to the world brings the full rate back on this frame.
+        // Idle frames that only change the overlays (typing, the cursor
+        // blink) compose them over the world already in target.
+        uint64_t sceneKey = GetSceneKey(shown);
+        uint64_t screenKey = GetScreenKey(shown, sceneKey);
+        bool sceneChanged = sceneKey != shownSceneKey || IsWindowResized();
+        if (sceneChanged || !CanIdle(shown, input)) staticSince = sampledAt;
+        bool wasIdle = idle;
+        SetIdle(sampledAt - staticSince >= IdleConst::Linger);
+        if (idle && screenKey == shownScreenKey) continue;
+
+        Draw(shown, !idle || sceneChanged);
+        shownSceneKey = sceneKey;
+        shownScreenKey = screenKey;
+        // EndDrawing() polled as well; keep the presses it saw for the next frame
+        inputLatch.Capture();
+        if (idle) continue;
+
+        latency.AddPacingError(pacingError);
+        debugOverlay.SampleTiming(latency.Presented(shown.tick, FramePacer::Now()), pacingError * 1000.0);
+
+        // The first frame after idling measures the whole idle stretch
+        if (!wasIdle && renderScaler.Update(GetFrameTime())) {
+            LoadSceneTarget();
+        }
+    }
+
+    latency.Log("FRAME");
+    simThread.Stop();
+    simulation.GetRewind().Log("REWIND");
+    spectatorServer.reset();
+    Shutdown();
+    return 0;
+}
+
+int Game::RunSpectator() {
+    SpectatorClient client;
+    if (!client.Connect("127.0.0.1", options.spectatePort)) {
+        Shutdown();
+        return 1;
+    }
+
+    // The local leaderboard is shown on game over, without name entry
+    nameEntered = true;
+    SimSnapshot view = serialView; // Until the first keyframe arrives
+
+    framePacer.Start(Constants::TickTime);
+    while (!WindowShouldClose() && client.Poll(view)) {
+        framePacer.Wait();
+        audioManager.UpdateMusic(view.helicopter.HasStarted(), view.isGameOver, 1.5f, Constants::TickTime);
+
+        if (IsKeyPressed(KEY_F3)) debugOverlay.Toggle();
+        debugOverlay.Sample();
+
+        UpdateParticles(view);
+        Draw(view);
+    }
+
+    client.Close();
+    Shutdown();
+    return 0;
+}
+
+const SimSnapshot& Game::Step(const InputFrame& input, int ticks) {
+    // Ticks before the last one carry no input
+    if (pipelined) {
+        for (int i = 1; i < ticks; i++) {
+            simThread.Submit(InputFrame());
+            simThread.AcquireLatest();
+        }
+        // The worker computes the next tick while this frame draws the previous
+        // one; the front buffer stays untouched until the next AcquireLatest()
+        simThread.Submit(input);
+        return simThread.Front();
+    }
+
+    for (int i = 1; i < ticks; i++) simulation.Tick(InputFrame());
+    simulation.Tick(input);
+    simulation.Capture(serialView);
+    return serialView;
+}
+
+int Game::RunHeadless() {
+    long failedFrames = 0;
+    char path[512];
+    AllocTracker::Stats halfway = {};
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        if (frame == options.frames / 2) halfway = AllocTracker::GetTotals();
+
+        InputFrame input = NextHeadlessInput(frame);
+        const SimSnapshot& shown = Step(input);
+        UpdateParticles(shown);
+        DrawSoftware(shown);
+
+        if (!options.dumpDir.empty()) {
+            snprintf(path, sizeof(path), "%s/frame_%05d.ppm", options.dumpDir.c_str(), frame);
+            if (!softRenderer->SavePPM(path)) TraceLog(LOG_WARNING, "HEADLESS: Could not write %s", path);
+        }
+        if (!options.goldenDir.empty()) {
+            snprintf(path, sizeof(path), "%s/frame_%05d.ppm", options.goldenDir.c_str(), frame);
+            long differing = softRenderer->ComparePPM(path);
+            if (differing != 0) {
+                failedFrames++;
+                if (differing < 0) TraceLog(LOG_WARNING, "HEADLESS: Golden image %s missing or unreadable", path);
+                else TraceLog(LOG_WARNING, "HEADLESS: Frame %d differs from golden in %ld pixels", frame, differing);
+            }
+        }
     }
+
+    if (!options.goldenDir.empty()) {
+        TraceLog(failedFrames ? LOG_WARNING : LOG_INFO, "HEADLESS: %ld of %d frames differ from golden images", failedFrames, options.frames);
+    }
+
+    // Steady state: allocations per frame and heap growth over the second half of the run
+    AllocTracker::Stats end = AllocTracker::GetTotals();
+    int measured = std::max(options.frames - options.frames / 2, 1);
+    TraceLog(LOG_INFO, "HEADLESS: Heap %.1f KB live, %.1f allocs/frame, %+.1f KB over the second half",
+             end.liveBytes / 1024.0, (double)(end.allocations - halfway.allocations) / measured,
+             ((double)end.liveBytes - (double)halfway.liveBytes) / 1024.0);
+    AllocTracker::Log("HEADLESS");
     Shutdown();
+    return failedFrames ? 1 : 0;
+}
+
+namespace {
+    // Headless pilot: climbs when the helicopter is headed below the middle
+    // of the gap a little ahead of it, found by probing the terrain. `level`
+    // has to be the simulation's own, between ticks; snapshot copies don't
+    // query the collision mask.
+    bool PilotClimbs(const Level& level, const Helicopter& helicopter) {
+        Vector2 pos = helicopter.GetPosition();
+        Vector2 velocity = helicopter.GetVelocity();
+        const float probeX = pos.x + 60.0f, probeWidth = 40.0f, step = 4.0f;
+        float ceiling = pos.y, floor = pos.y;
+        while (ceiling > 0 && !level.CheckCollision(Rectangle{probeX, ceiling - step, probeWidth, step})) ceiling -= step;
+        while (floor < Constants::ScreenHeight && !level.CheckCollision(Rectangle{probeX, floor, probeWidth, step})) floor += step;
+        float target = (ceiling + floor) / 2.0f - HeliConst::Height / 2.0f;
+        return !helicopter.HasStarted() || pos.y + velocity.y * 8.0f > target;
+    }
+}
+
+InputFrame Game::NextHeadlessInput(long frame) {
+    // Update() still runs the game over UI; no key reads as down here
+    InputFrame input = Update(serialView);
+    if (headlessLog.GetTickCount() > 0) {
+        // One tick per frame, so frames line up with the log's ticks
+        input = frame < headlessLog.GetTickCount() ? headlessLog.GetInput(frame) : InputFrame();
+        if (input.reset) Reset();
+    } else if (!serialView.isGameOver) {
+        // Random shots, steered flight. Headless runs tick serially, so the
+        // simulation is idle here; the pilot never rewinds, so its mask is current.
+        input.shoot = headlessPlayer.Next().shoot;
+        input.up = PilotClimbs(simulation.GetLevel(), serialView.helicopter);
+    }
+    return input;
+}
+
+void Game::UpdateParticles(const SimSnapshot& view) {
+    double start = FramePacer::Now();
+
+    // Debris moves with the terrain; a restart takes the old run's particles with it
+    float scroll = 0.0f;
+    if (view.run != particleRun) {
+        particles.Clear();
+        particleRun = view.run;
+    } else {
+        scroll = std::max(view.GetDistance() - particleDistance, 0.0f);
+    }
+    particleDistance = view.GetDistance();
+
+    // A snapshot can be shown on more than one frame; its bursts go off once
+    if (view.tick != particleTick) {
+        for (const ParticleBurst& burst : view.entities.GetBursts()) particles.Emit(burst);
+        particleTick = view.tick;
+    }
+    particles.Update(Constants::TickTime, scroll);
+
+    debugOverlay.SampleParticles(particles.GetCount(), (FramePacer::Now() - start) * 1000.0);
 }
 
 void Game::Reset() {
-    isGameOver = false;
-    helicopter.Init(HeliConst::StartPos); 
-    level.Init(); // Re-init level to clear obstacles/walls
-    entityManager.Reset();
-    currentAmmo = GameConst::MaxAmmo;
-    ammoRechargeTimer = 0.0f;
+    // The simulation resets at the start of its next tick
+    resetRequested = true;
     
     // Reset Leaderboard Input
     letterCount = 0;
@@ -66,182 +425,361 @@ void Game::Reset() {
     nameEntered = false;
 }
 
-void Game::Update() {
-    // Music Control
-    audioManager.UpdateMusic(helicopter.HasStarted(), isGameOver, 90);
+InputFrame Game::Update(const SimSnapshot& view) {
+    InputFrame input;
+
+    // Until the reset tick has been drawn the old run's game over state is still on screen
+    if (resetRequested && view.isGameOver) return input;
+    resetRequested = false;
 
-    if (isGameOver) {
-        int score = (int)level.GetDistance();
+    if (view.isGameOver) {
+        int score = (int)view.GetDistance();
         
         // Check for High Score Input
         if (leaderboard.IsHighScore(score) && !nameEntered) {
-             SetMouseCursor(MOUSE_CURSOR_IBEAM);
+             if (!headless) SetMouseCursor(MOUSE_CURSOR_IBEAM);
              
-             int key = GetCharPressed();
+             int key = inputLatch.NextChar();
              while (key > 0) {
                  if ((key >= 32) && (key <= 125) && (letterCount < 9)) {
                      playerNameInput[letterCount] = (char)key;
                      playerNameInput[letterCount+1] = '\0'; // Null terminator
                      letterCount++;
                  }
-                 key = GetCharPressed();
+                 key = inputLatch.NextChar();
              }
              
-             if (IsKeyPressed(KEY_BACKSPACE)) {
+             if (inputLatch.Pressed(KEY_BACKSPACE)) {
                  letterCount--;
                  if (letterCount < 0) letterCount = 0;
                  playerNameInput[letterCount] = '\0';
              }
              
-             if (IsKeyPressed(KEY_ENTER) && letterCount > 0) {
+             if (inputLatch.Pressed(KEY_ENTER) && letterCount > 0) {
                  leaderboard.AddEntry(playerNameInput, score);
                  nameEntered = true;
-                 SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+                 if (!headless) SetMouseCursor(MOUSE_CURSOR_DEFAULT);
              }
         } else {
              // Normal Game Over Screen
-             if (IsKeyPressed(KEY_R)) {
+             if (inputLatch.Pressed(KEY_R)) {
                 Reset();
+                input.reset = true;
             }
+            input.rewind = IsKeyDown(KEY_Z);
         }
-        return;
+        return input;
     }
-    
-    helicopter.Update();
 
-    if (helicopter.HasStarted()) {
-        level.Update(); // Update terrain
-        
-        // Update Entities
-        entityManager.Update(GetFrameTime(), level, helicopter, audioManager);
-        
-        // Check Player Collisions (Entities)
-        if (entityManager.CheckPlayerCollisions(helicopter.GetRect())) {
-            isGameOver = true;
-            audioManager.PlayGameOver();
-            // The leaderboard check is handled in the isGameOver block above.
-            return; // Game over, stop further updates for this frame
-        }
-    }
+    input.up = IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
+    input.left = IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT);
+    input.right = IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT);
+    input.shoot = inputLatch.Pressed(KEY_SPACE);
+    input.rewind = IsKeyDown(KEY_Z);
+    return input;
+}
 
-    // Recharge Ammo
-    if (currentAmmo < GameConst::MaxAmmo) {
-        ammoRechargeTimer += GetFrameTime();
-        if (ammoRechargeTimer >= GameConst::AmmoRechargeDelay) {
-            currentAmmo++;
-            ammoRechargeTimer = 0.0f;
-        }
+namespace {
+    // Slots in the game over text caches
+    enum NameEntrySlot { NameTitle, NameScore, NamePrompt, NameInput, NameCursor, NameConfirm };
+    enum LeaderboardSlot { BoardTitle, BoardRestart, BoardFirstRow };
+    enum HudSlot { HudDistance, HudAmmo };
+
+    // The name entry cursor blinks once a second of simulation time, so a
+    // given snapshot always draws it the same way
+    bool CursorShown(unsigned long tick) { return (tick / Constants::TargetFPS) % 2 == 0; }
+}
+
+uint64_t Game::GetSceneKey(const SimSnapshot& view) const {
+    // Outside of flight the world only moves with a new run or a rewind
+    StateHash hash;
+    hash.Put(view.run);
+    hash.Put(view.GetDistance());
+    hash.Put(view.helicopter.GetPosition());
+    hash.PutU8(view.helicopter.HasStarted());
+    hash.PutU8(view.isGameOver);
+    hash.Put(renderScaler.GetScale());
+    return hash.Get();
+}
+
+uint64_t Game::GetScreenKey(const SimSnapshot& view, uint64_t sceneKey) const {
+    StateHash hash(sceneKey);
+    hash.Put(view.ammo);
+    hash.PutU8(view.rewinding);
+    hash.PutU8(resetRequested);
+    hash.PutU8(nameEntered);
+    hash.Put(playerNameInput);
+    hash.Put(leaderboard.GetRevision());
+    // The cursor only blinks while a name is being entered
+    if (view.isGameOver && !resetRequested && !nameEntered && leaderboard.IsHighScore((int)view.GetDistance())) {
+        hash.PutU8(CursorShown(view.tick));
     }
+    hash.Put(view.minimap.get());
+    hash.PutU8(debugOverlay.IsVisible());
+    return hash.Get();
+}
+
+bool Game::CanIdle(const SimSnapshot& view, const InputFrame& input) const {
+    if (view.helicopter.HasStarted() && !view.isGameOver) return false;
+    // Rewinds, restarts and the explosion's debris still move the world
+    if (view.rewinding || resetRequested || particles.GetCount() > 0) return false;
+    if (input.up || input.left || input.right || input.shoot || input.rewind || input.reset) return false;
+    // A recording and the overlay's timings need every frame
+    return !recorder.IsRecording() && !debugOverlay.IsVisible();
+}
+
+void Game::SetIdle(bool on) {
+    if (on == idle) return;
+    idle = on;
+    // Idle frames only sleep; the music buffers outlast them
+    if (on) framePacer.SetPeriod(1.0 / IdleConst::FramesPerSecond, false);
+    else framePacer.SetPeriod(Constants::TickTime, true);
+    TraceLog(LOG_DEBUG, "FRAME: %s", on ? "Idle" : "Active");
+}
+
+void Game::UpdateControlPanel(const SimSnapshot& view) {
+    int distance = (int)view.GetDistance();
+    int currentAmmo = view.ammo;
+    if (distance == hudDistance && currentAmmo == hudAmmo && view.isGameOver == hudGameOver) return;
 
-    // Input: Shooting
-    if (IsKeyPressed(KEY_SPACE) && currentAmmo > 0) {
-        Vector2 heliPos = helicopter.GetPosition();
-        // Spawn at nose (Width 40, Height 20 -> Center Right ~ 40, 10)
-        entityManager.SpawnProjectile(Vector2{heliPos.x + HeliConst::Width, heliPos.y + HeliConst::Height / 2.0f}, helicopter.IsFacingRight());
-        currentAmmo--;
-        audioManager.PlayShoot();
+    if (distance != hudDistance) {
+        char scoreText[50];
+        sprintf(scoreText, "Distance: %d", distance);
+        hudText.Set(HudDistance, gameFont, scoreText, Vector2{20.0f, 15.0f}, 20, 1, WHITE);
     }
-    
-    // Check Player Level Collisions
-    if (level.CheckCollision(helicopter.GetRect())) {
-        isGameOver = true;
-        audioManager.PlayGameOver();
+    if (currentAmmo != hudAmmo) {
+        char ammoText[50];
+        sprintf(ammoText, "Ammo: %d / %d", currentAmmo, GameConst::MaxAmmo);
+        Color ammoColor = (currentAmmo == 0) ? RED : GREEN;
+        hudText.Set(HudAmmo, gameFont, ammoText, Vector2{200.0f, 15.0f}, 20, 1, ammoColor);
     }
+    hudDistance = distance;
+    hudAmmo = currentAmmo;
+    hudGameOver = view.isGameOver;
+
+    if (headless) return;
+
+    BeginTextureMode(hudTarget);
+        ClearBackground(BLANK);
+        DrawControlPanel();
+    EndTextureMode();
 }
 
-void Game::Draw() {
-    // Draw everything to the render texture
-    BeginTextureMode(target);
-        ClearBackground((Color){25, 25, 30, 255});  // Dark cave background
-        
-        backgroundManager.Draw(level.GetDistance());
+void Game::DrawControlPanel() {
+    Gfx::DrawRectangle(0, 0, Constants::ScreenWidth, Constants::ControlPanelHeight, DARKGRAY);
+    Gfx::DrawRectangle(0, Constants::ControlPanelHeight, Constants::ScreenWidth, 1, WHITE);
+    hudText.Draw();
+}
 
-        // Draw World
-        level.Draw(gameFont);
-        
-        entityManager.Draw();
+void Game::DrawWorld(const SimSnapshot& view) {
+    drawList.Begin(Rectangle{0, 0, (float)Constants::ScreenWidth, (float)Constants::ScreenHeight});
+    backgroundManager.Draw(view.GetDistance(), drawList);
+    view.level.Draw(drawList);
+    view.entities.Draw(drawList, view.tick);
+    view.helicopter.Draw(drawList);
+    drawList.Sort();
 
-        helicopter.Draw();
-    EndTextureMode();
+    // Text and particles are batched on their own, at their place in the stack
+    drawList.ReplayThrough(DrawLayer::StartPad);
+    view.level.DrawText(gameFont, levelText);
+    drawList.ReplayThrough(DrawLayer::Entities);
+    particles.Draw();
+    drawList.ReplayThrough(DrawLayer::Helicopter);
+
+    debugOverlay.SampleDraw(drawList);
+}
+
+void Game::DrawSoftware(const SimSnapshot& view) {
+    AllocTracker::Scope allocScope(AllocTracker::Tag::Render);
+    UpdateControlPanel(view);
+
+    softRenderer->Clear((Color){25, 25, 30, 255});  // Dark cave background
+    DrawWorld(view);
+    softRenderer->ApplyCavernGrade();
+
+    DrawControlPanel();
+    DrawRewindLabel(view);
+    if (view.isGameOver && !resetRequested) {
+        DrawGameOverScreen(view);
+    }
+}
+
+void Game::Draw(const SimSnapshot& view, bool redrawScene) {
+    AllocTracker::Scope allocScope(AllocTracker::Tag::Render);
+    UpdateControlPanel(view);
+
+    // Draw everything to the render texture, scaled down to its internal resolution
+    if (redrawScene) {
+        Camera2D sceneCamera = { {0, 0}, {0, 0}, 0.0f, renderScaler.GetScale() };
+        BeginTextureMode(target);
+            ClearBackground((Color){25, 25, 30, 255});  // Dark cave background
+            BeginMode2D(sceneCamera);
+            DrawWorld(view);
+            EndMode2D();
+        EndTextureMode();
+    }
+
+    // The recording gets the scene before the grade, a couple of frames
+    // late: the GPU copies it out while later frames are drawn
+    if (recorder.IsRecording()) {
+        CollectRecordedFrames(false);
+        if (!recordReadback.Request(target)) recorder.DropFrame();
+    }
+
+    // The CPU grade shows this very frame, so it has to wait for the read-back
+    int width = target.texture.width, height = target.texture.height;
+    uint32_t* pixels = nullptr;
+    if (cpuGrade && redrawScene) {
+        pixels = (uint32_t*)rlReadTexturePixels(target.texture.id, width, height, target.texture.format);
+    }
 
     // Begin drawing to screen
     BeginDrawing();
         ClearBackground(BLACK);
         
-        // Draw the render texture with the shader
-        BeginShaderMode(cavernShader);
-            // Note: RenderTextures are y-flipped in OpenGL
-            DrawTextureRec(target.texture, 
-                           (Rectangle){ 0, 0, (float)target.texture.width, (float)-target.texture.height }, 
-                           (Vector2){ 0, 0 }, WHITE);
-        EndShaderMode();
+        // Draw the render texture with the shader, upscaling it to the screen
+        // Note: RenderTextures are y-flipped in OpenGL
+        Rectangle flipped = { 0, 0, (float)width, (float)-height };
+        Rectangle screen = { 0, 0, (float)Constants::ScreenWidth, (float)Constants::ScreenHeight };
+        if (cpuGrade) {
+            // The read-back rows come bottom up, which the vertically symmetric grade doesn't mind.
+            // An unchanged scene is still graded in postTexture.
+            if (pixels) {
+                cpuGrade->Apply(pixels);
+                UpdateTexture(postTexture, pixels);
+            }
+            DrawTexturePro(postTexture, flipped, screen, (Vector2){ 0, 0 }, 0.0f, WHITE);
+        } else {
+            BeginShaderMode(cavernShader);
+                DrawTexturePro(target.texture, flipped, screen, (Vector2){ 0, 0 }, 0.0f, WHITE);
+            EndShaderMode();
+        }
+        if (pixels) MemFree(pixels);
 
     // Draw Control Panel
-    DrawRectangle(0, 0, Constants::ScreenWidth, Constants::ControlPanelHeight, DARKGRAY);
-    DrawLine(0, Constants::ControlPanelHeight, Constants::ScreenWidth, Constants::ControlPanelHeight, WHITE);
-
-    // Draw Score
-    char scoreText[50];
-    sprintf(scoreText, "Distance: %d", (int)level.GetDistance());
-    DrawTextEx(gameFont, scoreText, Vector2{20.0f, 15.0f}, 20, 1, WHITE);
-
-    // Draw Ammo
-    char ammoText[50];
-    sprintf(ammoText, "Ammo: %d / %d", currentAmmo, GameConst::MaxAmmo);
-    Color ammoColor = (currentAmmo == 0) ? RED : GREEN;
-    DrawTextEx(gameFont, ammoText, Vector2{200.0f, 15.0f}, 20, 1, ammoColor);
-
-    if (isGameOver) {
-        DrawRectangle(0, 0, Constants::ScreenWidth, Constants::ScreenHeight, Fade(BLACK, 0.85f));
-        
-        int currentScore = (int)level.GetDistance();
+    DrawTextureRec(hudTarget.texture,
+                   (Rectangle){ 0, 0, (float)hudTarget.texture.width, (float)-hudTarget.texture.height },
+                   (Vector2){ 0, 0 }, WHITE);
+
+    DrawRewindLabel(view);
+    if (view.isGameOver && !resetRequested) {
+        DrawGameOverScreen(view);
+    }
+
+    debugOverlay.Draw();
+    
+    EndDrawing();
+}
+
+void Game::CollectRecordedFrames(bool wait) {
+    int width, height;
+    while (const uint32_t* pixels = recordReadback.MapOldest(wait, &width, &height)) {
+        // A full ring drops the frame rather than wait for the disk
+        uint32_t* slot = recorder.BeginFrame(width, height);
+        if (slot) {
+            memcpy(slot, pixels, (size_t)width * height * sizeof(uint32_t));
+            recorder.EndFrame();
+        }
+        recordReadback.Release();
+    }
+}
+
+void Game::DrawRewindLabel(const SimSnapshot& view) {
+    if (!view.rewinding) return;
+    // Tenths of a second, so the label is laid out again a few times a second at most
+    int tenths = (int)(view.rewindSeconds * 10.0f);
+    if (tenths != shownRewindTenths) {
+        rewindText.SetDefault(0, TextFormat("<< REWIND %d.%d s", tenths / 10, tenths % 10),
+                              Constants::ScreenWidth - 220, 15, 20, SKYBLUE);
+        shownRewindTenths = tenths;
+    }
+    rewindText.Draw();
+}
+
+void Game::DrawGameOverScreen(const SimSnapshot& view) {
+    Gfx::DrawRectangle(0, 0, Constants::ScreenWidth, Constants::ScreenHeight, Fade(BLACK, 0.85f));
+    
+    int currentScore = (int)view.GetDistance();
+    int centerX = Constants::ScreenWidth / 2;
+
+    if (leaderboard.IsHighScore(currentScore) && !nameEntered) {
+         // Input UI
+         nameEntryText.SetDefault(NameTitle, "NEW HIGH SCORE!", 0, 150, 40, GOLD);
+         nameEntryText.Move(NameTitle, Vector2{(float)(centerX - (int)nameEntryText.Measure(NameTitle).x / 2), 150.0f});
+
+         if (currentScore != shownScore) {
+             nameEntryText.SetDefault(NameScore, TextFormat("Score: %d", currentScore), 0, 210, 30, WHITE);
+             nameEntryText.Move(NameScore, Vector2{(float)(centerX - (int)nameEntryText.Measure(NameScore).x / 2), 210.0f});
+             shownScore = currentScore;
+         }
+
+         nameEntryText.SetDefault(NamePrompt, "Enter Name:", centerX - 100, 280, 20, LIGHTGRAY);
+         nameEntryText.SetDefault(NameInput, playerNameInput, centerX - 90, 320, 20, MAROON);
+
+         if (CursorShown(view.tick)) {
+             int textWidth = (int)nameEntryText.Measure(NameInput).x;
+             nameEntryText.SetDefault(NameCursor, "_", centerX - 90 + textWidth, 320, 20, MAROON);
+         } else {
+             nameEntryText.Hide(NameCursor);
+         }
+
+         nameEntryText.SetDefault(NameConfirm, "Press ENTER", centerX - 60, 360, 10, GRAY);
+
+         Gfx::DrawRectangle(centerX - 100, 310, 200, 40, LIGHTGRAY);
+         nameEntryText.Draw();
+    } else {
+         // Leaderboard UI
+         if (leaderboard.GetRevision() != shownLeaderboardRevision) {
+             leaderboardText.SetDefault(BoardTitle, "LEADERBOARD", 0, 100, 40, GOLD);
+             leaderboardText.Move(BoardTitle, Vector2{(float)(centerX - (int)leaderboardText.Measure(BoardTitle).x / 2), 100.0f});
 
-        if (leaderboard.IsHighScore(currentScore) && !nameEntered) {
-             // Input UI
-             const char* title = "NEW HIGH SCORE!";
-             int titleWidth = MeasureText(title, 40);
-             DrawText(title, Constants::ScreenWidth/2 - titleWidth/2, 150, 40, GOLD);
-             
-             const char* scoreText = TextFormat("Score: %d", currentScore);
-             int scoreWidth = MeasureText(scoreText, 30);
-             DrawText(scoreText, Constants::ScreenWidth/2 - scoreWidth/2, 210, 30, WHITE);
-             
-             DrawText("Enter Name:", Constants::ScreenWidth/2 - 100, 280, 20, LIGHTGRAY);
-             
-             DrawRectangle(Constants::ScreenWidth/2 - 100, 310, 200, 40, LIGHTGRAY);
-             DrawText(playerNameInput, Constants::ScreenWidth/2 - 90, 320, 20, MAROON);
-             
-             if ((int)GetTime() % 2 == 0) {
-                 int textWidth = MeasureText(playerNameInput, 20);
-                 DrawText("_", Constants::ScreenWidth/2 - 90 + textWidth, 320, 20, MAROON);
-             }
-             
-             DrawText("Press ENTER", Constants::ScreenWidth/2 - 60, 360, 10, GRAY);
-        } else {
-             // Leaderboard UI
-             const char* title = "LEADERBOARD";
-             int titleWidth = MeasureText(title, 40);
-             DrawText(title, Constants::ScreenWidth/2 - titleWidth/2, 100, 40, GOLD);
-             
              const auto& entries = leaderboard.GetEntries();
              int y = 160;
              for (size_t i = 0; i < entries.size(); ++i) {
+                 int slot = BoardFirstRow + (int)i;
                  Color color = (i == 0) ? YELLOW : WHITE;
-                 const char* entryText = TextFormat("%d. %s ................. %d", i+1, entries[i].name.c_str(), entries[i].score);
-                 int entryWidth = MeasureText(entryText, 20);
-                 DrawText(entryText, Constants::ScreenWidth/2 - entryWidth/2, y, 20, color);
+                 const char* entryText = TextFormat("%d. %s ................. %d", (int)i+1, entries[i].name.c_str(), entries[i].score);
+                 leaderboardText.SetDefault(slot, entryText, 0, y, 20, color);
+                 leaderboardText.Move(slot, Vector2{(float)(centerX - (int)leaderboardText.Measure(slot).x / 2), (float)y});
                  y += 35;
              }
-             
-             Vector2 subTextMeasure = MeasureTextEx(gameFont, "Press 'R' to Restart", 20, 1);
-             DrawTextEx(gameFont, "Press 'R' to Restart", Vector2{(float)Constants::ScreenWidth/2.0f - subTextMeasure.x/2.0f, (float)Constants::ScreenHeight - 80.0f}, 20, 1, GRAY);
-        }
+             leaderboardText.Truncate(BoardFirstRow + (int)entries.size());
+
+             const char* restart = "Press 'R' to Restart";
+             leaderboardText.Set(BoardRestart, gameFont, restart, Vector2{0, 0}, 20, 1, GRAY);
+             Vector2 subTextMeasure = leaderboardText.Measure(BoardRestart);
+             leaderboardText.Move(BoardRestart, Vector2{(float)Constants::ScreenWidth/2.0f - subTextMeasure.x/2.0f, (float)Constants::ScreenHeight - 80.0f});
+
+             shownLeaderboardRevision = leaderboard.GetRevision();
+         }
+         leaderboardText.Draw();
     }
-    
-    EndDrawing();
+
+    if (view.minimap) DrawMinimap(*view.minimap);
 }
 
-void Game::gameOver() {
-    isGameOver = true;
-    audioManager.PlayGameOver();
+void Game::DrawMinimap(const TerrainHistory::Minimap& minimap) {
+    using MapConst = Constants::Minimap;
+    const Color rock = { 90, 70, 55, 255 };
+    Gfx::DrawRectangle(MapConst::X, MapConst::Y, MapConst::Width, MapConst::Height, (Color){ 25, 25, 30, 255 });
+
+    // Terrain heights run from the control panel to the bottom of the screen
+    float scale = (float)MapConst::Height / (Constants::ScreenHeight - Constants::ControlPanelHeight);
+    auto toStrip = [&](int y) { return MapConst::Y + (int)((y - Constants::ControlPanelHeight) * scale); };
+    int bottom = MapConst::Y + MapConst::Height;
+
+    for (int p = 0; p < (int)minimap.pixels.size(); p++) {
+        const TerrainHistory::Summary& column = minimap.pixels[p];
+        int x = MapConst::X + p;
+        int ceiling = toStrip(column.ceiling), floor = toStrip(column.floor);
+        if (column.flags & TerrainHistory::Wall) Gfx::DrawRectangle(x, ceiling, 1, floor - ceiling, Fade(LIGHTGRAY, 0.5f));
+        Gfx::DrawRectangle(x, MapConst::Y, 1, ceiling - MapConst::Y, rock);
+        Gfx::DrawRectangle(x, floor, 1, bottom - floor, rock);
+        if (column.flags & TerrainHistory::CeilingSpike) Gfx::DrawRectangle(x, ceiling, 1, 3, ORANGE);
+        if (column.flags & TerrainHistory::FloorSpike) Gfx::DrawRectangle(x, floor - 3, 1, 3, ORANGE);
+    }
+
+    if (minimap.deathPixel >= 0) {
+        Gfx::DrawRectangle(MapConst::X + minimap.deathPixel - 1, MapConst::Y - 4, 3, MapConst::Height + 8, RED);
+    }
 }
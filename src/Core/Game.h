@@ -1,14 +1,27 @@
 #pragma once
 #include "raylib.h"
 #include "Constants.h"
-#include "Helicopter.h"
-#include "Level.h"
-#include "Missile.h"
-#include "MissileFactory.h"
 #include "AudioManager.h"
 #include "LeaderboardManager.h"
 #include "BackgroundManager.h"
-#include "EntityManager.h"
+#include "Simulation.h"
+#include "SimSnapshot.h"
+#include "SimThread.h"
+#include "InputFrame.h"
+#include "TextCache.h"
+#include "RenderScaler.h"
+#include "LaunchOptions.h"
+#include "SoftRenderer.h"
+#include "VideoRecorder.h"
+#include "PixelReadback.h"
+#include "DebugOverlay.h"
+#include "SpectatorServer.h"
+#include "FramePacer.h"
+#include "InputLatch.h"
+#include "LatencyTracker.h"
+#include "ParticleSystem.h"
+#include "DrawList.h"
+#include "RandomPlayer.h"
 #include <vector>
 #include <memory>
 
@@ -17,31 +30,79 @@ public:
     Game();
     ~Game();
 
-    void Init();
-    void Run();
+    void Init(const LaunchOptions& options = LaunchOptions());
+    // Returns the process exit code (non-zero if a headless golden comparison failed)
+    int Run();
     void Shutdown();
 
 private:
-    void Update();
-    void Draw();
+    // Runs the game over UI and samples input for the next simulation tick
+    InputFrame Update(const SimSnapshot& view);
+    // Produces the snapshot to draw this frame (pipelined or serial), after
+    // `ticks` ticks of which the last one gets `input`
+    const SimSnapshot& Step(const InputFrame& input, int ticks = 1);
+    // `redrawScene` false keeps the world already in target and only composes the screen
+    void Draw(const SimSnapshot& view, bool redrawScene = true);
+    // Emits the bursts of a new tick and advances the particles one frame
+    void UpdateParticles(const SimSnapshot& view);
+    void InitHeadless();
+    int RunHeadless();
+    // Headless frames have no keyboard: they replay --replay's log, or a
+    // scripted pilot flies until the run ends
+    InputFrame NextHeadlessInput(long frame);
+    int RunSpectator();
+    void DrawSoftware(const SimSnapshot& view);
+    // Background, level, entities, particles and helicopter, in world space
+    void DrawWorld(const SimSnapshot& view);
+    void DrawControlPanel();
+    void DrawLoadingFrame();
+    void LoadSceneTarget();
+    void UpdateControlPanel(const SimSnapshot& view);
+    void DrawRewindLabel(const SimSnapshot& view);
+    void DrawGameOverScreen(const SimSnapshot& view);
+    // The whole run's terrain in one strip, with where it ended
+    void DrawMinimap(const TerrainHistory::Minimap& minimap);
     void Reset();
-    void cleanup();
-    void gameOver();
-    Helicopter helicopter;
-    Level level;
+    // Hashes of what a frame shows: the world drawn into target, and the whole screen
+    uint64_t GetSceneKey(const SimSnapshot& view) const;
+    uint64_t GetScreenKey(const SimSnapshot& view, uint64_t sceneKey) const;
+    // True if nothing but the menu overlays can change until the next input
+    bool CanIdle(const SimSnapshot& view, const InputFrame& input) const;
+    void SetIdle(bool on);
+    // --record-inputs: log every tick from the first one on
+    void BeginInputLog();
+    LaunchOptions options;
+    unsigned int seed = 0;
+    InputLog inputLog;
+    bool headless = false;
+    std::unique_ptr<SoftRenderer> softRenderer; // Headless framebuffer
+    InputLog headlessLog;
+    RandomPlayer headlessPlayer;
+
     Font gameFont;
 
     // Audio
     AudioManager audioManager;
-    
-    // Entities
-    EntityManager entityManager;
 
-    int currentAmmo = 5;
-    float ammoRechargeTimer = 0.0f;
+    // Gameplay state; ticks on simThread unless running serially
+    Simulation simulation;
+    SimThread simThread;
+    bool pipelined = true;
+    SimSnapshot serialView;     // Latest tick when not pipelined
+    bool resetRequested = false;
+
+    // Frame pacing and input latency
+    FramePacer framePacer;
+    InputLatch inputLatch;
+    LatencyTracker latency;
+    unsigned long ticksSubmitted = 0;
 
-    bool isGameOver;
-    bool victory;
+    // Idle power mode: off the flight screen, frames are only drawn when
+    // what they show changed and the loop runs at a low rate
+    bool idle = false;
+    double staticSince = 0.0;
+    uint64_t shownSceneKey = 0;
+    uint64_t shownScreenKey = 0;
     
     // Leaderboard
     LeaderboardManager leaderboard;
@@ -51,8 +112,49 @@ private:
 
     // Shaders
     Shader cavernShader;
-    RenderTexture2D target; 
+    RenderTexture2D target = {};
+    RenderScaler renderScaler; // Internal resolution of target
+    // --cpu-post: target is read back, graded on the CPU and shown through
+    // postTexture instead of the shader
+    std::unique_ptr<CavernGrade> cpuGrade;
+    Texture2D postTexture = {};
+    VideoRecorder recorder;     // --record
+    PixelReadback recordReadback;
+    // Hands the frames read back so far to the recorder; `wait` for all of them
+    void CollectRecordedFrames(bool wait);
+
+    // HUD: the control panel is composed into hudTarget and only redrawn
+    // when one of the values it shows changes
+    RenderTexture2D hudTarget = {};
+    TextCache hudText;
+    int hudDistance = -1;
+    int hudAmmo = -1;
+    bool hudGameOver = false;
+
+    // Game over screens, laid out only when their contents change
+    TextCache nameEntryText;
+    TextCache leaderboardText;
+    int shownScore = -1;
+    int shownLeaderboardRevision = -1;
+
+    // Shown over the HUD while the rewind key is held
+    TextCache rewindText;
+    int shownRewindTenths = -1;
     
     // Background
     BackgroundManager backgroundManager;
+    TextCache levelText;
+
+    // World geometry of the frame being drawn, culled and sorted before replay
+    DrawList drawList;
+
+    // Explosion debris and smoke, following the snapshot being drawn
+    ParticleSystem particles;
+    unsigned long particleTick = 0;
+    unsigned int particleRun = 0;
+    float particleDistance = 0.0f;
+
+    DebugOverlay debugOverlay;  // F3
+
+    std::unique_ptr<SpectatorServer> spectatorServer; // --broadcast
 };
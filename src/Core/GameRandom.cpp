@@ -0,0 +1,64 @@
+#include "GameRandom.h"
+
+namespace {
+    GameRandom::State shared = { { 1, 2, 3, 4 } };
+    thread_local GameRandom::State* bound = &shared;
+
+    uint32_t Rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    uint32_t Next() {
+        uint32_t* state = bound->words;
+        uint32_t result = Rotl(state[1] * 5, 7) * 9;
+        uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = Rotl(state[3], 11);
+        return result;
+    }
+
+    // Expands the seed so that nearby seeds give unrelated sequences
+    uint32_t SplitMix(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (uint32_t)((z ^ (z >> 31)) >> 32);
+    }
+}
+
+namespace GameRandom {
+    void Seed(uint32_t seed) {
+        uint64_t x = seed;
+        for (auto& s : bound->words) s = SplitMix(x);
+    }
+
+    int Range(int min, int max) {
+        if (min > max) {
+            int tmp = min;
+            min = max;
+            max = tmp;
+        }
+        uint64_t span = (uint64_t)((int64_t)max - min) + 1;
+        return (int)(min + (int64_t)(Next() % span));
+    }
+
+    State GetState() {
+        return *bound;
+    }
+
+    void SetState(const State& in) {
+        *bound = in;
+    }
+
+    ThreadBinding::ThreadBinding(State& state) : previous(bound) {
+        bound = &state;
+    }
+
+    ThreadBinding::~ThreadBinding() {
+        bound = previous;
+    }
+}
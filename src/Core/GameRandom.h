@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+// Gameplay random numbers. raylib's GetRandomValue() may be backed by the C
+// library's rand(), which differs between platforms; this generator
+// (xoshiro128**) gives the same sequence everywhere for a given seed.
+// Only the simulation thread draws from it once a run has started.
+//
+// Every thread shares one generator unless it binds its own, which is how
+// several simulations run side by side (--analyze).
+namespace GameRandom {
+    void Seed(uint32_t seed);
+    // Uniform integer in [min, max], like GetRandomValue()
+    int Range(int min, int max);
+
+    // The full generator state, for saving and restoring a run
+    struct State {
+        uint32_t words[4];
+    };
+    State GetState();
+    void SetState(const State& state);
+
+    // Points the calling thread at `state` for as long as it lives, then
+    // back at whatever it used before
+    class ThreadBinding {
+    public:
+        explicit ThreadBinding(State& state);
+        ~ThreadBinding();
+        ThreadBinding(const ThreadBinding&) = delete;
+        ThreadBinding& operator=(const ThreadBinding&) = delete;
+
+    private:
+        State* previous;
+    };
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Player input for one simulation tick. Sampled on the main thread (the
+// only thread allowed to poll raylib input) and handed to the simulation.
+struct InputFrame {
+    bool up = false;
+    bool left = false;
+    bool right = false;
+    bool shoot = false;     // Pressed since the previous tick
+    bool reset = false;     // Start a new run before this tick
+    bool rewind = false;    // Step back through recorded states instead of playing
+};
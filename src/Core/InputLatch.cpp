@@ -0,0 +1,39 @@
+#include "InputLatch.h"
+#include "raylib.h"
+
+namespace {
+    // Every key the game reacts to on press rather than while held
+    constexpr int TrackedKeys[] = { KEY_SPACE, KEY_R, KEY_ENTER, KEY_BACKSPACE, KEY_F3 };
+    constexpr int TrackedCount = sizeof(TrackedKeys) / sizeof(TrackedKeys[0]);
+
+    int IndexOf(int key) {
+        for (int i = 0; i < TrackedCount; i++) {
+            if (TrackedKeys[i] == key) return i;
+        }
+        return -1;
+    }
+}
+
+void InputLatch::Capture() {
+    for (int i = 0; i < TrackedCount; i++) {
+        if (IsKeyPressed(TrackedKeys[i])) pressed |= 1u << i;
+    }
+    for (int c = GetCharPressed(); c > 0; c = GetCharPressed()) {
+        if (charCount < MaxChars) chars[charCount++] = c;
+    }
+}
+
+bool InputLatch::Pressed(int key) const {
+    int index = IndexOf(key);
+    return index >= 0 && (pressed & (1u << index)) != 0;
+}
+
+int InputLatch::NextChar() {
+    return charRead < charCount ? chars[charRead++] : 0;
+}
+
+void InputLatch::Clear() {
+    pressed = 0;
+    charCount = 0;
+    charRead = 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// raylib derives IsKeyPressed() and GetCharPressed() from the latest
+// PollInputEvents() only. The main loop polls twice per frame (when the
+// frame is presented and again right before the simulation step), so key
+// presses and typed characters are latched after every poll and consumed
+// once per frame.
+class InputLatch {
+public:
+    // Call after every poll
+    void Capture();
+    bool Pressed(int key) const;
+    // Next typed character, 0 when none are left
+    int NextChar();
+    // Call once the frame has consumed its input
+    void Clear();
+
+private:
+    static constexpr int MaxChars = 32;
+
+    unsigned int pressed = 0;  // One bit per entry of the tracked key list
+    int chars[MaxChars] = {};
+    int charCount = 0;
+    int charRead = 0;
+};
@@ -0,0 +1,100 @@
+#include "InputLog.h"
+#include "ByteStream.h"
+#include "raylib.h"
+#include <cstdio>
+
+namespace {
+    constexpr uint32_t Magic = 0x31505248; // "HRP1"
+
+    enum InputBits : uint8_t { Up = 1, Left = 2, Right = 4, Shoot = 8, Reset = 16, Rewind = 32 };
+}
+
+void InputLog::Begin(uint32_t seed, int hashInterval, uint64_t initialHash) {
+    this->seed = seed;
+    this->hashInterval = hashInterval;
+    inputs.clear();
+    hashes.assign(1, initialHash);
+}
+
+bool InputLog::Add(const InputFrame& input) {
+    inputs.push_back((input.up ? Up : 0) | (input.left ? Left : 0) | (input.right ? Right : 0) |
+                     (input.shoot ? Shoot : 0) | (input.reset ? Reset : 0) | (input.rewind ? Rewind : 0));
+    return inputs.size() % hashInterval == 0;
+}
+
+void InputLog::AddHash(uint64_t hash) {
+    hashes.push_back(hash);
+}
+
+InputFrame InputLog::GetInput(long tick) const {
+    uint8_t bits = inputs[tick];
+    InputFrame input;
+    input.up = bits & Up;
+    input.left = bits & Left;
+    input.right = bits & Right;
+    input.shoot = bits & Shoot;
+    input.reset = bits & Reset;
+    input.rewind = bits & Rewind;
+    return input;
+}
+
+bool InputLog::GetHash(long ticks, uint64_t* hash) const {
+    if (ticks % hashInterval != 0 || ticks / hashInterval >= (long)hashes.size()) return false;
+    *hash = hashes[ticks / hashInterval];
+    return true;
+}
+
+bool InputLog::Save(const char* fileName) const {
+    std::vector<uint8_t> bytes;
+    ByteWriter writer(bytes);
+    writer.Put(Magic);
+    writer.Put(seed);
+    writer.Put((uint32_t)hashInterval);
+    writer.Put((uint32_t)inputs.size());
+    writer.Put((uint32_t)hashes.size());
+    writer.PutBytes(inputs.data(), inputs.size());
+    writer.PutBytes(hashes.data(), hashes.size() * sizeof(uint64_t));
+
+    FILE* file = fopen(fileName, "wb");
+    bool ok = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (file && fclose(file) != 0) ok = false;
+    if (ok) TraceLog(LOG_INFO, "REPLAY: Wrote %lu ticks to %s", (unsigned long)inputs.size(), fileName);
+    else TraceLog(LOG_WARNING, "REPLAY: Could not write %s", fileName);
+    return ok;
+}
+
+bool InputLog::Load(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "REPLAY: Could not open %s", fileName);
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[1 << 16];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) bytes.insert(bytes.end(), buffer, buffer + read);
+    fclose(file);
+
+    if (!Parse(bytes.data(), bytes.size())) {
+        TraceLog(LOG_WARNING, "REPLAY: %s is not an input log", fileName);
+        return false;
+    }
+    return true;
+}
+
+bool InputLog::Parse(const uint8_t* data, size_t size) {
+    ByteReader reader(data, size);
+    bool ok = reader.Get<uint32_t>() == Magic;
+    seed = reader.Get<uint32_t>();
+    hashInterval = (int)reader.Get<uint32_t>();
+    uint32_t tickCount = reader.Get<uint32_t>();
+    uint32_t hashCount = reader.Get<uint32_t>();
+    const uint8_t* inputBytes = reader.GetBytes(tickCount);
+    const uint8_t* hashBytes = reader.GetBytes((size_t)hashCount * sizeof(uint64_t));
+    if (!ok || !reader.Ok() || hashInterval <= 0) return false;
+
+    inputs.assign(inputBytes, inputBytes + tickCount);
+    hashes.resize(hashCount);
+    memcpy(hashes.data(), hashBytes, hashes.size() * sizeof(uint64_t));
+    return true;
+}
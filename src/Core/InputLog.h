@@ -0,0 +1,38 @@
+#pragma once
+#include "InputFrame.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A session's inputs, one byte per tick, plus StateSerializer::Hash() of the
+// simulation every few ticks. Replaying the inputs from the seed reproduces
+// the session (the simulation draws only from GameRandom); the hashes show
+// where another build stops agreeing with the one that recorded it.
+class InputLog {
+public:
+    // `initialHash` is the state before the first tick
+    void Begin(uint32_t seed, int hashInterval, uint64_t initialHash);
+    // Appends one tick's input. Returns true when the state after it should
+    // be hashed and passed to AddHash().
+    bool Add(const InputFrame& input);
+    void AddHash(uint64_t hash);
+
+    bool Save(const char* fileName) const;
+    bool Load(const char* fileName);
+    // Reads a log from the bytes of a file already in memory
+    bool Parse(const uint8_t* data, size_t size);
+
+    uint32_t GetSeed() const { return seed; }
+    int GetHashInterval() const { return hashInterval; }
+    long GetTickCount() const { return (long)inputs.size(); }
+    // Input of the tick with 0-based index `tick`
+    InputFrame GetInput(long tick) const;
+    // The hash recorded after `ticks` ticks, if one was
+    bool GetHash(long ticks, uint64_t* hash) const;
+
+private:
+    uint32_t seed = 0;
+    int hashInterval = 1;
+    std::vector<uint8_t> inputs;
+    std::vector<uint64_t> hashes;   // hashes[i]: after i * hashInterval ticks
+};
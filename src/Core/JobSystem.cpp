@@ -0,0 +1,171 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Job {
+        std::function<void()> fn;
+        std::atomic<int>* pending;
+    };
+
+    struct JobQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // queues[0..workers-1] belong to the workers, the last one is shared by
+    // every other thread
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{0};
+    std::atomic<bool> stopping{false};
+
+    thread_local int workerIndex = -1;
+
+    JobQueue& OwnQueue() {
+        return workerIndex >= 0 ? *queues[workerIndex] : *queues.back();
+    }
+
+    void Push(Job job) {
+        JobQueue& queue = OwnQueue();
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        queued.fetch_add(1);
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+
+    bool TryPop(Job& out) {
+        const int count = (int)queues.size();
+        const int self = workerIndex >= 0 ? workerIndex : count - 1;
+
+        // Newest job from our own queue is the one most likely still in cache
+        {
+            JobQueue& queue = *queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                out = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // Steal the oldest job from someone else
+        for (int i = 1; i < count; i++) {
+            JobQueue& queue = *queues[(self + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                out = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Execute(Job& job) {
+        job.fn();
+        job.pending->fetch_sub(1, std::memory_order_release);
+    }
+
+    void WorkerLoop(int index) {
+        workerIndex = index;
+        Job job;
+        while (!stopping.load()) {
+            if (TryPop(job)) {
+                Execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [] { return stopping.load() || queued.load() > 0; });
+        }
+    }
+}
+
+namespace Jobs {
+    void Start(int workerCount) {
+        Stop();
+        workerCount = std::max(workerCount, 0);
+
+        queues.clear();
+        for (int i = 0; i <= workerCount; i++) queues.push_back(std::make_unique<JobQueue>());
+
+        stopping = false;
+        for (int i = 0; i < workerCount; i++) workers.emplace_back(WorkerLoop, i);
+    }
+
+    void Stop() {
+        if (workers.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    int GetWorkerCount() {
+        return (int)workers.size();
+    }
+
+    int DefaultWorkerCount() {
+        int cores = (int)std::thread::hardware_concurrency();
+        return std::max(cores - 1, 0);
+    }
+
+    void TaskGroup::Run(std::function<void()> job) {
+        if (workers.empty()) {
+            job();
+            return;
+        }
+        pending.fetch_add(1, std::memory_order_relaxed);
+        Push(Job{std::move(job), &pending});
+    }
+
+    void TaskGroup::Wait() {
+        Job job;
+        while (pending.load(std::memory_order_acquire) > 0) {
+            // Help out instead of blocking; the job may belong to another group
+            if (TryPop(job)) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+        if (count <= 0) return;
+        grain = std::max(grain, 1);
+
+        const int threads = (int)workers.size() + 1;
+        if (threads == 1 || count <= grain) {
+            fn(0, count);
+            return;
+        }
+
+        // A few chunks per thread so stealing can even out uneven work
+        int chunks = std::min((count + grain - 1) / grain, threads * 4);
+        int chunkSize = (count + chunks - 1) / chunks;
+
+        TaskGroup group;
+        for (int begin = chunkSize; begin < count; begin += chunkSize) {
+            int end = std::min(begin + chunkSize, count);
+            group.Run([&fn, begin, end] { fn(begin, end); });
+        }
+        fn(0, std::min(chunkSize, count));
+        group.Wait();
+    }
+}
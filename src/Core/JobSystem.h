@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <functional>
+
+// Small work-stealing thread pool. Each worker owns a deque: it pops its own
+// jobs LIFO and steals from the others FIFO when it runs dry. Threads that are
+// not workers (main, simulation) submit through a shared queue and help run
+// jobs while they wait, so the pool can be used from several threads at once.
+//
+// Jobs only compute; anything order-dependent (spawning, sounds, drawing) is
+// applied by the caller afterwards in index order, which keeps results
+// identical for any worker count.
+namespace Jobs {
+    // Starts `workerCount` threads; 0 runs every job inline on the caller.
+    // Restarting with a different count is allowed while no jobs are in flight.
+    void Start(int workerCount);
+    void Stop();
+    int GetWorkerCount();
+    // hardware_concurrency() - 1, leaving a core for the submitting thread
+    int DefaultWorkerCount();
+
+    // A set of jobs that can be waited on together
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        ~TaskGroup() { Wait(); }
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        // `job` must stay valid until Wait() returns
+        void Run(std::function<void()> job);
+        // Runs queued jobs on the calling thread until the group is done
+        void Wait();
+
+    private:
+        std::atomic<int> pending{0};
+    };
+
+    // Calls fn(begin, end) over [0, count) in chunks of at least `grain`
+    // items. Small ranges run inline without touching the pool.
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+}
@@ -0,0 +1,49 @@
+#include "LatencyTracker.h"
+#include "raylib.h"
+#include <algorithm>
+
+void LatencyTracker::Histogram::Add(double ms) {
+    int bin = std::clamp((int)(ms / BinMs), 0, Bins - 1);
+    bins[bin]++;
+    count++;
+    max = std::max(max, ms);
+}
+
+double LatencyTracker::Histogram::Percentile(double p) const {
+    if (count == 0) return 0.0;
+    uint64_t target = (uint64_t)(p / 100.0 * (double)(count - 1));
+    uint64_t seen = 0;
+    for (int i = 0; i < Bins; i++) {
+        seen += bins[i];
+        if (seen > target) return (i + 0.5) * BinMs;
+    }
+    return max;
+}
+
+void LatencyTracker::InputSampled(unsigned long tick, double time) {
+    pending[tick % PendingSamples] = { tick, time };
+}
+
+double LatencyTracker::Presented(unsigned long tick, double time) {
+    if (tick <= lastPresented) return -1.0;
+    lastPresented = tick;
+
+    const Sample& sample = pending[tick % PendingSamples];
+    if (sample.tick != tick) return -1.0;
+
+    double ms = (time - sample.time) * 1000.0;
+    latency.Add(ms);
+    return ms;
+}
+
+void LatencyTracker::Log(const char* prefix) const {
+    if (latency.Count() > 0) {
+        TraceLog(LOG_INFO, "%s: Input to present p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms (%llu frames)", prefix,
+                 latency.Percentile(50), latency.Percentile(90), latency.Percentile(99), latency.Max(),
+                 (unsigned long long)latency.Count());
+    }
+    if (pacing.Count() > 0) {
+        TraceLog(LOG_INFO, "%s: Pacing error p50 %.3f ms, p99 %.3f ms, max %.3f ms", prefix,
+                 pacing.Percentile(50), pacing.Percentile(99), pacing.Max());
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+// Input-to-present latency: from the moment a tick's input is sampled to the
+// end of the first frame that shows that tick. With the pipelined simulation
+// that is the frame after the one that sampled it. Also keeps the frame
+// pacer's wake-up error. Whole-run percentiles are logged at exit.
+class LatencyTracker {
+public:
+    // Fixed 0.05 ms bins up to 200 ms; anything slower lands in the last bin
+    class Histogram {
+    public:
+        void Add(double ms);
+        double Percentile(double p) const;
+        double Max() const { return max; }
+        uint64_t Count() const { return count; }
+
+    private:
+        static constexpr double BinMs = 0.05;
+        static constexpr int Bins = 4000;
+        uint32_t bins[Bins] = {};
+        uint64_t count = 0;
+        double max = 0.0;
+    };
+
+    void InputSampled(unsigned long tick, double time);
+    // Returns the latency in ms, or a negative value if `tick` was already
+    // presented or its sample time is unknown
+    double Presented(unsigned long tick, double time);
+    void AddPacingError(double seconds) { pacing.Add(seconds * 1000.0); }
+
+    void Log(const char* prefix) const;
+
+private:
+    struct Sample {
+        unsigned long tick = 0;
+        double time = 0.0;
+    };
+    static constexpr int PendingSamples = 8; // Ticks in flight between sampling and presenting
+
+    Sample pending[PendingSamples];
+    unsigned long lastPresented = 0;
+    Histogram latency;
+    Histogram pacing;
+};
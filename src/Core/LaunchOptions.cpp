@@ -0,0 +1,77 @@
+#include "LaunchOptions.h"
+#include "Constants.h"
+#include "raylib.h"
+#include <cstdlib>
+#include <cstring>
+
+LaunchOptions LaunchOptions::Parse(int argc, char** argv) {
+    LaunchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--render-scale=", 15) == 0) {
+            options.renderScale = (float)atof(arg + 15);
+        } else if (strcmp(arg, "--auto-render-scale") == 0) {
+            options.autoRenderScale = true;
+        } else if (strcmp(arg, "--serial") == 0) {
+            options.serial = true;
+        } else if (strncmp(arg, "--jobs=", 7) == 0) {
+            options.jobs = atoi(arg + 7);
+        } else if (strcmp(arg, "--bench-jobs") == 0) {
+            options.benchJobs = true;
+        } else if (strcmp(arg, "--bench-particles") == 0) {
+            options.benchParticles = true;
+        } else if (strcmp(arg, "--bench-post") == 0) {
+            options.benchPost = true;
+        } else if (strcmp(arg, "--cpu-post") == 0) {
+            options.cpuPost = true;
+        } else if (strncmp(arg, "--record=", 9) == 0) {
+            options.recordFile = arg + 9;
+        } else if (strncmp(arg, "--record-inputs=", 16) == 0) {
+            options.inputLogFile = arg + 16;
+        } else if (strncmp(arg, "--replay=", 9) == 0) {
+            options.replayFile = arg + 9;
+        } else if (strncmp(arg, "--hash-every=", 13) == 0) {
+            options.hashEvery = atol(arg + 13);
+        } else if (strncmp(arg, "--stop-at=", 10) == 0) {
+            options.stopAt = atol(arg + 10);
+        } else if (strncmp(arg, "--dump-state=", 13) == 0) {
+            options.dumpFile = arg + 13;
+        } else if (strncmp(arg, "--bisect=", 9) == 0) {
+            options.bisectFile = arg + 9;
+        } else if (strncmp(arg, "--against=", 10) == 0) {
+            options.againstExe = arg + 10;
+        } else if (strncmp(arg, "--analyze=", 10) == 0) {
+            options.analyzeDir = arg + 10;
+        } else if (strncmp(arg, "--analyze-out=", 14) == 0) {
+            options.analyzeOut = arg + 14;
+        } else if (strcmp(arg, "--soak") == 0) {
+            options.soakTicks = Constants::Soak::DefaultTicks;
+        } else if (strncmp(arg, "--soak=", 7) == 0) {
+            options.soakTicks = atol(arg + 7);
+        } else if (strcmp(arg, "--broadcast") == 0) {
+            options.broadcastPort = Constants::Spectator::DefaultPort;
+        } else if (strncmp(arg, "--broadcast=", 12) == 0) {
+            options.broadcastPort = atoi(arg + 12);
+        } else if (strcmp(arg, "--spectate") == 0) {
+            options.spectatePort = Constants::Spectator::DefaultPort;
+        } else if (strncmp(arg, "--spectate=", 11) == 0) {
+            options.spectatePort = atoi(arg + 11);
+        } else if (strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (strncmp(arg, "--frames=", 9) == 0) {
+            options.frames = atoi(arg + 9);
+        } else if (strncmp(arg, "--dump-frames=", 14) == 0) {
+            options.dumpDir = arg + 14;
+        } else if (strncmp(arg, "--golden=", 9) == 0) {
+            options.goldenDir = arg + 9;
+        } else if (strncmp(arg, "--seed=", 7) == 0) {
+            options.hasSeed = true;
+            options.seed = (unsigned int)strtoul(arg + 7, nullptr, 10);
+        } else {
+            TraceLog(LOG_WARNING, "OPTIONS: Unknown argument '%s'", arg);
+        }
+    }
+
+    return options;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+
+// Settings taken from the command line
+struct LaunchOptions {
+    float renderScale = 1.0f;       // --render-scale=<0.5..1.0>
+    bool autoRenderScale = false;   // --auto-render-scale
+    bool serial = false;            // --serial: tick the simulation on the main thread
+    int jobs = -1;                  // --jobs=<n>: job system workers, -1 = one per spare core
+    bool benchJobs = false;         // --bench-jobs: report job system scaling and exit
+    bool benchParticles = false;    // --bench-particles: time the particle update and exit
+    bool benchPost = false;         // --bench-post: check and time the CPU cavern grade and exit
+    bool cpuPost = false;           // --cpu-post: grade the scene on the CPU instead of the shader
+    std::string recordFile;         // --record=<file.y4m>: capture the scene as raw video
+    std::string inputLogFile;       // --record-inputs=<file>: save every tick's input and periodic state hashes
+
+    // Replaying an input log without a window (see Replay.h)
+    std::string replayFile;         // --replay=<file>; with --headless, the input of the rendered frames
+    long hashEvery = 0;             // --hash-every=<n>: print the state hash every n ticks
+    long stopAt = -1;               // --stop-at=<tick>: replay only this many ticks
+    std::string dumpFile;           // --dump-state=<file>: write the final state as text
+    std::string bisectFile;         // --bisect=<file>: find the first tick where two builds differ
+    std::string againstExe;         // --against=<executable>: the other build for --bisect
+    std::string analyzeDir;         // --analyze=<dir>: aggregate statistics over every input log in dir
+    std::string analyzeOut = "analysis.han"; // --analyze-out=<file>
+    long soakTicks = 0;             // --soak[=<ticks>]: random-input endurance run, 0 = off
+
+    // Spectating over loopback TCP; 0 = off
+    int broadcastPort = 0;          // --broadcast[=<port>]: publish every tick to viewers
+    int spectatePort = 0;           // --spectate[=<port>]: watch a broadcast instead of playing
+
+    // Headless mode renders with the software rasterizer and opens no window
+    bool headless = false;          // --headless
+    int frames = 600;               // --frames=<n>
+    std::string dumpDir;            // --dump-frames=<dir>: write every frame as PPM
+    std::string goldenDir;          // --golden=<dir>: compare every frame against PPMs
+
+    bool hasSeed = false;
+    unsigned int seed = 0;          // --seed=<n>, otherwise seeded from the clock
+
+    static LaunchOptions Parse(int argc, char** argv);
+};
@@ -2,11 +2,11 @@
 #include <iostream>
 
 LeaderboardManager::LeaderboardManager(const std::string& filename) : filename(filename) {
-    Load();
 }
 
 void LeaderboardManager::Load() {
     entries.clear();
+    revision++;
     std::ifstream file(filename);
     if (!file.is_open()) return;
 
@@ -55,6 +55,7 @@ void LeaderboardManager::AddEntry(const std::string& name, int score) {
     if (entries.size() > MaxEntries) {
         entries.resize(MaxEntries);
     }
+    revision++;
     Save();
 }
 
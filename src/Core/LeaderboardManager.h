@@ -14,14 +14,18 @@ class LeaderboardManager {
 public:
     LeaderboardManager(const std::string& filename = "leaderboard.csv");
     
+    // Not called by the constructor so the file read can run off the main thread
     void Load();
     void Save();
     bool IsHighScore(int score) const;
     void AddEntry(const std::string& name, int score);
     const std::vector<LeaderboardEntry>& GetEntries() const;
+    // Bumped whenever the entries change, so views can cache their layout
+    int GetRevision() const { return revision; }
 
 private:
     std::string filename;
     std::vector<LeaderboardEntry> entries;
     const size_t MaxEntries = 5;
+    int revision = 0;
 };
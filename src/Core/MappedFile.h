@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// A whole file mapped read-only into memory. Kept free of raylib so the
+// platform headers (windows.h on Windows) never meet raylib.h.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file can't be opened or mapped; empty files map to no data
+    bool Open(const char* fileName);
+    void Close();
+
+    const uint8_t* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "raylib.h"
+
+// A hit the renderer should decorate with particles. The simulation only
+// records where and what happened; the particles themselves never touch
+// gameplay and are not part of the simulated state.
+struct ParticleBurst {
+    enum class Kind : unsigned char {
+        MissileKill,  // Missile shot down or flown into the terrain
+        WallBreak,    // Weak spot destroyed
+        RockHit,      // Rock shot
+        Impact        // Projectile hitting the terrain
+    };
+
+    Vector2 position;
+    Kind kind;
+};
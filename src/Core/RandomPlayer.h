@@ -0,0 +1,31 @@
+#pragma once
+#include "InputFrame.h"
+#include <random>
+
+// Plays without a person at the keys: held keys change every few ticks, the
+// way a player's would, and shots come at random. Draws from its own
+// generator, so the simulation's random numbers stay as they were.
+class RandomPlayer {
+public:
+    RandomPlayer() = default;
+    explicit RandomPlayer(unsigned int seed) : rng(seed) {}
+
+    InputFrame Next() {
+        if (--holdTicks <= 0) {
+            holdTicks = Uniform(5, 40);
+            held.up = Uniform(0, 99) < 55;
+            held.left = Uniform(0, 99) < 20;
+            held.right = !held.left && Uniform(0, 99) < 20;
+        }
+        InputFrame input = held;
+        input.shoot = Uniform(0, 19) == 0;
+        return input;
+    }
+
+    int Uniform(int min, int max) { return std::uniform_int_distribution<int>(min, max)(rng); }
+
+private:
+    std::mt19937 rng;
+    InputFrame held;
+    int holdTicks = 0;
+};
@@ -0,0 +1,174 @@
+#include "Replay.h"
+#include "InputLog.h"
+#include "Simulation.h"
+#include "StateSerializer.h"
+#include "AudioManager.h"
+#include "GameRandom.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace {
+    // A fresh simulation following a log, set up the way Game::Init does
+    class Replayer {
+    public:
+        explicit Replayer(const InputLog& log) : log(log), simulation(audio) {
+            GameRandom::Seed(log.GetSeed());
+            simulation.GetLevel().Init();
+            simulation.Init();
+        }
+
+        void RunTo(long ticks) {
+            while (done < ticks) simulation.Tick(log.GetInput(done++));
+        }
+
+        long GetTicks() const { return done; }
+        uint64_t Hash() const { return simulation.GetStateHash(); }
+        bool Dump(const char* fileName) const {
+            FILE* file = fopen(fileName, "w");
+            if (!file) {
+                TraceLog(LOG_WARNING, "REPLAY: Could not write %s", fileName);
+                return false;
+            }
+            fprintf(file, "after tick %ld\n", done);
+            StateSerializer::Dump(simulation, file);
+            fclose(file);
+            return true;
+        }
+
+    private:
+        const InputLog& log;
+        AudioManager audio; // Never opened
+        Simulation simulation;
+        long done = 0;
+    };
+
+    void PrintHash(long ticks, uint64_t hash) {
+        printf("HASH %ld %016" PRIx64 "\n", ticks, hash);
+    }
+
+    // Runs the other build and collects the hashes it prints, by tick
+    bool RunOther(const std::string& arguments, std::map<long, uint64_t>& hashes) {
+        FILE* pipe = popen(arguments.c_str(), "r");
+        if (!pipe) return false;
+        char line[256];
+        long ticks;
+        uint64_t hash;
+        while (fgets(line, sizeof(line), pipe)) {
+            if (sscanf(line, "HASH %ld %" SCNx64, &ticks, &hash) == 2) hashes[ticks] = hash;
+        }
+        pclose(pipe);
+        return !hashes.empty();
+    }
+
+    std::string Quote(const std::string& text) {
+        return "\"" + text + "\"";
+    }
+}
+
+namespace Replay {
+    int Run(const char* fileName, long hashEvery, long stopAt, const char* dumpFile) {
+        InputLog log;
+        if (!log.Load(fileName)) return 2;
+
+        long end = stopAt >= 0 ? std::min(stopAt, log.GetTickCount()) : log.GetTickCount();
+        Replayer replayer(log);
+        long checked = 0;
+        long firstMismatch = -1;
+        for (long ticks = 0; ; ticks++) {
+            uint64_t recorded;
+            bool hasRecorded = log.GetHash(ticks, &recorded);
+            bool print = ticks == end || (hashEvery > 0 && ticks % hashEvery == 0);
+            if (hasRecorded || print) {
+                uint64_t hash = replayer.Hash();
+                if (print) PrintHash(ticks, hash);
+                if (hasRecorded) {
+                    checked++;
+                    if (hash != recorded && firstMismatch < 0) firstMismatch = ticks;
+                }
+            }
+            if (ticks == end) break;
+            replayer.RunTo(ticks + 1);
+        }
+        if (dumpFile && *dumpFile) replayer.Dump(dumpFile);
+
+        if (firstMismatch >= 0) {
+            TraceLog(LOG_WARNING, "REPLAY: State differs from the recording after tick %ld (last match %ld ticks earlier)",
+                     firstMismatch, (long)log.GetHashInterval());
+            return 1;
+        }
+        TraceLog(LOG_INFO, "REPLAY: %ld ticks, %ld recorded hashes match", end, checked);
+        return 0;
+    }
+
+    int Bisect(const char* fileName, const char* otherExecutable) {
+        if (!*otherExecutable) {
+            TraceLog(LOG_WARNING, "BISECT: Name the other build with --against=<executable>");
+            return 2;
+        }
+        InputLog log;
+        if (!log.Load(fileName)) return 2;
+        const std::string other = Quote(otherExecutable) + " --replay=" + Quote(fileName);
+        const long interval = log.GetHashInterval();
+
+        // Coarse pass: both builds over the whole log, hashing at the log's interval
+        std::map<long, uint64_t> theirs;
+        if (!RunOther(other + " --hash-every=" + std::to_string(interval), theirs)) {
+            TraceLog(LOG_WARNING, "BISECT: No hashes from %s", otherExecutable);
+            return 2;
+        }
+        Replayer coarse(log);
+        long good = -1, bad = -1;
+        for (const auto& [ticks, hash] : theirs) {
+            coarse.RunTo(ticks);
+            if (coarse.Hash() != hash) {
+                bad = ticks;
+                break;
+            }
+            good = ticks;
+        }
+        if (bad < 0) {
+            TraceLog(LOG_INFO, "BISECT: Builds agree over all %ld ticks", log.GetTickCount());
+            return 0;
+        }
+        if (good < 0) {
+            TraceLog(LOG_WARNING, "BISECT: Builds differ before the first tick");
+        }
+
+        // Each probe replays both builds from the start up to the middle tick
+        int probes = 0;
+        while (bad - good > 1) {
+            long middle = good + (bad - good) / 2;
+            std::map<long, uint64_t> probe;
+            if (!RunOther(other + " --stop-at=" + std::to_string(middle), probe) || !probe.count(middle)) {
+                TraceLog(LOG_WARNING, "BISECT: %s did not report tick %ld", otherExecutable, middle);
+                return 2;
+            }
+            Replayer replayer(log);
+            replayer.RunTo(middle);
+            if (replayer.Hash() == probe[middle]) good = middle;
+            else bad = middle;
+            probes++;
+        }
+
+        std::string ours = std::string(fileName) + "." + std::to_string(bad) + ".this.txt";
+        std::string their = std::string(fileName) + "." + std::to_string(bad) + ".other.txt";
+        Replayer replayer(log);
+        replayer.RunTo(bad);
+        replayer.Dump(ours.c_str());
+        std::map<long, uint64_t> ignored;
+        RunOther(other + " --stop-at=" + std::to_string(bad) + " --dump-state=" + Quote(their), ignored);
+
+        TraceLog(LOG_WARNING, "BISECT: States first differ after tick %ld (%d probes); dumps in %s and %s",
+                 bad, probes, ours.c_str(), their.c_str());
+        return 1;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Re-running sessions saved with --record-inputs, without a window.
+//
+// --replay plays an input log through this build, prints "HASH <ticks>
+// <hash>" lines for other tools to read and checks the hashes recorded in
+// the log. --bisect runs the same log through this build and another
+// executable, compares their hash streams and narrows the first difference
+// down to a single tick by binary search, then dumps both states there.
+// The search assumes that once the states differ they keep differing,
+// which holds for everything the hash covers except short-lived entities.
+namespace Replay {
+    // Prints a hash every `hashEvery` ticks (0 = only after the last one).
+    // Stops after `stopAt` ticks if >= 0; `dumpFile` (or null) then gets a
+    // StateSerializer::Dump() of the final state. Returns the process exit
+    // code: 1 if a recorded hash differs, 2 if the log can't be read.
+    int Run(const char* fileName, long hashEvery, long stopAt, const char* dumpFile);
+    // Returns 0 if the builds agree over the whole log, 1 if they differ
+    int Bisect(const char* fileName, const char* otherExecutable);
+}
@@ -0,0 +1,185 @@
+#include "RewindBuffer.h"
+#include "StateSerializer.h"
+#include "Simulation.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // Delta stream: tokens of u16 unchanged bytes to skip, u16 changed bytes,
+    // then the changed bytes XORed. Short unchanged gaps inside a changed
+    // stretch are cheaper to carry along than to end the token for.
+    constexpr size_t MinSkip = 4;
+    constexpr size_t MaxRun = 0xFFFF;
+
+    void PutToken(std::vector<uint8_t>& out, size_t skip, const uint8_t* older, const uint8_t* newer, size_t changed) {
+        while (skip > MaxRun) {
+            PutToken(out, MaxRun, nullptr, nullptr, 0);
+            skip -= MaxRun;
+        }
+        do {
+            size_t run = std::min(changed, MaxRun);
+            uint16_t header[2] = { (uint16_t)skip, (uint16_t)run };
+            size_t at = out.size();
+            out.resize(at + sizeof(header) + run);
+            memcpy(out.data() + at, header, sizeof(header));
+            uint8_t* bytes = out.data() + at + sizeof(header);
+            for (size_t i = 0; i < run; i++) bytes[i] = older[i] ^ newer[i];
+            older += run;
+            newer += run;
+            changed -= run;
+            skip = 0;
+        } while (changed > 0);
+    }
+
+    // Both buffers hold `size` bytes
+    void Encode(const uint8_t* older, const uint8_t* newer, size_t size, std::vector<uint8_t>& out) {
+        size_t i = 0;
+        while (i < size) {
+            size_t start = i;
+            for (uint64_t a, b; i + 8 <= size; i += 8) {
+                memcpy(&a, older + i, 8);
+                memcpy(&b, newer + i, 8);
+                if (a != b) break;
+            }
+            while (i < size && older[i] == newer[i]) i++;
+            if (i == size) break; // Unchanged to the end
+
+            size_t changedStart = i;
+            while (i < size) {
+                if (older[i] != newer[i]) {
+                    i++;
+                    continue;
+                }
+                size_t same = 0;
+                while (i + same < size && older[i + same] == newer[i + same] && same < MinSkip) same++;
+                if (same >= MinSkip || i + same == size) break;
+                i += same;
+            }
+            PutToken(out, changedStart - start, older + changedStart, newer + changedStart, i - changedStart);
+        }
+    }
+
+    // XORs the delta into `image`; false if it does not fit
+    bool Decode(const uint8_t* data, size_t size, std::vector<uint8_t>& image) {
+        size_t at = 0;
+        size_t position = 0;
+        while (at + 4 <= size) {
+            uint16_t header[2];
+            memcpy(header, data + at, sizeof(header));
+            at += sizeof(header);
+            position += header[0];
+            if (at + header[1] > size || position + header[1] > image.size()) return false;
+            for (size_t i = 0; i < header[1]; i++) image[position + i] ^= data[at + i];
+            at += header[1];
+            position += header[1];
+        }
+        return at == size;
+    }
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+RewindBuffer::RewindBuffer() : ring(RewindConst::RingBytes), entries(RewindConst::MaxEntries) {}
+
+void RewindBuffer::Clear() {
+    first = 0;
+    count = 0;
+    writeOffset = 0;
+    hasNewest = false;
+    newestLoaded = false;
+}
+
+void RewindBuffer::DropOldest(int n) {
+    first = (first + n) % RewindConst::MaxEntries;
+    count -= n;
+}
+
+size_t RewindBuffer::Allocate(size_t size) {
+    if (writeOffset + size > ring.size()) writeOffset = 0;
+    const size_t begin = writeOffset;
+    const size_t end = begin + size;
+
+    // Older states are only reachable through newer deltas, so overwriting
+    // an entry loses everything before it too
+    int lost = 0;
+    for (int i = 0; i < count; i++) {
+        const Entry& e = At(i);
+        if (e.offset < end && begin < e.offset + e.size) lost = i + 1;
+    }
+    DropOldest(lost);
+
+    writeOffset = end;
+    return begin;
+}
+
+void RewindBuffer::Record(const Simulation& simulation) {
+    auto start = std::chrono::steady_clock::now();
+    StateSerializer::Save(simulation, scratch);
+
+    if (hasNewest) {
+        const size_t newLength = scratch.size();
+        const uint32_t olderLength = (uint32_t)newest.size();
+        const size_t size = std::max(newest.size(), scratch.size());
+        newest.resize(size, 0);
+        scratch.resize(size, 0);
+
+        encoded.clear();
+        Encode(newest.data(), scratch.data(), size, encoded);
+        encodedBytes += encoded.size();
+
+        if (encoded.size() > ring.size() / 4) {
+            // Cannot happen with capped entity counts; keep the ring usable regardless
+            count = 0;
+        } else {
+            if (count == RewindConst::MaxEntries) DropOldest(1);
+            size_t offset = Allocate(encoded.size());
+            memcpy(ring.data() + offset, encoded.data(), encoded.size());
+            At(count++) = { offset, (uint32_t)encoded.size(), olderLength };
+        }
+        scratch.resize(newLength);
+    }
+    newest.swap(scratch);
+    hasNewest = true;
+    newestLoaded = false;
+
+    double ms = MillisecondsSince(start);
+    worstRecordMs = std::max(worstRecordMs, ms);
+    totalRecordMs += ms;
+    records++;
+}
+
+bool RewindBuffer::Restore(Simulation& simulation) {
+    if (!hasNewest || (newestLoaded && count == 0)) return false;
+    auto start = std::chrono::steady_clock::now();
+
+    // The simulation already holds the newest state; go one step further back
+    if (newestLoaded) {
+        const Entry e = At(count - 1);
+        newest.resize(std::max(newest.size(), (size_t)e.olderLength), 0);
+        if (!Decode(ring.data() + e.offset, e.size, newest)) count = 1; // Corrupt; nothing older is usable
+        newest.resize(e.olderLength);
+        count--;
+        writeOffset = e.offset; // It was the last thing written
+    }
+
+    bool loaded = StateSerializer::Load(simulation, newest.data(), newest.size());
+    newestLoaded = true;
+
+    worstRestoreMs = std::max(worstRestoreMs, MillisecondsSince(start));
+    restores++;
+    return loaded;
+}
+
+void RewindBuffer::Log(const char* prefix) const {
+    if (records == 0) return;
+    TraceLog(LOG_INFO, "%s: %lu states recorded, mean %.1f us, worst %.1f us, %.0f bytes per delta",
+             prefix, records, totalRecordMs * 1000.0 / records, worstRecordMs * 1000.0,
+             records > 1 ? (double)encodedBytes / (records - 1) : 0.0);
+    if (restores > 0) {
+        TraceLog(LOG_INFO, "%s: %lu states restored, worst %.1f us", prefix, restores, worstRestoreMs * 1000.0);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "Constants.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulation;
+
+// The last few seconds of a run, for rewinding. Every recorded state is a
+// StateSerializer image; only the newest is kept whole. Each older one is
+// stored as its XOR against the state recorded after it, with the runs of
+// zero bytes (everything that did not change) squeezed out, in a byte ring
+// of fixed size. Stepping back decodes one delta onto the newest image, so
+// scrubbing costs the same however far back it goes. When the ring or the
+// entry table is full the oldest states are dropped.
+class RewindBuffer {
+public:
+    RewindBuffer();
+
+    void Clear();
+    // Appends the simulation's current state
+    void Record(const Simulation& simulation);
+    // Loads the newest recorded state into `simulation`. It stays the newest
+    // state, so play resumed from it is recorded against it; a following
+    // call first steps back to the state before it. Returns false if nothing
+    // is left. The collision mask is left stale (see StateSerializer::Load).
+    bool Restore(Simulation& simulation);
+    // The simulation played on from the state Restore() loaded last; the
+    // next Restore() lands on that state again
+    void Resume() { newestLoaded = false; }
+
+    // Number of states Restore() can still go back through
+    int GetDepth() const { return hasNewest ? count + (newestLoaded ? 0 : 1) : 0; }
+    float GetSeconds() const { return GetDepth() * Constants::Rewind::Interval * Constants::TickTime; }
+
+    // Slowest Record() and Restore() so far, for the exit log
+    void Log(const char* prefix) const;
+
+private:
+    using RewindConst = Constants::Rewind;
+
+    struct Entry {
+        size_t offset;          // Into ring
+        uint32_t size;          // Encoded bytes
+        uint32_t olderLength;   // Length of the image it decodes to
+    };
+
+    std::vector<uint8_t> ring;
+    size_t writeOffset = 0;
+
+    // Circular table, oldest first
+    std::vector<Entry> entries;
+    int first = 0;
+    int count = 0;
+
+    std::vector<uint8_t> newest;    // Image of the newest state
+    bool hasNewest = false;
+    bool newestLoaded = false;      // Restore() put `newest` into the simulation
+    std::vector<uint8_t> scratch;   // Image being recorded
+    std::vector<uint8_t> encoded;
+
+    double worstRecordMs = 0.0;
+    double worstRestoreMs = 0.0;
+    double totalRecordMs = 0.0;
+    unsigned long records = 0;
+    unsigned long restores = 0;
+    uint64_t encodedBytes = 0;
+
+    Entry& At(int index) { return entries[(first + index) % RewindConst::MaxEntries]; }
+    void DropOldest(int n);
+    // Makes room for `size` bytes and returns where they go
+    size_t Allocate(size_t size);
+};
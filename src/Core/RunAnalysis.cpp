@@ -0,0 +1,252 @@
+#include "RunAnalysis.h"
+#include "InputLog.h"
+#include "MappedFile.h"
+#include "Simulation.h"
+#include "AudioManager.h"
+#include "GameRandom.h"
+#include "JobSystem.h"
+#include "ByteStream.h"
+#include "Constants.h"
+#include "raylib.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+using AnalysisConst = Constants::Analysis;
+
+namespace {
+    constexpr int Buckets = AnalysisConst::MaxBuckets;
+    constexpr int Causes = (int)DeathCause::Count;
+
+    struct Totals {
+        uint64_t reached[Buckets] = {};             // Runs that got into the bucket
+        uint64_t deaths[Buckets][Causes] = {};
+        uint64_t flightTicks[Buckets] = {};         // Ticks flown, not counting rewinds
+        uint64_t missileTicks[Buckets] = {};        // Live missiles summed over those ticks
+        uint64_t shots[Buckets] = {};
+        uint64_t emptyTicks[Buckets] = {};          // Ticks flown with no ammo
+        uint64_t runs = 0;
+        uint64_t ticks = 0;
+        uint64_t logs = 0;
+        uint64_t skipped = 0;
+
+        void Add(const Totals& other) {
+            for (int b = 0; b < Buckets; b++) {
+                reached[b] += other.reached[b];
+                for (int c = 0; c < Causes; c++) deaths[b][c] += other.deaths[b][c];
+                flightTicks[b] += other.flightTicks[b];
+                missileTicks[b] += other.missileTicks[b];
+                shots[b] += other.shots[b];
+                emptyTicks[b] += other.emptyTicks[b];
+            }
+            runs += other.runs;
+            ticks += other.ticks;
+            logs += other.logs;
+            skipped += other.skipped;
+        }
+    };
+
+    int BucketOf(float distance) {
+        return std::clamp((int)(distance / AnalysisConst::BucketDistance), 0, Buckets - 1);
+    }
+
+    // Follows one log's runs. A run ends at a reset or the end of the log;
+    // its death only counts if no rewind undid it by then.
+    class RunTracker {
+    public:
+        explicit RunTracker(Totals& totals) : totals(totals) {}
+
+        // Every run, including the first, starts with full ammo
+        void EndRun() {
+            if (started) totals.runs++;
+            if (deathBucket >= 0) totals.deaths[deathBucket][(int)cause]++;
+            started = false;
+            furthest = -1;
+            deathBucket = -1;
+            ammo = Constants::Game::MaxAmmo;
+        }
+
+        void AfterTick(const Simulation& simulation, const InputFrame& input) {
+            if (!simulation.HasStarted()) return;
+            started = true;
+            int bucket = BucketOf(simulation.GetDistance());
+            while (furthest < bucket) totals.reached[++furthest]++;
+
+            if (simulation.IsGameOver()) {
+                if (deathBucket < 0) {
+                    deathBucket = bucket;
+                    cause = simulation.GetDeathCause();
+                }
+                return;
+            }
+            deathBucket = -1;
+            if (input.rewind) {
+                ammo = simulation.GetAmmo();
+                return;
+            }
+
+            totals.flightTicks[bucket]++;
+            totals.missileTicks[bucket] += simulation.GetEntities().GetCounts().missiles;
+            // Ammo only ever drops by a shot
+            if (simulation.GetAmmo() < ammo) totals.shots[bucket]++;
+            if (simulation.GetAmmo() == 0) totals.emptyTicks[bucket]++;
+            ammo = simulation.GetAmmo();
+        }
+
+    private:
+        Totals& totals;
+        bool started = false;
+        int furthest = -1;
+        int deathBucket = -1;
+        DeathCause cause = DeathCause::None;
+        int ammo = Constants::Game::MaxAmmo;
+    };
+
+    void Analyze(const InputLog& log, Totals& totals) {
+        GameRandom::State random;
+        GameRandom::ThreadBinding binding(random);
+        GameRandom::Seed(log.GetSeed());
+
+        AudioManager audio; // Never opened
+        Simulation simulation(audio);
+        simulation.GetLevel().Init();
+        simulation.Init();
+
+        RunTracker tracker(totals);
+        for (long tick = 0; tick < log.GetTickCount(); tick++) {
+            InputFrame input = log.GetInput(tick);
+            if (input.reset) tracker.EndRun();
+            simulation.Tick(input);
+            tracker.AfterTick(simulation, input);
+        }
+        tracker.EndRun();
+        totals.ticks += log.GetTickCount();
+        totals.logs++;
+    }
+
+    class ColumnWriter {
+    public:
+        ColumnWriter(std::vector<uint8_t>& out, int rows) : out(out), writer(out), rows(rows) {
+            writer.Put((uint32_t)0x314e4148); // "HAN1"
+            writer.Put((uint32_t)rows);
+            writer.Put((uint32_t)0); // Column count, filled in as columns are added
+        }
+
+        template<typename T, typename Fn>
+        void Column(const std::string& name, Fn value) {
+            writer.PutU8(std::is_same<T, uint32_t>::value ? 0 : std::is_same<T, uint64_t>::value ? 1 : 2);
+            writer.PutU8((int)name.size());
+            writer.PutBytes(name.data(), name.size());
+            for (int row = 0; row < rows; row++) writer.Put((T)value(row));
+            uint32_t count = ++columns;
+            memcpy(out.data() + 8, &count, sizeof(count));
+        }
+
+    private:
+        std::vector<uint8_t>& out;
+        ByteWriter writer;
+        uint32_t columns = 0;
+        int rows;
+    };
+
+    bool Write(const Totals& totals, const char* fileName) {
+        int rows = 0;
+        for (int b = 0; b < Buckets; b++) {
+            if (totals.reached[b] > 0) rows = b + 1;
+        }
+        auto ratio = [](uint64_t a, uint64_t b) { return b > 0 ? (float)((double)a / (double)b) : 0.0f; };
+
+        std::vector<uint8_t> bytes;
+        ColumnWriter columns(bytes, rows);
+        columns.Column<uint32_t>("distance", [](int b) { return b * AnalysisConst::BucketDistance; });
+        columns.Column<uint64_t>("reached", [&](int b) { return totals.reached[b]; });
+        for (int c = 1; c < Causes; c++) {
+            std::string name = std::string("deaths_") + DeathCauseName((DeathCause)c);
+            std::replace(name.begin(), name.end(), ' ', '_');
+            columns.Column<uint64_t>(name, [&](int b) { return totals.deaths[b][c]; });
+        }
+        auto deaths = [&](int b) {
+            uint64_t sum = 0;
+            for (int c = 0; c < Causes; c++) sum += totals.deaths[b][c];
+            return sum;
+        };
+        // Chance that a run reaching the bucket ends in it: the difficulty curve
+        columns.Column<float>("death_rate", [&](int b) { return ratio(deaths(b), totals.reached[b]); });
+        columns.Column<uint64_t>("flight_ticks", [&](int b) { return totals.flightTicks[b]; });
+        columns.Column<float>("missiles_per_tick", [&](int b) { return ratio(totals.missileTicks[b], totals.flightTicks[b]); });
+        columns.Column<uint64_t>("shots", [&](int b) { return totals.shots[b]; });
+        columns.Column<float>("shots_per_second", [&](int b) {
+            return ratio(totals.shots[b], totals.flightTicks[b]) * Constants::TargetFPS;
+        });
+        columns.Column<float>("empty_ammo_share", [&](int b) { return ratio(totals.emptyTicks[b], totals.flightTicks[b]); });
+
+        FILE* file = fopen(fileName, "wb");
+        bool ok = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        if (file && fclose(file) != 0) ok = false;
+        if (!ok) TraceLog(LOG_WARNING, "ANALYZE: Could not write %s", fileName);
+        return ok;
+    }
+}
+
+namespace RunAnalysis {
+    int Run(const char* directory, const char* outputFile) {
+        // Longest logs first, so the last ones to finish are short
+        std::vector<std::pair<uintmax_t, std::string>> files;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".hrp") {
+                files.emplace_back(entry.file_size(error), entry.path().string());
+            }
+        }
+        if (files.empty()) {
+            TraceLog(LOG_WARNING, "ANALYZE: No .hrp input logs in %s", directory);
+            return 1;
+        }
+        std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        // One simulation per thread; each takes the next file until none are left
+        auto start = std::chrono::steady_clock::now();
+        int threads = Jobs::GetWorkerCount() + 1;
+        std::vector<Totals> perThread(threads);
+        std::atomic<size_t> next{0};
+        SetTraceLogLevel(LOG_WARNING); // Every run logs its wave file otherwise
+        Jobs::ParallelFor(threads, 1, [&](int begin, int end) {
+            for (int slot = begin; slot < end; slot++) {
+                InputLog log;
+                for (size_t i; (i = next.fetch_add(1)) < files.size(); ) {
+                    MappedFile mapped;
+                    if (!mapped.Open(files[i].second.c_str()) || !log.Parse(mapped.GetData(), mapped.GetSize())) {
+                        perThread[slot].skipped++;
+                        continue;
+                    }
+                    mapped.Close();
+                    Analyze(log, perThread[slot]);
+                }
+            }
+        });
+        SetTraceLogLevel(LOG_INFO);
+
+        Totals totals;
+        for (const Totals& t : perThread) totals.Add(t);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        TraceLog(LOG_INFO, "ANALYZE: %lu logs, %lu runs, %lu ticks in %.2f s on %d threads (%.0f ticks/s)",
+                 (unsigned long)totals.logs, (unsigned long)totals.runs, (unsigned long)totals.ticks, seconds, threads,
+                 totals.ticks / std::max(seconds, 1e-9));
+        if (totals.skipped > 0) TraceLog(LOG_WARNING, "ANALYZE: Skipped %lu unreadable files", (unsigned long)totals.skipped);
+
+        uint64_t byCause[Causes] = {};
+        for (int b = 0; b < Buckets; b++) {
+            for (int c = 0; c < Causes; c++) byCause[c] += totals.deaths[b][c];
+        }
+        for (int c = 1; c < Causes; c++) {
+            if (byCause[c] > 0) TraceLog(LOG_INFO, "ANALYZE:   %-20s %lu deaths", DeathCauseName((DeathCause)c), (unsigned long)byCause[c]);
+        }
+
+        if (totals.logs == 0 || !Write(totals, outputFile)) return 1;
+        TraceLog(LOG_INFO, "ANALYZE: Wrote %s", outputFile);
+        return 0;
+    }
+}
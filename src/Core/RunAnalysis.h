@@ -0,0 +1,18 @@
+#pragma once
+
+// --analyze: re-simulates every input log (*.hrp, see InputLog) in a
+// directory and aggregates how runs went, by stretch of distance travelled:
+// how many runs got that far, what killed the ones that died there, how
+// many missiles were around, shots fired and time spent out of ammo.
+// Being per distance rather than per tick or frame, the curves compare
+// across frame rates and session lengths.
+//
+// Files are memory-mapped and spread over every core of the job system, one
+// simulation per thread. Results go to a columnar file: the magic "HAN1",
+// the row and column counts (u32), then per column its type (u8: 0 = u32,
+// 1 = u64, 2 = f32), name length (u8), name and all of its rows.
+namespace RunAnalysis {
+    // Returns the process exit code: non-zero if no log could be analyzed
+    // or the results could not be written
+    int Run(const char* directory, const char* outputFile);
+}
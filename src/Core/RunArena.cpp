@@ -0,0 +1,26 @@
+#include "RunArena.h"
+#include "AllocTracker.h"
+
+namespace {
+    constexpr size_t InitialChunk = 64 * 1024;
+}
+
+RunArena::RunArena() : chunks(InitialChunk, &upstream), pool(&chunks) {}
+
+void RunArena::Release() {
+    pool.release();
+    chunks.release();
+}
+
+void* RunArena::Upstream::do_allocate(size_t bytes, size_t alignment) {
+    AllocTracker::Scope scope(AllocTracker::Tag::Arena);
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RunArena::Upstream::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool RunArena::Upstream::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
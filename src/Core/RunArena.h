@@ -0,0 +1,30 @@
+#pragma once
+#include <memory_resource>
+
+// Backing store for everything a single run allocates (level geometry,
+// entities). Freed blocks are recycled by size through a pool, and the
+// whole arena goes back to the heap at once on Release(), so a run leaves
+// nothing behind for the next one. Not thread-safe: only the thread that
+// owns the run may allocate from it.
+class RunArena {
+public:
+    RunArena();
+    RunArena(const RunArena&) = delete;
+    RunArena& operator=(const RunArena&) = delete;
+
+    std::pmr::memory_resource* Get() { return &pool; }
+    // Every container using the arena must be destroyed first
+    void Release();
+
+private:
+    // Reserves chunks from the heap, tagged as AllocTracker::Tag::Arena
+    class Upstream : public std::pmr::memory_resource {
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    Upstream upstream;
+    std::pmr::monotonic_buffer_resource chunks;
+    std::pmr::unsynchronized_pool_resource pool;
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include "raylib.h"
+#include "Fixed.h"
+#include <cmath>
+
+// Number type for simulation state: positions, velocities and distance.
+// Configuring with -DHELI_FIXED_POINT=ON switches it to 48.16 fixed point,
+// which makes ticks bit-identical across builds and platforms. Rendering
+// always works in float and converts with ToFloat()/ToVector2().
+#ifdef HELI_FIXED_POINT
+using Scalar = Fixed;
+#else
+using Scalar = float;
+#endif
+
+inline float ToFloat(float value) { return value; }
+inline float ToFloat(Fixed value) { return value.ToFloat(); }
+// Truncates toward zero like an (int) cast
+inline int ToInt(float value) { return (int)value; }
+inline int ToInt(Fixed value) { return (int)(value.raw / Fixed::One); }
+
+inline float SimSin(float radians) { return sinf(radians); }
+inline float SimCos(float radians) { return cosf(radians); }
+inline Fixed SimSin(Fixed radians) { return FixedMath::Sin(radians); }
+inline Fixed SimCos(Fixed radians) { return FixedMath::Cos(radians); }
+
+struct SimVec2 {
+    Scalar x = Scalar(0);
+    Scalar y = Scalar(0);
+
+    static SimVec2 From(Vector2 v) { return { Scalar(v.x), Scalar(v.y) }; }
+    Vector2 ToVector2() const { return { ToFloat(x), ToFloat(y) }; }
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include "Helicopter.h"
+#include "Level.h"
+#include "EntityManager.h"
+
+// Immutable copy of everything the renderer needs from one simulation tick
+struct SimSnapshot {
+    Helicopter helicopter;
+    Level level;
+    EntityManager entities;
+    int ammo = 0;
+    bool isGameOver = false;
+    unsigned long tick = 0;
+    unsigned int run = 0;   // Changes whenever the game restarts or jumps back in time
+    bool rewinding = false;
+    float rewindSeconds = 0.0f; // How far back rewinding can still go
+    // The whole run, built once it ended; shared by every later snapshot
+    std::shared_ptr<const TerrainHistory::Minimap> minimap;
+
+    float GetDistance() const { return level.GetDistance(); }
+};
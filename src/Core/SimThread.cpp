@@ -0,0 +1,64 @@
+#include "SimThread.h"
+#include <utility>
+
+SimThread::~SimThread() {
+    Stop();
+}
+
+void SimThread::Start(Simulation& simulation) {
+    Stop();
+    this->simulation = &simulation;
+    simulation.Capture(*front);
+    hasWork = false;
+    hasResult = false;
+    stopping = false;
+    worker = std::thread(&SimThread::Loop, this);
+}
+
+void SimThread::Stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void SimThread::Submit(const InputFrame& input) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingInput = input;
+        hasWork = true;
+    }
+    wake.notify_one();
+}
+
+const SimSnapshot& SimThread::AcquireLatest() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !hasWork; });
+    if (hasResult) {
+        std::swap(front, back);
+        hasResult = false;
+    }
+    return *front;
+}
+
+void SimThread::Loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return hasWork || stopping; });
+        if (stopping) break;
+
+        InputFrame input = pendingInput;
+        lock.unlock();
+
+        simulation->Tick(input);
+        simulation->Capture(*back);
+
+        lock.lock();
+        hasWork = false;
+        hasResult = true;
+        finished.notify_one();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Simulation.h"
+#include "SimSnapshot.h"
+#include "InputFrame.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs simulation ticks on a worker thread, pipelined with rendering: while
+// the main thread draws the snapshot of tick N, the worker computes tick
+// N+1 into the back buffer. Frame cost becomes max(sim, render).
+class SimThread {
+public:
+    ~SimThread();
+
+    void Start(Simulation& simulation);
+    void Stop();
+    bool IsRunning() const { return worker.joinable(); }
+
+    // Hands the input for the next tick to the worker and wakes it
+    void Submit(const InputFrame& input);
+    // Waits for the tick started by the last Submit() and returns its snapshot.
+    // The reference stays valid until the next call.
+    const SimSnapshot& AcquireLatest();
+    // The snapshot returned by the last AcquireLatest()
+    const SimSnapshot& Front() const { return *front; }
+
+private:
+    void Loop();
+
+    Simulation* simulation = nullptr;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    SimSnapshot buffers[2];
+    SimSnapshot* front = &buffers[0];   // Read by the render thread
+    SimSnapshot* back = &buffers[1];    // Written by the worker
+
+    InputFrame pendingInput;
+    bool hasWork = false;
+    bool hasResult = false;
+    bool stopping = false;
+};
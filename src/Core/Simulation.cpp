@@ -0,0 +1,168 @@
+#include "Simulation.h"
+#include "Constants.h"
+#include "AllocTracker.h"
+#include "StateSerializer.h"
+
+using HeliConst = Constants::Helicopter;
+using GameConst = Constants::Game;
+
+using Tag = AllocTracker::Tag;
+
+Simulation::Simulation(AudioManager& audioManager) : audioManager(audioManager) {
+    level.emplace(arena.Get());
+    entityManager.emplace(arena.Get());
+}
+
+void Simulation::Init() {
+    helicopter.Init(HeliConst::StartPos);
+    entityManager->Init();
+    spawnScheduler.Load("assets/waves.txt");
+    currentAmmo = GameConst::MaxAmmo;
+    ammoRechargeTimer = 0.0f;
+    isGameOver = false;
+    rewind.Clear();
+    ticksSinceRecord = 0;
+}
+
+void Simulation::Reset() {
+    run++;
+    isGameOver = false;
+    helicopter.Init(HeliConst::StartPos); 
+
+    // Drop the previous run's storage in one go
+    entityManager.reset();
+    level.reset();
+    arena.Release();
+    level.emplace(arena.Get());
+    entityManager.emplace(arena.Get());
+
+    level->Init();
+    entityManager->Init();
+    spawnScheduler.Reset();
+    spawnScheduler.Load("assets/waves.txt");
+    currentAmmo = GameConst::MaxAmmo;
+    ammoRechargeTimer = 0.0f;
+    rewind.Clear();
+    ticksSinceRecord = 0;
+    occupancyStale = false;
+    minimap.reset();
+}
+
+void Simulation::Tick(const InputFrame& input) {
+    Advance(input);
+    if (inputLog && inputLog->Add(input)) inputLog->AddHash(GetStateHash());
+}
+
+uint64_t Simulation::GetStateHash() const {
+    return StateSerializer::Hash(*this);
+}
+
+void Simulation::Advance(const InputFrame& input) {
+    if (input.reset) Reset();
+    tick++;
+    entityManager->ClearBursts(); // Only this tick's hits reach the snapshot
+
+    // Each rewinding tick goes back one recorded state. The jump counts as a
+    // new run for anything following the snapshots (particles, spectators).
+    if (rewinding && !input.rewind) rewind.Resume();
+    rewinding = input.rewind;
+    if (rewinding) {
+        if (rewind.Restore(*this)) {
+            occupancyStale = true;
+            ticksSinceRecord = 0;
+            run++;
+            minimap.reset();
+        }
+        return;
+    }
+
+    // The world stays frozen behind the game over screen
+    if (isGameOver) return;
+
+    if (occupancyStale) {
+        level->RebuildOccupancy();
+        occupancyStale = false;
+    }
+    if (helicopter.HasStarted() && ++ticksSinceRecord >= Constants::Rewind::Interval) {
+        rewind.Record(*this);
+        ticksSinceRecord = 0;
+    }
+
+    const float dt = Constants::TickTime;
+    helicopter.Update(input, dt);
+
+    if (helicopter.HasStarted()) {
+        {
+            AllocTracker::Scope scope(Tag::Level);
+            level->Update(); // Update terrain
+        }
+        
+        // Update Entities
+        {
+            AllocTracker::Scope scope(Tag::Entities);
+            spawnScheduler.Update(dt, *level, *entityManager);
+            entityManager->Update(dt, *level, helicopter, audioManager);
+        }
+        
+        // Check Player Collisions (Entities)
+        DeathCause cause;
+        if (!invulnerable && entityManager->CheckPlayerCollisions(helicopter.GetHitbox(), &cause)) {
+            GameOver(cause);
+            return; // Game over, stop further updates for this tick
+        }
+    }
+
+    // Recharge Ammo
+    if (currentAmmo < GameConst::MaxAmmo) {
+        ammoRechargeTimer += dt;
+        if (ammoRechargeTimer >= GameConst::AmmoRechargeDelay) {
+            currentAmmo++;
+            ammoRechargeTimer = 0.0f;
+        }
+    }
+
+    // Input: Shooting
+    if (input.shoot && currentAmmo > 0) {
+        Vector2 heliPos = helicopter.GetPosition();
+        // Spawn at nose (Width 40, Height 20 -> Center Right ~ 40, 10)
+        AllocTracker::Scope scope(Tag::Entities);
+        if (entityManager->SpawnProjectile(Vector2{heliPos.x + HeliConst::Width, heliPos.y + HeliConst::Height / 2.0f}, helicopter.IsFacingRight())) {
+            currentAmmo--;
+            audioManager.PlayShoot();
+        }
+    }
+    
+    // Check Player Level Collisions
+    if (!invulnerable && level->CheckCollision(helicopter.GetHitbox())) {
+        GameOver(level->GetCollisionCause(helicopter.GetHitbox()));
+    }
+}
+
+void Simulation::GameOver(DeathCause cause) {
+    isGameOver = true;
+    deathCause = cause;
+    audioManager.PlayGameOver();
+
+    // History column i spans world x [i, i + 1) * TerrainStep. Columns
+    // generated past the right edge of the screen were never seen.
+    float deathX = level->GetDistance() + helicopter.GetPosition().x + HeliConst::Width / 2.0f;
+    int deathColumn = (int)(deathX / Constants::TerrainStep);
+    int seenColumns = (int)((level->GetDistance() + Constants::ScreenWidth) / Constants::TerrainStep);
+    AllocTracker::Scope scope(Tag::Snapshot);
+    minimap = std::make_shared<const TerrainHistory::Minimap>(
+        level->GetHistory().BuildMinimap(Constants::Minimap::Width, seenColumns, deathColumn));
+}
+
+void Simulation::Capture(SimSnapshot& out) const {
+    AllocTracker::Scope scope(Tag::Snapshot);
+    out.helicopter = helicopter;
+    out.level = *level;
+    out.entities = *entityManager;
+    out.ammo = currentAmmo;
+    out.isGameOver = isGameOver;
+    out.tick = tick;
+    out.run = run;
+    out.rewinding = rewinding;
+    out.rewindSeconds = rewind.GetSeconds();
+    out.minimap = minimap;
+}
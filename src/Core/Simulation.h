@@ -0,0 +1,83 @@
+#pragma once
+#include "Helicopter.h"
+#include "Level.h"
+#include "EntityManager.h"
+#include "AudioManager.h"
+#include "InputFrame.h"
+#include "SimSnapshot.h"
+#include "RunArena.h"
+#include "SpawnScheduler.h"
+#include "RewindBuffer.h"
+#include "InputLog.h"
+#include <optional>
+
+// The gameplay state and its fixed-step update. Owns no window or GPU
+// resources, so it can run on its own thread or without a window at all.
+class Simulation {
+    friend class StateSerializer;
+
+public:
+    explicit Simulation(AudioManager& audioManager);
+
+    void Init();
+    void Reset();
+    // Advances one fixed step (Constants::TickTime)
+    void Tick(const InputFrame& input);
+    // StateSerializer::Hash() of the current state
+    uint64_t GetStateHash() const;
+    void Capture(SimSnapshot& out) const;
+
+    bool IsGameOver() const { return isGameOver; }
+    // What ended the run, while it is over
+    DeathCause GetDeathCause() const { return isGameOver ? deathCause : DeathCause::None; }
+    int GetAmmo() const { return currentAmmo; }
+    bool HasStarted() const { return helicopter.HasStarted(); }
+    float GetDistance() const { return level->GetDistance(); }
+    unsigned long GetTick() const { return tick; }
+
+    // Level::Init can run on a loader thread before the first tick
+    Level& GetLevel() { return *level; }
+    const Level& GetLevel() const { return *level; }
+    const EntityManager& GetEntities() const { return *entityManager; }
+
+    // Collisions no longer end the run; lets --soak keep one run going
+    void SetInvulnerable(bool value) { invulnerable = value; }
+
+    const RewindBuffer& GetRewind() const { return rewind; }
+
+    // Every later tick's input goes into `log`, with the state hash at its
+    // interval; null stops recording
+    void SetInputLog(InputLog* log) { inputLog = log; }
+
+private:
+    void Advance(const InputFrame& input);
+    // Ends the run and summarizes its terrain for the game over screen
+    void GameOver(DeathCause cause);
+
+    AudioManager& audioManager;
+
+    Helicopter helicopter;
+
+    // Level and entities live in the arena for one run; Reset() destroys them,
+    // returns the whole arena to the heap and builds fresh ones
+    RunArena arena;
+    std::optional<Level> level;
+    std::optional<EntityManager> entityManager;
+    SpawnScheduler spawnScheduler;
+
+    int currentAmmo = 5;
+    float ammoRechargeTimer = 0.0f;
+    bool isGameOver = false;
+    DeathCause deathCause = DeathCause::None;
+    bool invulnerable = false;
+    unsigned long tick = 0;
+    unsigned int run = 0;   // Bumped by every Reset() and rewind step
+
+    // States of the last few seconds, recorded every Constants::Rewind::Interval ticks
+    RewindBuffer rewind;
+    int ticksSinceRecord = 0;
+    bool rewinding = false;
+    bool occupancyStale = false; // A restored level has not rebuilt its collision mask yet
+    std::shared_ptr<const TerrainHistory::Minimap> minimap;
+    InputLog* inputLog = nullptr;
+};
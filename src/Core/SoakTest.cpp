@@ -0,0 +1,119 @@
+#include "SoakTest.h"
+#include "Simulation.h"
+#include "SimSnapshot.h"
+#include "AudioManager.h"
+#include "AllocTracker.h"
+#include "GameRandom.h"
+#include "Constants.h"
+#include "RandomPlayer.h"
+#include "raylib.h"
+#include <algorithm>
+
+using WorldConst = Constants::World;
+using SoakConst = Constants::Soak;
+
+namespace {
+    enum Metric { Missiles, Projectiles, Rocks, Explosions, LevelPieces, HeapKB, MetricCount };
+
+    struct MetricInfo {
+        const char* name;
+        double cap;         // 0 = no hard cap
+        double allowance;   // Growth tolerated on top of GrowthFactor
+    };
+
+    constexpr MetricInfo Metrics[MetricCount] = {
+        { "missiles",     WorldConst::MaxMissiles,    8 },
+        { "projectiles",  WorldConst::MaxProjectiles, 4 },
+        { "rocks",        WorldConst::MaxRocks,       8 },
+        { "explosions",   WorldConst::MaxExplosions,  8 },
+        { "level pieces", 0,                         32 },
+        { "heap KB",      0,                        256 },
+    };
+}
+
+namespace SoakTest {
+    int Run(long ticks, unsigned int seed) {
+        GameRandom::Seed(seed);
+        AudioManager audio; // Never opened; sounds are only counted
+        Simulation simulation(audio);
+        simulation.GetLevel().Init();
+        simulation.Init();
+        SimSnapshot snapshot;
+        RandomPlayer player(seed);
+
+        double firstHalf[MetricCount] = {};
+        double lastQuarter[MetricCount] = {};
+        double overall[MetricCount] = {};
+        long ticksAtCap[MetricCount] = {};
+        bool overCap = false;
+
+        long runEnd = 0;
+        long gameOverAt = -1;
+        int runs = 0;
+        for (long tick = 0; tick < ticks; tick++) {
+            InputFrame input = player.Next();
+
+            // Long invulnerable runs, with a normal one now and then
+            if (tick == runEnd || (gameOverAt >= 0 && tick - gameOverAt > 60)) {
+                input.reset = tick > 0;
+                simulation.SetInvulnerable(player.Uniform(0, 3) != 0);
+                runEnd = tick + player.Uniform(20000, 200000);
+                gameOverAt = -1;
+                runs++;
+            }
+
+            simulation.Tick(input);
+            audio.FlushSounds();
+            if (simulation.IsGameOver() && gameOverAt < 0) gameOverAt = tick;
+            // Exercise the render copies as well; they allocate too
+            if ((tick & 15) == 0) simulation.Capture(snapshot);
+
+            double values[MetricCount];
+            EntityManager::Counts counts = simulation.GetEntities().GetCounts();
+            values[Missiles] = counts.missiles;
+            values[Projectiles] = counts.projectiles;
+            values[Rocks] = counts.rocks;
+            values[Explosions] = counts.explosions;
+            values[LevelPieces] = (double)simulation.GetLevel().GetPieceCount();
+            values[HeapKB] = 0.0;
+            if (tick % SoakConst::SampleInterval == 0) {
+                values[HeapKB] = AllocTracker::GetTotals().liveBytes / 1024.0;
+            }
+
+            for (int m = 0; m < MetricCount; m++) {
+                if (Metrics[m].cap > 0 && values[m] > Metrics[m].cap && !overCap) {
+                    TraceLog(LOG_ERROR, "SOAK: %s at %.0f passed the cap of %.0f on tick %ld",
+                             Metrics[m].name, values[m], Metrics[m].cap, tick);
+                    overCap = true;
+                }
+                if (Metrics[m].cap > 0 && values[m] >= Metrics[m].cap) ticksAtCap[m]++;
+                overall[m] = std::max(overall[m], values[m]);
+                if (tick < ticks / 2) firstHalf[m] = std::max(firstHalf[m], values[m]);
+                if (tick >= ticks - ticks / 4) lastQuarter[m] = std::max(lastQuarter[m], values[m]);
+            }
+
+            if (ticks >= 10 && (tick + 1) % (ticks / 10) == 0) {
+                TraceLog(LOG_INFO, "SOAK: %3ld%%  tick %ld, %d runs, heap %.1f KB", (tick + 1) * 100 / ticks,
+                         tick + 1, runs, AllocTracker::GetTotals().liveBytes / 1024.0);
+            }
+        }
+
+        TraceLog(LOG_INFO, "SOAK: %-12s %10s %10s %10s %8s %8s", "metric", "first half", "last 1/4", "peak", "cap", "at cap");
+        bool grew = false;
+        for (int m = 0; m < MetricCount; m++) {
+            // Pinned at a cap means the entities stopped leaving and spawns are being dropped
+            double atCap = 100.0 * ticksAtCap[m] / ticks;
+            bool growing = lastQuarter[m] > firstHalf[m] * SoakConst::GrowthFactor + Metrics[m].allowance ||
+                           atCap > SoakConst::MaxPercentAtCap;
+            grew = grew || growing;
+            TraceLog(growing ? LOG_ERROR : LOG_INFO, "SOAK: %-12s %10.1f %10.1f %10.1f %8.0f %7.1f%%%s", Metrics[m].name,
+                     firstHalf[m], lastQuarter[m], overall[m], Metrics[m].cap, atCap, growing ? "  GROWING" : "");
+        }
+        TraceLog(LOG_INFO, "SOAK: %ld ticks, %d runs, %lu spawns or effects dropped at the caps in the last run",
+                 ticks, runs, simulation.GetEntities().GetDroppedCount());
+
+        bool passed = !overCap && !grew;
+        TraceLog(passed ? LOG_INFO : LOG_ERROR, "SOAK: %s", passed ? "Passed" : "Failed");
+        return passed ? 0 : 1;
+    }
+}
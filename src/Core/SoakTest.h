@@ -0,0 +1,13 @@
+#pragma once
+
+// --soak: runs the simulation without a window for a long stretch of random
+// input and checks that nothing accumulates. Most runs are played with the
+// player invulnerable so a single run lasts long enough for slow leaks to
+// show; some end in a normal game over. Entity counts, level pieces and the
+// live heap are tracked per window; the test fails if any count passes its
+// cap or if a metric's peak over the last quarter of the ticks clearly
+// exceeds its peak over the first half.
+namespace SoakTest {
+    // Returns the process exit code
+    int Run(long ticks, unsigned int seed);
+}
@@ -0,0 +1,141 @@
+#include "SpawnScheduler.h"
+#include "EntityManager.h"
+#include "Level.h"
+#include "Constants.h"
+#include <algorithm>
+
+namespace {
+    // Guards against a script that loops without ever waiting
+    constexpr int MaxStepsPerResume = 10000;
+
+    // std heaps are max-heaps; invert for earliest-first
+    template <typename T>
+    bool Later(const T& a, const T& b) {
+        if (a.key != b.key) return a.key > b.key;
+        return a.sequence > b.sequence;
+    }
+}
+
+void SpawnScheduler::Load(const std::string& path) {
+    waveFile.Load(path);
+    Reset();
+}
+
+void SpawnScheduler::Reset() {
+    timeQueue.clear();
+    distanceQueue.clear();
+    scripts.clear();
+    time = 0.0f;
+    sequence = 0;
+
+    const auto& events = waveFile.GetEvents();
+    for (int i = 0; i < (int)events.size(); i++) {
+        Push(events[i].byDistance ? distanceQueue : timeQueue, events[i].key, ~i);
+    }
+
+    // Every wave starts at time zero
+    const auto& waves = waveFile.GetWaves();
+    for (int i = 0; i < (int)waves.size(); i++) {
+        scripts.push_back({i, 0, 0.0f, {}});
+        Push(timeQueue, 0.0f, i);
+    }
+}
+
+void SpawnScheduler::Push(std::vector<Pending>& queue, float key, int target) {
+    queue.push_back({key, sequence++, target});
+    std::push_heap(queue.begin(), queue.end(), Later<Pending>);
+}
+
+SpawnScheduler::Pending SpawnScheduler::Pop(std::vector<Pending>& queue) {
+    std::pop_heap(queue.begin(), queue.end(), Later<Pending>);
+    Pending top = queue.back();
+    queue.pop_back();
+    return top;
+}
+
+void SpawnScheduler::Update(float dt, const Level& level, EntityManager& entities) {
+    time += dt;
+    const float distance = level.GetDistance();
+
+    while (!timeQueue.empty() && timeQueue.front().key <= time) {
+        Pending due = Pop(timeQueue);
+        // Timed steps chain from when they were due, not when the tick ran
+        Dispatch(due.target, due.key, level, entities);
+    }
+    while (!distanceQueue.empty() && distanceQueue.front().key <= distance) {
+        Pending due = Pop(distanceQueue);
+        Dispatch(due.target, time, level, entities);
+    }
+}
+
+void SpawnScheduler::Dispatch(int target, float clock, const Level& level, EntityManager& entities) {
+    if (target < 0) {
+        Spawn(waveFile.GetEvents()[~target].spawn, level, entities);
+    } else {
+        Resume(target, clock, level, entities);
+    }
+}
+
+void SpawnScheduler::Resume(int scriptIndex, float clock, const Level& level, EntityManager& entities) {
+    Script& script = scripts[scriptIndex];
+    const auto& wave = waveFile.GetWaves()[script.wave];
+    script.clock = clock;
+
+    for (int steps = 0; steps < MaxStepsPerResume; steps++) {
+        if (script.pc >= (int)wave.ops.size()) return; // Finished
+
+        const WaveFile::Op& op = wave.ops[script.pc];
+        switch (op.code) {
+            case WaveFile::Op::Code::Wait:
+                script.pc++;
+                Push(timeQueue, script.clock + op.value, scriptIndex);
+                return;
+            case WaveFile::Op::Code::WaitDistance:
+                script.pc++;
+                Push(distanceQueue, op.value, scriptIndex);
+                return;
+            case WaveFile::Op::Code::Spawn:
+                Spawn(op.spawn, level, entities);
+                script.pc++;
+                break;
+            case WaveFile::Op::Code::Repeat:
+                if (op.count == 0) {
+                    script.pc = op.jump + 1;
+                } else {
+                    script.loops.push_back(op.count);
+                    script.pc++;
+                }
+                break;
+            case WaveFile::Op::Code::End: {
+                int& remaining = script.loops.back();
+                if (remaining > 0) remaining--;
+                if (remaining != 0) {
+                    script.pc = op.jump + 1; // Back to the top of the block
+                } else {
+                    script.loops.pop_back();
+                    script.pc++;
+                }
+                break;
+            }
+        }
+    }
+
+    TraceLog(LOG_WARNING, "WAVES: Wave '%s' runs without waiting; stopped", wave.name.c_str());
+    script.pc = (int)wave.ops.size();
+}
+
+void SpawnScheduler::Spawn(const SpawnCommand& spawn, const Level& level, EntityManager& entities) const {
+    Vector2 pos;
+    switch (spawn.edge) {
+        case SpawnCommand::Edge::Right: pos.x = (float)Constants::ScreenWidth + 50.0f; break;
+        case SpawnCommand::Edge::Left: pos.x = 0.0f; break;
+        case SpawnCommand::Edge::Absolute: pos.x = spawn.x; break;
+    }
+    pos.y = spawn.fromGap ? level.GetCurrentGapCenter() + spawn.y : spawn.y;
+
+    if (spawn.kind == SpawnCommand::Kind::Missile) {
+        entities.SpawnMissile(MissileFactory::Create(spawn.missileType, pos));
+    } else {
+        entities.SpawnRock(pos, spawn.rockRadius);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "WaveFile.h"
+#include <string>
+#include <vector>
+
+class Level;
+class EntityManager;
+
+// Fires the spawns and wave script steps of a WaveFile when they are due.
+// Pending work sits in two min-heaps, one keyed by run time and one by
+// distance travelled, so an idle tick only compares against the two heap
+// tops and each firing costs O(log n) however many events are queued.
+class SpawnScheduler {
+    friend class StateSerializer;
+
+public:
+    void Load(const std::string& path);
+    // Restarts every wave and one-shot event for a new run
+    void Reset();
+    // Advances run time by dt and spawns everything due at the level's distance
+    void Update(float dt, const Level& level, EntityManager& entities);
+
+    size_t GetPendingCount() const { return timeQueue.size() + distanceQueue.size(); }
+
+private:
+    struct Pending {
+        float key;
+        unsigned int sequence;  // Keeps same-key entries in insertion order
+        int target;             // >= 0: script to resume, < 0: ~event index
+    };
+
+    // A running wave script
+    struct Script {
+        int wave;
+        int pc;
+        float clock;                // Time the current step is measured from
+        std::vector<int> loops;     // Remaining iterations of each open repeat
+    };
+
+    void Push(std::vector<Pending>& queue, float key, int target);
+    Pending Pop(std::vector<Pending>& queue);
+    void Dispatch(int target, float clock, const Level& level, EntityManager& entities);
+    void Resume(int scriptIndex, float clock, const Level& level, EntityManager& entities);
+    void Spawn(const SpawnCommand& spawn, const Level& level, EntityManager& entities) const;
+
+    WaveFile waveFile;
+    std::vector<Pending> timeQueue;
+    std::vector<Pending> distanceQueue;
+    std::vector<Script> scripts;
+    float time = 0.0f;
+    unsigned int sequence = 0;
+};
@@ -0,0 +1,68 @@
+#include "StartupTimeline.h"
+#include "raylib.h"
+#include <algorithm>
+#include <string>
+
+StartupTimeline::Scope::Scope(StartupTimeline& timeline, const char* label)
+    : timeline(timeline), label(label), start(timeline.Now()) {}
+
+StartupTimeline::Scope::~Scope() {
+    timeline.Add(label, start, timeline.Now());
+}
+
+StartupTimeline::StartupTimeline()
+    : origin(std::chrono::steady_clock::now()), mainThread(std::this_thread::get_id()) {}
+
+double StartupTimeline::Now() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void StartupTimeline::Add(const char* label, double start, double end) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back({label, std::this_thread::get_id(), start, end});
+}
+
+void StartupTimeline::Mark(const char* label) {
+    double now = Now();
+    Add(label, now, now);
+}
+
+void StartupTimeline::Log() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.empty()) return;
+
+    std::vector<Entry> sorted = entries;
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+        return a.start < b.start;
+    });
+
+    // Map thread ids to small indices, main thread first
+    std::vector<std::thread::id> threads = { mainThread };
+    double total = 0.0;
+    for (const auto& e : sorted) {
+        if (std::find(threads.begin(), threads.end(), e.thread) == threads.end()) threads.push_back(e.thread);
+        total = std::max(total, e.end);
+    }
+    if (total <= 0.0) total = 1.0;
+
+    const int barWidth = 40;
+    TraceLog(LOG_INFO, "STARTUP: Timeline (%.1f ms total)", total);
+    for (const auto& e : sorted) {
+        int thread = (int)(std::find(threads.begin(), threads.end(), e.thread) - threads.begin());
+        int from = (int)(e.start / total * barWidth);
+        int to = std::max(from + 1, (int)(e.end / total * barWidth));
+        std::string bar(barWidth, '.');
+        for (int i = from; i < to && i < barWidth; i++) bar[i] = '#';
+        TraceLog(LOG_INFO, "STARTUP:   T%d |%s| %7.1f -> %7.1f ms  %s", thread, bar.c_str(), e.start, e.end, e.label);
+    }
+
+    // The worker step that finished last is what the first frame was waiting on
+    const Entry* critical = nullptr;
+    for (const auto& e : sorted) {
+        if (e.thread == mainThread || e.end <= e.start) continue;
+        if (!critical || e.end > critical->end) critical = &e;
+    }
+    if (critical) {
+        TraceLog(LOG_INFO, "STARTUP: Critical path ends with '%s' at %.1f ms", critical->label, critical->end);
+    }
+}
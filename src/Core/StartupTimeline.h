@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Records when each startup step ran and on which thread, then logs the
+// result as a timeline so the critical path to the first frame is visible.
+class StartupTimeline {
+public:
+    class Scope {
+    public:
+        Scope(StartupTimeline& timeline, const char* label);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& timeline;
+        const char* label;
+        double start;
+    };
+
+    StartupTimeline();
+
+    // Times the enclosing block on the calling thread
+    Scope Measure(const char* label) { return Scope(*this, label); }
+    // Records an instantaneous event (e.g. "first frame")
+    void Mark(const char* label);
+    void Log() const;
+
+private:
+    struct Entry {
+        const char* label;
+        std::thread::id thread;
+        double start; // ms since construction
+        double end;
+    };
+
+    double Now() const;
+    void Add(const char* label, double start, double end);
+
+    std::chrono::steady_clock::time_point origin;
+    std::thread::id mainThread;
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+};
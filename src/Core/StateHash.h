@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Order-dependent 64-bit hash of plain values, fed the same way as a
+// ByteWriter. Values are hashed as their bytes, so structs must not have
+// padding. Not cryptographic; it only has to make accidental collisions
+// between two diverging simulations unlikely.
+class StateHash {
+public:
+    // `seed` continues an earlier hash (the value Get() returned)
+    explicit StateHash(uint64_t seed = 0) : state(seed ^ 0x9e3779b97f4a7c15ull) {}
+
+    template<typename T>
+    void Put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values are hashed as bytes");
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        size_t i = 0;
+        for (; i + 8 <= sizeof(T); i += 8) {
+            uint64_t word;
+            memcpy(&word, bytes + i, 8);
+            Mix(word);
+        }
+        if (i < sizeof(T)) {
+            uint64_t word = 0;
+            memcpy(&word, bytes + i, sizeof(T) - i);
+            Mix(word ^ ((uint64_t)(sizeof(T) - i) << 56));
+        }
+    }
+    void PutU8(int value) { Put((uint8_t)value); }
+
+    uint64_t Get() const {
+        // splitmix64 finalizer, so close inputs end up far apart
+        uint64_t h = state;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        return h ^ (h >> 31);
+    }
+
+private:
+    void Mix(uint64_t word) {
+        state ^= word * 0x87c37b91114253d5ull;
+        state = ((state << 31) | (state >> 33)) * 0x4cf5ad432745937full;
+    }
+
+    uint64_t state;
+};
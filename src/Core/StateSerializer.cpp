@@ -0,0 +1,374 @@
+#include "StateSerializer.h"
+#include "Simulation.h"
+#include "MissileFactory.h"
+#include "GameRandom.h"
+#include "ByteStream.h"
+#include "StateHash.h"
+#include <type_traits>
+
+namespace {
+    constexpr uint32_t Magic = 0x31545348; // "HST1"
+
+    // Containers of plain structs without padding: a count, then the elements
+    // as they are in memory. Padding would carry stale bytes into the image.
+    template<typename Writer, typename Container>
+    void PutAll(Writer& writer, const Container& items) {
+        using T = typename Container::value_type;
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain structs are copied as bytes");
+        writer.Put((uint32_t)items.size());
+        for (const T& item : items) writer.Put(item);
+    }
+
+    template<typename Container>
+    bool GetAll(ByteReader& reader, Container& items) {
+        using T = typename Container::value_type;
+        uint32_t count = reader.Get<uint32_t>();
+        if (!reader.Ok() || count > reader.Remaining() / sizeof(T)) return false;
+        items.clear();
+        for (uint32_t i = 0; i < count; i++) items.push_back(reader.Get<T>());
+        return true;
+    }
+
+    template<typename T>
+    void Get(ByteReader& reader, T& value) { value = reader.Get<T>(); }
+
+    // One value per line, under the name of its section
+    class TextWriter {
+    public:
+        explicit TextWriter(FILE* file) : file(file) {}
+
+        void Section(const char* name) { fprintf(file, "%s\n", name); }
+
+        template<typename T>
+        void Put(const T& value) {
+            if constexpr (std::is_same<T, bool>::value) {
+                fprintf(file, "  %s\n", value ? "true" : "false");
+            } else if constexpr (std::is_floating_point<T>::value) {
+                fprintf(file, "  %.9g\n", (double)value);
+            } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+                fprintf(file, "  %lld\n", (long long)value);
+            } else if constexpr (std::is_same<T, Vector2>::value) {
+                fprintf(file, "  %.9g %.9g\n", value.x, value.y);
+            } else if constexpr (std::is_same<T, Rectangle>::value) {
+                fprintf(file, "  %.9g %.9g %.9g %.9g\n", value.x, value.y, value.width, value.height);
+            } else if constexpr (std::is_same<T, SimVec2>::value) {
+                Put(value.x);
+                Put(value.y);
+            } else {
+                // Fixed-point scalars, RNG state, queued spawns
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+                fputs(" ", file);
+                for (size_t i = 0; i < sizeof(T); i++) fprintf(file, " %02x", bytes[i]);
+                fputs("\n", file);
+            }
+        }
+        void PutU8(int value) { Put((uint8_t)value); }
+
+    private:
+        FILE* file;
+    };
+
+    // Only dumps are split into sections
+    template<typename Writer>
+    void Section(Writer&, const char*) {}
+    void Section(TextWriter& writer, const char* name) { writer.Section(name); }
+}
+
+template<typename Writer>
+void StateSerializer::Write(const Simulation& simulation, Writer& writer, Mode mode) {
+    Section(writer, "simulation");
+    writer.Put(simulation.currentAmmo);
+    writer.Put(simulation.ammoRechargeTimer);
+    writer.Put(simulation.isGameOver);
+    writer.Put(GameRandom::GetState());
+
+    Section(writer, "helicopter");
+    const Helicopter& heli = simulation.helicopter;
+    writer.Put(heli.position);
+    writer.Put(heli.velocity);
+    writer.Put(heli.hasStarted);
+    writer.Put(heli.facingRight);
+    writer.Put(heli.animationTimer);
+
+    Section(writer, "level");
+    const Level& level = *simulation.level;
+    // Text pointers only mean something inside this process
+    if (mode == Mode::Image) PutAll(writer, level.levelTexts);
+    else writer.Put((uint32_t)level.levelTexts.size());
+    if (mode == Mode::Hash) {
+        // Stand-ins for the pieces: what was generated or broken, and how
+        // many are still held after culling
+        writer.Put((uint32_t)level.walls.size());
+        writer.Put((uint32_t)level.triangleObstacles.size());
+        writer.Put((uint32_t)level.obstacles.size());
+    } else {
+        writer.Put((uint32_t)level.walls.size());
+        for (const auto& wall : level.walls) {
+            writer.Put(wall.rect);
+            writer.Put(wall.weakSpot);
+            writer.Put(wall.active);
+        }
+        writer.Put((uint32_t)level.triangleObstacles.size());
+        for (const auto& triangle : level.triangleObstacles) {
+            writer.Put(triangle.p1);
+            writer.Put(triangle.p2);
+            writer.Put(triangle.p3);
+            writer.Put(triangle.active);
+        }
+        PutAll(writer, level.obstacles);
+    }
+    writer.Put(level.startPad);
+    writer.Put(level.distanceTraveled);
+    writer.Put(level.lastY);
+    writer.Put(level.targetY);
+    writer.Put(level.stepsToTarget);
+    writer.Put(level.currentGapHeight);
+    writer.Put(level.lastWallX);
+    writer.Put(level.obstaclesAdded);
+    writer.Put(level.trianglesAdded);
+    writer.Put(level.wallsAdded);
+    writer.Put(level.columnsAdded);
+    writer.Put(level.pieceHash);
+
+    Section(writer, "missiles");
+    const EntityManager& entities = *simulation.entityManager;
+    writer.Put((uint32_t)entities.missiles.size());
+    for (const auto& m : entities.missiles) {
+        writer.PutU8((int)m->GetType());
+        writer.Put(m->position);
+        writer.Put(m->startPos);
+        writer.Put(m->active);
+        writer.Put(m->id);
+        writer.Put(m->ticksAlive);
+        writer.Put(m->rotation);
+        writer.Put(m->speed);
+        switch (m->GetType()) {
+            case MissileType::Oscillator: {
+                const auto& o = static_cast<const OscillatorMissile&>(*m);
+                writer.Put(o.amplitude);
+                writer.Put(o.frequency);
+                break;
+            }
+            case MissileType::Looper: {
+                const auto& l = static_cast<const LooperMissile&>(*m);
+                writer.Put(l.loopRadius);
+                writer.Put(l.loopSpeed);
+                break;
+            }
+            case MissileType::Seeker: {
+                const auto& s = static_cast<const SeekerMissile&>(*m);
+                writer.Put(s.baseY);
+                writer.Put(s.verticalVelocity);
+                break;
+            }
+            default: break;
+        }
+    }
+
+    Section(writer, "projectiles");
+    writer.Put((uint32_t)entities.projectiles.size());
+    for (const auto& p : entities.projectiles) {
+        writer.Put(p.position);
+        writer.Put(p.previousPosition);
+        writer.Put(p.velocity);
+        writer.Put(p.active);
+        writer.Put(p.id);
+        writer.Put(p.isMovingRight);
+        writer.Put(p.radius);
+    }
+    Section(writer, "rocks");
+    writer.Put((uint32_t)entities.rocks.size());
+    for (const auto& r : entities.rocks) {
+        writer.Put(r.position);
+        writer.Put(r.radius);
+        writer.Put(r.active);
+        writer.Put(r.id);
+    }
+    Section(writer, "explosions");
+    writer.Put((uint32_t)entities.explosions.size());
+    for (const auto& e : entities.explosions) {
+        writer.Put(e.position);
+        writer.Put(e.timer);
+        writer.Put(e.active);
+        writer.Put(e.id);
+    }
+    writer.Put(entities.nextId);
+    writer.Put(entities.dropped);
+
+    Section(writer, "spawn scheduler");
+    const SpawnScheduler& scheduler = simulation.spawnScheduler;
+    PutAll(writer, scheduler.timeQueue);
+    PutAll(writer, scheduler.distanceQueue);
+    writer.Put((uint32_t)scheduler.scripts.size());
+    for (const auto& script : scheduler.scripts) {
+        writer.Put(script.wave);
+        writer.Put(script.pc);
+        writer.Put(script.clock);
+        PutAll(writer, script.loops);
+    }
+    writer.Put(scheduler.time);
+    writer.Put(scheduler.sequence);
+}
+
+void StateSerializer::Save(const Simulation& simulation, std::vector<uint8_t>& out) {
+    out.clear();
+    ByteWriter writer(out);
+    writer.Put(Magic);
+    Write(simulation, writer, Mode::Image);
+}
+
+uint64_t StateSerializer::Hash(const Simulation& simulation) {
+    StateHash hash;
+    Write(simulation, hash, Mode::Hash);
+    return hash.Get();
+}
+
+void StateSerializer::Dump(const Simulation& simulation, FILE* file) {
+    TextWriter writer(file);
+    Write(simulation, writer, Mode::Dump);
+}
+
+bool StateSerializer::Load(Simulation& simulation, const uint8_t* data, size_t size) {
+    ByteReader reader(data, size);
+    if (reader.Get<uint32_t>() != Magic) return false;
+
+    Get(reader, simulation.currentAmmo);
+    Get(reader, simulation.ammoRechargeTimer);
+    Get(reader, simulation.isGameOver);
+    // The RNG goes back last: creating missiles below may draw from it
+    GameRandom::State random = reader.Get<GameRandom::State>();
+
+    Helicopter& heli = simulation.helicopter;
+    Get(reader, heli.position);
+    Get(reader, heli.velocity);
+    Get(reader, heli.hasStarted);
+    Get(reader, heli.facingRight);
+    Get(reader, heli.animationTimer);
+
+    Level& level = *simulation.level;
+    if (!GetAll(reader, level.levelTexts)) return false;
+    level.walls.clear();
+    uint32_t wallCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < wallCount && reader.Ok(); i++) {
+        Level::Wall wall;
+        Get(reader, wall.rect);
+        Get(reader, wall.weakSpot);
+        Get(reader, wall.active);
+        level.walls.push_back(wall);
+    }
+    level.triangleObstacles.clear();
+    uint32_t triangleCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < triangleCount && reader.Ok(); i++) {
+        Level::TriangleObstacle triangle;
+        Get(reader, triangle.p1);
+        Get(reader, triangle.p2);
+        Get(reader, triangle.p3);
+        Get(reader, triangle.active);
+        level.triangleObstacles.push_back(triangle);
+    }
+    if (!GetAll(reader, level.obstacles)) return false;
+    Get(reader, level.startPad);
+    Get(reader, level.distanceTraveled);
+    Get(reader, level.lastY);
+    Get(reader, level.targetY);
+    Get(reader, level.stepsToTarget);
+    Get(reader, level.currentGapHeight);
+    Get(reader, level.lastWallX);
+    Get(reader, level.obstaclesAdded);
+    Get(reader, level.trianglesAdded);
+    Get(reader, level.wallsAdded);
+    Get(reader, level.columnsAdded);
+    Get(reader, level.pieceHash);
+
+    EntityManager& entities = *simulation.entityManager;
+    entities.missiles.clear();
+    uint32_t missileCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < missileCount && reader.Ok(); i++) {
+        MissileType type = (MissileType)reader.GetU8();
+        if (type == MissileType::Random || type > MissileType::Seeker) return false;
+        std::unique_ptr<Missile> m = MissileFactory::Create(type, Vector2{0, 0});
+        Get(reader, m->position);
+        Get(reader, m->startPos);
+        Get(reader, m->active);
+        Get(reader, m->id);
+        Get(reader, m->ticksAlive);
+        Get(reader, m->rotation);
+        Get(reader, m->speed);
+        switch (type) {
+            case MissileType::Oscillator: {
+                auto& o = static_cast<OscillatorMissile&>(*m);
+                Get(reader, o.amplitude);
+                Get(reader, o.frequency);
+                break;
+            }
+            case MissileType::Looper: {
+                auto& l = static_cast<LooperMissile&>(*m);
+                Get(reader, l.loopRadius);
+                Get(reader, l.loopSpeed);
+                break;
+            }
+            case MissileType::Seeker: {
+                auto& s = static_cast<SeekerMissile&>(*m);
+                Get(reader, s.baseY);
+                Get(reader, s.verticalVelocity);
+                break;
+            }
+            default: break;
+        }
+        entities.missiles.push_back(std::move(m));
+    }
+
+    entities.projectiles.clear();
+    uint32_t projectileCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < projectileCount && reader.Ok(); i++) {
+        Projectile p(Vector2{0, 0}, Vector2{0, 0}, true);
+        Get(reader, p.position);
+        Get(reader, p.previousPosition);
+        Get(reader, p.velocity);
+        Get(reader, p.active);
+        Get(reader, p.id);
+        Get(reader, p.isMovingRight);
+        Get(reader, p.radius);
+        entities.projectiles.push_back(p);
+    }
+    entities.rocks.clear();
+    uint32_t rockCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < rockCount && reader.Ok(); i++) {
+        Rock r(Vector2{0, 0}, 0.0f);
+        Get(reader, r.position);
+        Get(reader, r.radius);
+        Get(reader, r.active);
+        Get(reader, r.id);
+        entities.rocks.push_back(r);
+    }
+    entities.explosions.clear();
+    uint32_t explosionCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < explosionCount && reader.Ok(); i++) {
+        Explosion e(Vector2{0, 0});
+        Get(reader, e.position);
+        Get(reader, e.timer);
+        Get(reader, e.active);
+        Get(reader, e.id);
+        entities.explosions.push_back(e);
+    }
+    Get(reader, entities.nextId);
+    Get(reader, entities.dropped);
+    entities.bursts.clear();
+
+    SpawnScheduler& scheduler = simulation.spawnScheduler;
+    if (!GetAll(reader, scheduler.timeQueue) || !GetAll(reader, scheduler.distanceQueue)) return false;
+    uint32_t scriptCount = reader.Get<uint32_t>();
+    if (!reader.Ok() || scriptCount > reader.Remaining()) return false;
+    scheduler.scripts.resize(scriptCount);
+    for (auto& script : scheduler.scripts) {
+        Get(reader, script.wave);
+        Get(reader, script.pc);
+        Get(reader, script.clock);
+        if (!GetAll(reader, script.loops)) return false;
+    }
+    Get(reader, scheduler.time);
+    Get(reader, scheduler.sequence);
+
+    GameRandom::SetState(random);
+    return reader.Ok();
+}
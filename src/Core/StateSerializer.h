@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class Simulation;
+
+// Flat binary image of everything a Simulation needs to carry on from the
+// tick it was taken at: helicopter, level pieces and generator state, every
+// entity, the spawn scheduler, ammo and the gameplay RNG. The tick and run
+// counters are not part of it. Tutorial text pointers are stored as-is, so
+// an image is only valid in the process that wrote it.
+class StateSerializer {
+public:
+    // Replaces the contents of `out`
+    static void Save(const Simulation& simulation, std::vector<uint8_t>& out);
+    // Returns false, leaving the simulation in an unspecified state, if the
+    // image is malformed. The level's collision mask and terrain history are
+    // not touched; call Level::RebuildOccupancy() before the next tick that
+    // queries or extends them.
+    static bool Load(Simulation& simulation, const uint8_t* data, size_t size);
+
+    // StateHash of the same state, to check that two runs or two builds
+    // agree. The level's pieces enter through its rolling hash of what was
+    // generated and broken instead of being walked, and text pointers are
+    // left out, so the value is comparable between processes.
+    //
+    // Entities are rescanned on every call. Each one moves on every tick, so
+    // a rolling hash would have to rehash all of them each tick whether or
+    // not the tick is hashed; the rescan costs the same when hashing every
+    // tick and nothing on the ticks in between (about 40 ns a hash).
+    static uint64_t Hash(const Simulation& simulation);
+    // Readable listing for diffing two states; like Hash() it leaves text
+    // pointers out
+    static void Dump(const Simulation& simulation, FILE* file);
+
+private:
+    enum class Mode { Image, Hash, Dump };
+
+    // The one walk over the state behind Save(), Hash() and Dump()
+    template<typename Writer>
+    static void Write(const Simulation& simulation, Writer& writer, Mode mode);
+};
@@ -0,0 +1,166 @@
+#include "WaveFile.h"
+#include "raylib.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+const char* WaveFile::DefaultWaves = R"(
+wave missiles
+    wait_distance 1500
+    loop
+        wait 3
+        spawn missile random right gap
+    end
+end
+
+wave rocks
+    wait_distance 2500
+    loop
+        wait 5
+        spawn rock 15 left gap
+    end
+end
+)";
+
+namespace {
+    bool ParseNumber(const std::string& token, float& out) {
+        char* end = nullptr;
+        out = strtof(token.c_str(), &end);
+        return !token.empty() && *end == '\0';
+    }
+
+    bool ParseMissileType(const std::string& token, MissileType& out) {
+        if (token == "random") out = MissileType::Random;
+        else if (token == "standard") out = MissileType::Standard;
+        else if (token == "oscillator") out = MissileType::Oscillator;
+        else if (token == "looper") out = MissileType::Looper;
+        else if (token == "seeker") out = MissileType::Seeker;
+        else return false;
+        return true;
+    }
+
+    // tokens: spawn <missile|rock> <type|radius> <x> <y>
+    bool ParseSpawn(const std::vector<std::string>& tokens, size_t first, SpawnCommand& out) {
+        if (tokens.size() != first + 5 || tokens[first] != "spawn") return false;
+
+        const std::string& kind = tokens[first + 1];
+        if (kind == "missile") {
+            out.kind = SpawnCommand::Kind::Missile;
+            if (!ParseMissileType(tokens[first + 2], out.missileType)) return false;
+        } else if (kind == "rock") {
+            out.kind = SpawnCommand::Kind::Rock;
+            if (!ParseNumber(tokens[first + 2], out.rockRadius)) return false;
+        } else {
+            return false;
+        }
+
+        const std::string& x = tokens[first + 3];
+        if (x == "right") out.edge = SpawnCommand::Edge::Right;
+        else if (x == "left") out.edge = SpawnCommand::Edge::Left;
+        else if (ParseNumber(x, out.x)) out.edge = SpawnCommand::Edge::Absolute;
+        else return false;
+
+        const std::string& y = tokens[first + 4];
+        if (y.compare(0, 3, "gap") == 0) {
+            out.fromGap = true;
+            out.y = 0.0f;
+            return y.size() == 3 || ParseNumber(y.substr(3), out.y);
+        }
+        out.fromGap = false;
+        return ParseNumber(y, out.y);
+    }
+}
+
+void WaveFile::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (file.is_open()) {
+        std::stringstream text;
+        text << file.rdbuf();
+        if (Parse(text.str(), path)) {
+            TraceLog(LOG_INFO, "WAVES: Loaded %d waves and %d events from %s", (int)waves.size(), (int)events.size(), path.c_str());
+            return;
+        }
+    } else {
+        TraceLog(LOG_INFO, "WAVES: %s not found, using built-in waves", path.c_str());
+    }
+    Parse(DefaultWaves, "built-in");
+}
+
+bool WaveFile::Parse(const std::string& text, const std::string& source) {
+    waves.clear();
+    events.clear();
+
+    std::istringstream input(text);
+    std::string line;
+    int lineNumber = 0;
+    Wave* wave = nullptr;
+    std::vector<int> openBlocks; // Repeat ops awaiting their `end`
+
+    auto fail = [&](const char* message) {
+        TraceLog(LOG_WARNING, "WAVES: %s:%d: %s", source.c_str(), lineNumber, message);
+        waves.clear();
+        events.clear();
+        return false;
+    };
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream words(line);
+        std::vector<std::string> tokens;
+        for (std::string token; words >> token; ) tokens.push_back(token);
+        if (tokens.empty()) continue;
+        const std::string& keyword = tokens[0];
+
+        if (!wave) {
+            if (keyword == "wave" && tokens.size() == 2) {
+                waves.push_back({tokens[1], {}});
+                wave = &waves.back();
+            } else if ((keyword == "at" || keyword == "at_distance") && tokens.size() >= 2) {
+                Event event;
+                event.byDistance = keyword == "at_distance";
+                if (!ParseNumber(tokens[1], event.key)) return fail("expected a number");
+                if (!ParseSpawn(tokens, 2, event.spawn)) return fail("malformed spawn");
+                events.push_back(event);
+            } else {
+                return fail("expected 'wave', 'at' or 'at_distance'");
+            }
+            continue;
+        }
+
+        Op op;
+        if (keyword == "wait" || keyword == "wait_distance") {
+            op.code = keyword == "wait" ? Op::Code::Wait : Op::Code::WaitDistance;
+            if (tokens.size() != 2 || !ParseNumber(tokens[1], op.value)) return fail("expected a number");
+        } else if (keyword == "spawn") {
+            op.code = Op::Code::Spawn;
+            if (!ParseSpawn(tokens, 0, op.spawn)) return fail("malformed spawn");
+        } else if (keyword == "repeat" || keyword == "loop") {
+            op.code = Op::Code::Repeat;
+            op.count = -1;
+            float count = 0.0f;
+            if (keyword == "repeat") {
+                if (tokens.size() != 2 || !ParseNumber(tokens[1], count) || count < 0) return fail("expected a repeat count");
+                op.count = (int)count;
+            }
+            openBlocks.push_back((int)wave->ops.size());
+        } else if (keyword == "end") {
+            if (openBlocks.empty()) {
+                wave = nullptr; // Closes the wave
+                continue;
+            }
+            op.code = Op::Code::End;
+            op.jump = openBlocks.back();
+            wave->ops[op.jump].jump = (int)wave->ops.size();
+            openBlocks.pop_back();
+        } else {
+            return fail("unknown instruction");
+        }
+        wave->ops.push_back(op);
+    }
+
+    if (wave) return fail("missing 'end'");
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "MissileFactory.h"
+#include <string>
+#include <vector>
+
+// What to spawn and where. Positions can follow the cave: `gap` is the
+// vertical center of the passage at the right edge of the screen.
+struct SpawnCommand {
+    enum class Kind { Missile, Rock };
+    enum class Edge { Right, Left, Absolute };
+
+    Kind kind = Kind::Missile;
+    MissileType missileType = MissileType::Random;
+    float rockRadius = 15.0f;
+    Edge edge = Edge::Right;
+    float x = 0.0f;         // Used with Edge::Absolute
+    bool fromGap = true;    // y is an offset from the gap center
+    float y = 0.0f;
+};
+
+// Enemy waves loaded from a text file (see assets/waves.txt).
+//
+// Top-level `at <seconds> spawn ...` and `at_distance <px> spawn ...` lines
+// are one-shot events. A `wave <name> ... end` block is a script that runs
+// like a coroutine: it executes until it hits `wait <seconds>` or
+// `wait_distance <px>` and is resumed by the scheduler when that time comes.
+// `repeat <n> ... end` and `loop ... end` repeat a block.
+//
+//   spawn missile <random|standard|oscillator|looper|seeker> <right|left|x> <gap|gap+N|gap-N|y>
+//   spawn rock <radius> <right|left|x> <gap|gap+N|gap-N|y>
+class WaveFile {
+public:
+    struct Op {
+        enum class Code { Wait, WaitDistance, Spawn, Repeat, End };
+        Code code;
+        float value = 0.0f;     // Wait seconds / distance
+        int count = 0;          // Repeat count, -1 for loop
+        int jump = 0;           // Repeat: index of its End; End: index of its Repeat
+        SpawnCommand spawn;
+    };
+
+    struct Wave {
+        std::string name;
+        std::vector<Op> ops;
+    };
+
+    struct Event {
+        bool byDistance;
+        float key;
+        SpawnCommand spawn;
+    };
+
+    // Falls back to the built-in waves if the file is missing or invalid
+    void Load(const std::string& path);
+    // Returns false (and logs the line) on a syntax error
+    bool Parse(const std::string& text, const std::string& source);
+
+    const std::vector<Wave>& GetWaves() const { return waves; }
+    const std::vector<Event>& GetEvents() const { return events; }
+
+    // The original pacing: a missile every 3 s past 1500 px, a rock every 5 s past 2500 px
+    static const char* DefaultWaves;
+
+private:
+    std::vector<Wave> waves;
+    std::vector<Event> events;
+};
@@ -1,8 +1,36 @@
 #include "Game.h"
+#include "LaunchOptions.h"
+#include "JobSystem.h"
+#include "Benchmarks.h"
+#include "SoakTest.h"
+#include "Replay.h"
+#include "RunAnalysis.h"
 
-int main() {
-    Game game;
-    game.Init();
-    game.Run();
-    return 0;
+int main(int argc, char** argv) {
+    LaunchOptions options = LaunchOptions::Parse(argc, argv);
+    Jobs::Start(options.jobs >= 0 ? options.jobs : Jobs::DefaultWorkerCount());
+
+    int exitCode;
+    if (options.benchJobs) {
+        exitCode = Benchmarks::RunJobs();
+    } else if (options.benchParticles) {
+        exitCode = Benchmarks::RunParticles();
+    } else if (options.benchPost) {
+        exitCode = Benchmarks::RunPost();
+    } else if (!options.analyzeDir.empty()) {
+        exitCode = RunAnalysis::Run(options.analyzeDir.c_str(), options.analyzeOut.c_str());
+    } else if (!options.bisectFile.empty()) {
+        exitCode = Replay::Bisect(options.bisectFile.c_str(), options.againstExe.c_str());
+    } else if (!options.replayFile.empty() && !options.headless) {
+        exitCode = Replay::Run(options.replayFile.c_str(), options.hashEvery, options.stopAt, options.dumpFile.c_str());
+    } else if (options.soakTicks > 0) {
+        exitCode = SoakTest::Run(options.soakTicks, options.hasSeed ? options.seed : 1);
+    } else {
+        Game game;
+        game.Init(options);
+        exitCode = game.Run();
+    }
+
+    Jobs::Stop();
+    return exitCode;
 }
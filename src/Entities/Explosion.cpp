@@ -1,24 +1,25 @@
 #include "Explosion.h"
+#include "DrawList.h"
 
 Explosion::Explosion(Vector2 pos) 
     : position(pos), timer(0.5f), active(true) {
 }
 
-void Explosion::Update() {
+void Explosion::Update(float dt) {
     if (!active) return;
 
-    timer -= GetFrameTime();
+    timer -= dt;
     if (timer <= 0) {
         active = false;
     }
 }
 
-void Explosion::Draw() const {
+void Explosion::Draw(DrawList& list) const {
     if (!active) return;
 
     float radius = (0.5f - timer) * 80.0f; // Expand
     Color col = (timer > 0.25f) ? ORANGE : YELLOW; // Fade color
     col.a = (unsigned char)(timer * 2.0f * 255.0f); // Fade alpha
     
-    DrawCircle((int)position.x, (int)position.y, radius, col);
+    list.Circle(Vector2{(float)(int)position.x, (float)(int)position.y}, radius, col);
 }
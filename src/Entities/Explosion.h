@@ -1,16 +1,27 @@
 #pragma once
 #include "raylib.h"
 
+class DrawList;
+
 class Explosion {
+    friend class SpectatorDecoder;
+    friend class StateSerializer;
+
 public:
     Explosion(Vector2 pos);
     
-    void Update();
-    void Draw() const;
+    void Update(float dt);
+    void Draw(DrawList& list) const;
     bool IsActive() const { return active; }
+    // Assigned by EntityManager; identifies the explosion across snapshots
+    unsigned int GetId() const { return id; }
+    void SetId(unsigned int value) { id = value; }
+    Vector2 GetPosition() const { return position; }
+    float GetTimer() const { return timer; }
 
 private:
     Vector2 position;
     float timer; // Lifetime timer
     bool active;
+    unsigned int id = 0;
 };
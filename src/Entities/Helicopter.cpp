@@ -1,4 +1,5 @@
 #include "Helicopter.h"
+#include "DrawList.h"
 #include "Constants.h"
 #include <cmath>
 
@@ -39,45 +40,49 @@ static const std::vector<Shape> RightShapes = {
     {ELLIPSE, {(float)HELI_WIDTH - 10, 5, 8, 6}, LIGHTGRAY, NONE, 0.0f}
 };
 
+// Built once; GetHitbox() only moves them
+static const CompositeHitbox LeftHitbox = CompositeHitbox::FromShapes(LeftShapes);
+static const CompositeHitbox RightHitbox = CompositeHitbox::FromShapes(RightShapes);
+
 void Helicopter::Init(Vector2 startPos) {
     Reset(startPos);
 }
 
 void Helicopter::Reset(Vector2 startPos) {
-    position = startPos;
-    velocity = {0, 0};
+    position = SimVec2::From(startPos);
+    velocity = {};
     hasStarted = false;
     facingRight = true;
     animationTimer = 0.0f;
 }
 
-void Helicopter::Update() {
+void Helicopter::Update(const InputFrame& input, float dt) {
     // Input handling
     bool inputGiven = false;
 
-    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) {
-        velocity.y -= Constants::Helicopter::Thrust;
+    if (input.up) {
+        velocity.y -= Scalar(Constants::Helicopter::Thrust);
         inputGiven = true;
     }
-    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) {
-        velocity.x -= 0.2f;
+    if (input.left) {
+        velocity.x -= Scalar(0.2f);
         inputGiven = true;
         facingRight = false;
     }
-    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) {
-        velocity.x += 0.2f;
+    if (input.right) {
+        velocity.x += Scalar(0.2f);
         inputGiven = true;
         facingRight = true;
     }
 
     if (inputGiven) hasStarted = true;
     
-    if (hasStarted) animationTimer += GetFrameTime();
+    if (hasStarted) animationTimer += dt;
 
     if (!hasStarted) return;
 
     // Apply gravity
-    velocity.y += Constants::Helicopter::Gravity;
+    velocity.y += Scalar(Constants::Helicopter::Gravity);
 
     // Apply velocity
     position.x += velocity.x;
@@ -88,18 +93,19 @@ void Helicopter::Update() {
         position.x = 0;
         velocity.x = 0;
     }
-    if (position.x > Constants::ScreenWidth - Constants::Helicopter::Width) {
-        position.x = Constants::ScreenWidth - Constants::Helicopter::Width;
+    if (position.x > Scalar(Constants::ScreenWidth - Constants::Helicopter::Width)) {
+        position.x = Scalar(Constants::ScreenWidth - Constants::Helicopter::Width);
         velocity.x = 0;
     }
 
     // Simple friction/drag
-    velocity.x *= 0.98f;
-    velocity.y *= 0.98f;
+    velocity.x *= Scalar(0.98f);
+    velocity.y *= Scalar(0.98f);
 }
 
-void Helicopter::Draw() {
+void Helicopter::Draw(DrawList& list) const {
     const std::vector<Shape>& currentParts = facingRight ? RightShapes : LeftShapes;
+    list.SetLayer(DrawLayer::Helicopter);
 
     for (const auto& shape : currentParts) {
         Shape shapeToDraw = shape; // Copy to allow modification for animation
@@ -118,20 +124,24 @@ void Helicopter::Draw() {
             shapeToDraw.rect.x += (originalWidth - newWidth) / 2.0f;
             shapeToDraw.rect.width = newWidth;
             
-            shapeToDraw.Draw(position);
+            shapeToDraw.Draw(list, position.ToVector2());
         } 
         else if (shape.id == TAIL_ROTOR) {
             float speed = 800.0f; 
             float angle = fmod(animationTimer * speed, 360.0f);
 
             shapeToDraw.rotation = angle;
-            shapeToDraw.Draw(position);
+            shapeToDraw.Draw(list, position.ToVector2());
         } else {
-            shapeToDraw.Draw(position);
+            shapeToDraw.Draw(list, position.ToVector2());
         }
     }
 }
 
 Rectangle Helicopter::GetRect() const {
-    return {position.x, position.y, (float)Constants::Helicopter::Width, (float)Constants::Helicopter::Height};
+    return {ToFloat(position.x), ToFloat(position.y), (float)Constants::Helicopter::Width, (float)Constants::Helicopter::Height};
+}
+
+CompositeHitbox Helicopter::GetHitbox() const {
+    return (facingRight ? RightHitbox : LeftHitbox).Translated(position.ToVector2());
 }
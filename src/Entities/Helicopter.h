@@ -1,22 +1,35 @@
 #pragma once
 #include "raylib.h"
 #include "Shape.h"
+#include "CompositeHitbox.h"
+#include "InputFrame.h"
+#include "SimScalar.h"
 #include <vector>
 
+class DrawList;
+
 class Helicopter {
+    friend class SpectatorDecoder;
+    friend class StateSerializer;
+
 public:
     void Init(Vector2 startPos);
-    void Update();
-    void Draw();
+    void Update(const InputFrame& input, float dt);
+    void Draw(DrawList& list) const;
     void Reset(Vector2 startPos);
     Rectangle GetRect() const;
+    // Body, tail, rotors and skids as drawn, at the current position
+    CompositeHitbox GetHitbox() const;
     bool HasStarted() const { return hasStarted; }
-    Vector2 GetPosition() const { return position; }
+    Vector2 GetPosition() const { return position.ToVector2(); }
+    const SimVec2& GetSimPosition() const { return position; }
+    Vector2 GetVelocity() const { return velocity.ToVector2(); }
     bool IsFacingRight() const { return facingRight; }
+    float GetAnimationTimer() const { return animationTimer; }
 
 private:
-    Vector2 position;
-    Vector2 velocity;
+    SimVec2 position;
+    SimVec2 velocity;
     bool hasStarted;
     bool facingRight;
     float animationTimer;
@@ -2,55 +2,63 @@
 #include <cmath>
 #include "Constants.h"
 #include "raymath.h"
-#include "rlgl.h"
+#include "DrawList.h"
+#include "GameRandom.h"
 
 // --- Base Missile ---
 Missile::Missile(Vector2 startPos, Color color) 
-    : position(startPos), startPos(startPos), active(true), timeAlive(0.0f), color(color) {}
+    : position(SimVec2::From(startPos)), startPos(position), active(true), ticksAlive(0), color(color) {}
 
-void Missile::Update(Vector2 playerPos) {
-    timeAlive += 1.0f / 60.0f; 
-
-    // Deactivate if off screen
-    if (position.x < -50) active = false;
+void Missile::Update(const SimVec2& playerPos) {
+    ticksAlive++;
 }
 
-void Missile::Draw() {
+void Missile::Draw(DrawList& list, unsigned long tick) const {
     float halfWidth = width / 2.0f;
     float halfHeight = height / 2.0f;
 
-    // Body (Centered at 0,0 for local rotation)
-    Rectangle bodyRect = { 0, 0, (float)width, (float)height };
-    Vector2 bodyOrigin = { halfWidth, halfHeight }; 
-
-    // Draw missile based on rotation
-    rlPushMatrix();
-    rlTranslatef(position.x + halfWidth, position.y + halfHeight, 0); // Move to center
-    rlRotatef(rotation, 0, 0, 1); // Rotate
-
-    // Draw Body
-    DrawRectangle(-halfWidth, -halfHeight, width, height, color);
-
-    // Draw Nose Cap (Triangle at right end)
-    Vector2 p1 = { halfWidth, -halfHeight }; // Top right corner of body
-    Vector2 p2 = { halfWidth, halfHeight };  // Bottom right corner of body
-    Vector2 p3 = { halfWidth + 10, 0 };      // Tip
-    DrawTriangle(p1, p2, p3, GRAY);
-
-    // Draw Engine Fire (At left end)
-    float fireLength = 10.0f + sinf(GetTime() * 20.0f) * 5.0f; 
+    // Body-local points (centered at 0,0) rotated onto the screen, so the
+    // commands need no transform
+    Vector2 pos = position.ToVector2();
+    Vector2 center = { pos.x + halfWidth, pos.y + halfHeight };
+    float cs = cosf(rotation * DEG2RAD);
+    float sn = sinf(rotation * DEG2RAD);
+    auto place = [&](float x, float y) { return Vector2{ center.x + x * cs - y * sn, center.y + x * sn + y * cs }; };
+
+    // Body
+    float left = (float)(int)-halfWidth, top = (float)(int)-halfHeight;
+    list.Quad(place(left, top), place(left, top + height), place(left + width, top + height), place(left + width, top), color);
+
+    // Nose Cap (Triangle at right end)
+    Vector2 p1 = place(halfWidth, -halfHeight); // Top right corner of body
+    Vector2 p2 = place(halfWidth, halfHeight);  // Bottom right corner of body
+    Vector2 p3 = place(halfWidth + 10, 0);      // Tip
+    list.Triangle(p1, p2, p3, GRAY);
+
+    // Engine Fire (At left end), flickering about three times a second of simulation time
+    const int flickerTicks = 19;
+    float fireLength = 10.0f + sinf((float)(tick % flickerTicks) * 2.0f * PI / flickerTicks) * 5.0f;
     
-    Vector2 f1 = { -halfWidth, -halfHeight + 2 }; 
-    Vector2 f2 = { -halfWidth, halfHeight - 2 };
-    Vector2 f3 = { -halfWidth - fireLength, 0 };
-    DrawTriangle(f1, f3, f2, ORANGE);
-
-    rlPopMatrix();
+    Vector2 f1 = place(-halfWidth, -halfHeight + 2); 
+    Vector2 f2 = place(-halfWidth, halfHeight - 2);
+    Vector2 f3 = place(-halfWidth - fireLength, 0);
+    list.Triangle(f1, f3, f2, ORANGE);
 }
 
 Rectangle Missile::GetRect() const {
     // Include the nose cap (10px) in the collision box
-    return {position.x, position.y, (float)width + 10.0f, (float)height};
+    return {ToFloat(position.x), ToFloat(position.y), (float)width + 10.0f, (float)height};
+}
+
+CompositeHitbox Missile::GetHitbox() const {
+    // The nose cap adds 10px ahead of the body, so the box reaches 5px further forward
+    Vector2 pos = position.ToVector2();
+    float cs = cosf(rotation * DEG2RAD);
+    float sn = sinf(rotation * DEG2RAD);
+    Vector2 center = { pos.x + width / 2.0f + cs * 5.0f, pos.y + height / 2.0f + sn * 5.0f };
+    CompositeHitbox hitbox;
+    hitbox.AddOrientedBox(center, { width / 2.0f + 5.0f, height / 2.0f }, rotation);
+    return hitbox;
 }
 
 // --- Standard Missile ---
@@ -58,7 +66,7 @@ StandardMissile::StandardMissile(Vector2 startPos) : Missile(startPos, GREEN) {
     rotation = 180.0f;
 }
 
-void StandardMissile::Update(Vector2 playerPos) {
+void StandardMissile::Update(const SimVec2& playerPos) {
     Missile::Update(playerPos);
     if (!active) return;
 
@@ -67,12 +75,12 @@ void StandardMissile::Update(Vector2 playerPos) {
 
 // --- Oscillator Missile ---
 OscillatorMissile::OscillatorMissile(Vector2 startPos) : Missile(startPos, RED) {
-    amplitude = (float)GetRandomValue(40, 90);
-    frequency = (float)GetRandomValue(20, 50) / 10.0f;
+    amplitude = Scalar(GameRandom::Range(40, 90));
+    frequency = Scalar(GameRandom::Range(20, 50)) / 10;
 }
 
-void OscillatorMissile::Update(Vector2 playerPos) {
-    Vector2 oldPos = position;
+void OscillatorMissile::Update(const SimVec2& playerPos) {
+    SimVec2 oldPos = position;
     
     Missile::Update(playerPos); // Base updates timeAlive
     if (!active) return;
@@ -80,51 +88,51 @@ void OscillatorMissile::Update(Vector2 playerPos) {
     position.x -= speed;
     
     // Sine wave motion
-    float wave = sinf(timeAlive * frequency) * amplitude;
+    Scalar wave = SimSin(TimeAlive() * frequency) * amplitude;
     position.y = startPos.y + wave;
 
     // Rotation
-    float dx = position.x - oldPos.x;
-    float dy = position.y - oldPos.y;
+    float dx = ToFloat(position.x - oldPos.x);
+    float dy = ToFloat(position.y - oldPos.y);
     rotation = atan2f(dy, dx) * (180.0f / PI);
 }
 
 // --- LooperMissile ---
 LooperMissile::LooperMissile(Vector2 startPos) : Missile(startPos, PURPLE) {
-    loopRadius = (float)GetRandomValue(40, 70);
-    loopSpeed = (float)GetRandomValue(50, 80) / 10.0f;
+    loopRadius = Scalar(GameRandom::Range(40, 70));
+    loopSpeed = Scalar(GameRandom::Range(50, 80)) / 10;
     // 50% chance to flip loop direction
-    if (GetRandomValue(0, 1) == 0) loopSpeed *= -1;
+    if (GameRandom::Range(0, 1) == 0) loopSpeed *= -1;
 }
 
-void LooperMissile::Update(Vector2 playerPos) {
-    Vector2 oldPos = position;
+void LooperMissile::Update(const SimVec2& playerPos) {
+    SimVec2 oldPos = position;
 
     Missile::Update(playerPos);
     if (!active) return;
 
     // To loop back, the circular velocity must exceed linear velocity.
-    float centerX = startPos.x - (speed * 60.0f * timeAlive);
-    float radius = loopRadius;
-    float w = loopSpeed; 
-    float angle = timeAlive * w;
+    Scalar centerX = startPos.x - (speed * 60 * TimeAlive());
+    Scalar radius = loopRadius;
+    Scalar w = loopSpeed; 
+    Scalar angle = TimeAlive() * w;
 
     // Circular motion
     centerX -= radius; 
-    position.x = centerX + cosf(angle) * radius;
-    position.y = startPos.y + sinf(angle) * radius;
+    position.x = centerX + SimCos(angle) * radius;
+    position.y = startPos.y + SimSin(angle) * radius;
 
     // Rotation
-    float dx = position.x - oldPos.x;
-    float dy = position.y - oldPos.y;
+    float dx = ToFloat(position.x - oldPos.x);
+    float dy = ToFloat(position.y - oldPos.y);
     rotation = atan2f(dy, dx) * (180.0f / PI);
 }
 
 // --- Seeker Missile ---
-SeekerMissile::SeekerMissile(Vector2 startPos) : Missile(startPos, ORANGE), baseY(startPos.y), verticalVelocity(0.0f) {}
+SeekerMissile::SeekerMissile(Vector2 startPos) : Missile(startPos, ORANGE), baseY(position.y), verticalVelocity(0) {}
 
-void SeekerMissile::Update(Vector2 playerPos) {
-    Vector2 oldPos = position;
+void SeekerMissile::Update(const SimVec2& playerPos) {
+    SimVec2 oldPos = position;
 
     Missile::Update(playerPos);
     if (!active) return;
@@ -132,8 +140,8 @@ void SeekerMissile::Update(Vector2 playerPos) {
     position.x -= speed;
 
     // Seeker logic (Smooth with Inertia)
-    float accel = 0.05f;
-    float maxVel = 2.0f;
+    const Scalar accel = Scalar(0.05f);
+    const Scalar maxVel = Scalar(2);
 
     if (playerPos.y > baseY) {
         verticalVelocity += accel;
@@ -146,10 +154,10 @@ void SeekerMissile::Update(Vector2 playerPos) {
 
     baseY += verticalVelocity;
 
-    float wave = sinf(timeAlive * 8.0f) * 5.0f; 
+    Scalar wave = SimSin(TimeAlive() * 8) * 5; 
     position.y = baseY + wave;
 
-    float dx = position.x - oldPos.x;
-    float dy = position.y - oldPos.y;
+    float dx = ToFloat(position.x - oldPos.x);
+    float dy = ToFloat(position.y - oldPos.y);
     rotation = atan2f(dy, dx) * (180.0f / PI);
 }
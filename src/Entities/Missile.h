@@ -1,28 +1,58 @@
 #pragma once
 #include "raylib.h"
+#include "SimScalar.h"
+#include "Constants.h"
+#include "CompositeHitbox.h"
+#include <memory>
+
+class DrawList;
+
+enum class MissileType {
+    Random,
+    Standard,
+    Oscillator,
+    Looper,
+    Seeker
+};
 
 // Base Abstract Class
 class Missile {
+    friend class SpectatorDecoder;
+    friend class StateSerializer;
+
 public:
     Missile(Vector2 startPos, Color color);
     virtual ~Missile() = default;
 
-    virtual void Update(Vector2 playerPos); // Virtual method
-    void Draw();
+    virtual void Update(const SimVec2& playerPos); // Virtual method
+    virtual std::unique_ptr<Missile> Clone() const = 0;
+    virtual MissileType GetType() const = 0;
+    void Draw(DrawList& list, unsigned long tick) const;
+    // Unrotated box, body and nose; for culling and the spectator stream
     Rectangle GetRect() const;
+    // Body and nose turned to the missile's heading
+    CompositeHitbox GetHitbox() const;
     bool IsActive() const { return active; }
     void Deactivate() { active = false; }
+    // Assigned by EntityManager; identifies the missile across snapshots
+    unsigned int GetId() const { return id; }
+    void SetId(unsigned int value) { id = value; }
+    float GetRotation() const { return rotation; }
 
 protected:
-    Vector2 position;
-    Vector2 startPos;
+    // Seconds since launch, derived from whole ticks so it never drifts
+    Scalar TimeAlive() const { return Scalar(ticksAlive) / Constants::TargetFPS; }
+
+    SimVec2 position;
+    SimVec2 startPos;
     bool active;
-    float timeAlive;
-    float rotation = 0.0f;
+    unsigned int id = 0;
+    int ticksAlive;
+    float rotation = 0.0f; // Heading in degrees; turns the hitbox too
     Color color;
     
     // Constants
-    float speed = 5.0f; // Base speed moving left
+    Scalar speed = Scalar(5); // Base speed moving left
     int width = 30;
     int height = 10;
 };
@@ -30,33 +60,47 @@ protected:
 class StandardMissile : public Missile {
 public:
     StandardMissile(Vector2 startPos);
-    void Update(Vector2 playerPos) override;
+    void Update(const SimVec2& playerPos) override;
+    std::unique_ptr<Missile> Clone() const override { return std::make_unique<StandardMissile>(*this); }
+    MissileType GetType() const override { return MissileType::Standard; }
 };
 
 class OscillatorMissile : public Missile {
+    friend class StateSerializer;
+
 public:
     OscillatorMissile(Vector2 startPos);
-    void Update(Vector2 playerPos) override;
+    void Update(const SimVec2& playerPos) override;
+    std::unique_ptr<Missile> Clone() const override { return std::make_unique<OscillatorMissile>(*this); }
+    MissileType GetType() const override { return MissileType::Oscillator; }
 private:
-    float amplitude;
-    float frequency;
+    Scalar amplitude;
+    Scalar frequency;
 };
 
 class LooperMissile : public Missile {
+    friend class StateSerializer;
+
 public:
     LooperMissile(Vector2 startPos);
-    void Update(Vector2 playerPos) override;
+    void Update(const SimVec2& playerPos) override;
+    std::unique_ptr<Missile> Clone() const override { return std::make_unique<LooperMissile>(*this); }
+    MissileType GetType() const override { return MissileType::Looper; }
 private:
-    float loopRadius;
-    float loopSpeed;
+    Scalar loopRadius;
+    Scalar loopSpeed;
 };
 
 class SeekerMissile : public Missile {
+    friend class StateSerializer;
+
 public:
     SeekerMissile(Vector2 startPos);
-    void Update(Vector2 playerPos) override;
+    void Update(const SimVec2& playerPos) override;
+    std::unique_ptr<Missile> Clone() const override { return std::make_unique<SeekerMissile>(*this); }
+    MissileType GetType() const override { return MissileType::Seeker; }
 
 private:
-    float baseY;
-    float verticalVelocity = 0.0f;
+    Scalar baseY;
+    Scalar verticalVelocity = Scalar(0);
 };
@@ -1,4 +1,5 @@
 #include "MissileFactory.h"
+#include "GameRandom.h"
 #include <vector>
 #include <functional>
 
@@ -10,6 +11,17 @@ std::unique_ptr<Missile> MissileFactory::CreateRandomMissile(Vector2 position) {
         [](Vector2 pos) { return std::make_unique<StandardMissile>(pos); }
     };
 
-    int r = GetRandomValue(0, (int)factories.size() - 1);
+    int r = GameRandom::Range(0, (int)factories.size() - 1);
     return factories[r](position);
 }
+
+std::unique_ptr<Missile> MissileFactory::Create(MissileType type, Vector2 position) {
+    switch (type) {
+        case MissileType::Standard: return std::make_unique<StandardMissile>(position);
+        case MissileType::Oscillator: return std::make_unique<OscillatorMissile>(position);
+        case MissileType::Looper: return std::make_unique<LooperMissile>(position);
+        case MissileType::Seeker: return std::make_unique<SeekerMissile>(position);
+        case MissileType::Random: break;
+    }
+    return CreateRandomMissile(position);
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include "Missile.h"
 #include <memory>
 #include <functional>
@@ -7,4 +8,5 @@
 class MissileFactory {
 public:
     static std::unique_ptr<Missile> CreateRandomMissile(Vector2 position);
+    static std::unique_ptr<Missile> Create(MissileType type, Vector2 position);
 };
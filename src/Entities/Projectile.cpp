@@ -1,16 +1,19 @@
 #include "Projectile.h"
+#include "DrawList.h"
 
 using PhysConst = Constants::Physics;
 
 Projectile::Projectile(Vector2 startPos, Vector2 initialVelocity, bool isMovingRight) 
-    : position(startPos), velocity(initialVelocity), active(true), radius(5.0f), isMovingRight(isMovingRight) {
+    : position(SimVec2::From(startPos)), previousPosition(position), velocity(SimVec2::From(initialVelocity)), active(true), radius(5.0f), isMovingRight(isMovingRight) {
 }
 
 void Projectile::Update() {
     if (!active) return;
 
+    previousPosition = position;
+
     // Apply gravity
-    velocity.y += PhysConst::ProjectileGravity; 
+    velocity.y += Scalar(PhysConst::ProjectileGravity);
     
     // Apply velocity
     if (isMovingRight) {
@@ -19,19 +22,16 @@ void Projectile::Update() {
         position.x -= velocity.x;
     }
     position.y += velocity.y;
-
-    // Out of bounds check (simple)
-    if (position.x > Constants::ScreenWidth + 50 || position.y > Constants::ScreenHeight + 50) {
-        active = false;
-    }
+    // Leaving the screen is handled by EntityManager's world bounds pass
 }
 
-void Projectile::Draw() const {
+void Projectile::Draw(DrawList& list) const {
     if (active) {
-        DrawCircleV(position, radius, YELLOW);
+        list.Circle(position.ToVector2(), radius, YELLOW);
     }
 }
 
 Rectangle Projectile::GetRect() const {
-    return { position.x - radius, position.y - radius, radius * 2, radius * 2 };
+    Vector2 pos = position.ToVector2();
+    return { pos.x - radius, pos.y - radius, radius * 2, radius * 2 };
 }
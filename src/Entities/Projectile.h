@@ -1,22 +1,35 @@
 #pragma once
 #include "raylib.h"
 #include "Constants.h"
+#include "SimScalar.h"
+
+class DrawList;
 
 class Projectile {
+    friend class StateSerializer;
+
 public:
     Projectile(Vector2 startPos, Vector2 initialVelocity, bool isMovingRight);
     
     void Update();
-    void Draw() const;
+    void Draw(DrawList& list) const;
     Rectangle GetRect() const;
     bool IsActive() const { return active; }
     void Deactivate() { active = false; }
-    Vector2 GetPosition() const { return position; }
+    // Assigned by EntityManager; identifies the projectile across snapshots
+    unsigned int GetId() const { return id; }
+    void SetId(unsigned int value) { id = value; }
+    Vector2 GetPosition() const { return position.ToVector2(); }
+    // Position at the start of the last Update(), for swept collision
+    Vector2 GetPreviousPosition() const { return previousPosition.ToVector2(); }
+    float GetRadius() const { return radius; }
 
 private:
-    Vector2 position;
-    Vector2 velocity;
+    SimVec2 position;
+    SimVec2 previousPosition;
+    SimVec2 velocity;
     bool active;
+    unsigned int id = 0;
     bool isMovingRight;
     float radius;
 };
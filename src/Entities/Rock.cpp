@@ -1,25 +1,28 @@
 #include "Rock.h"
+#include "DrawList.h"
 
 using PhysConst = Constants::Physics;
 
-Rock::Rock(Vector2 pos, float radius) : position(pos), active(true), radius(radius) {
+Rock::Rock(Vector2 pos, float radius) : position(SimVec2::From(pos)), active(true), radius(radius) {
 }
 
 void Rock::Update() {
     if (!active) return;
 
-    position.x += PhysConst::RockSpeed;
+    position.x += Scalar(PhysConst::RockSpeed);
 }
 
-void Rock::Draw() const {
+void Rock::Draw(DrawList& list) const {
     if (active) {
         // Draw a few ellipses to simulate a rock
-        DrawCircleV(position, radius, BROWN);
-        DrawCircleV(position, radius * 0.8f, BROWN);
-        DrawCircleV(position, radius * 0.6f, BROWN);
+        Vector2 pos = position.ToVector2();
+        list.Circle(pos, radius, BROWN);
+        list.Circle(pos, radius * 0.8f, BROWN);
+        list.Circle(pos, radius * 0.6f, BROWN);
     }
 }
 
 Rectangle Rock::GetRect() const {
-    return { position.x - radius, position.y - radius, radius * 2, radius * 2 };
+    Vector2 pos = position.ToVector2();
+    return { pos.x - radius, pos.y - radius, radius * 2, radius * 2 };
 }
\ No newline at end of file
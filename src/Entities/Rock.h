@@ -1,20 +1,30 @@
 #pragma once
 #include "raylib.h"
 #include "Constants.h"
+#include "SimScalar.h"
+
+class DrawList;
 
 class Rock {
+    friend class StateSerializer;
+
 public:
     Rock(Vector2 pos, float radius);
     
     void Update();
-    void Draw() const;
+    void Draw(DrawList& list) const;
     Rectangle GetRect() const;
     bool IsActive() const { return active; }
     void Deactivate() { active = false; }
-    Vector2 GetPosition() const { return position; }
+    // Assigned by EntityManager; identifies the rock across snapshots
+    unsigned int GetId() const { return id; }
+    void SetId(unsigned int value) { id = value; }
+    Vector2 GetPosition() const { return position.ToVector2(); }
+    float GetRadius() const { return radius; }
 
 private:
-    Vector2 position;
+    SimVec2 position;
     float radius;
     bool active;
+    unsigned int id = 0;
 };
\ No newline at end of file
@@ -1,15 +1,33 @@
 #pragma once
 #include "raylib.h"
+#include "DrawList.h"
 #include <vector>
 
 class BackgroundManager {
 public:
     void Init();
-    void Draw(float scrollDistance);
+    // Both parallax layers, as triangles
+    void Draw(float scrollDistance, DrawList& list);
 
 private:
     // Helper for deterministic random based on position
-    float GetDeterministicRandom(int x, int seed);
+    float GetDeterministicRandom(int x, int seed) const;
+
+    // Up to one ceiling and one floor spike per cell
+    struct Cell {
+        Vector2 tris[2][3];
+        int count = 0;
+        void Add(Vector2 a, Vector2 b, Vector2 c) {
+            tris[count][0] = a; tris[count][1] = b; tris[count][2] = c;
+            count++;
+        }
+    };
+    std::vector<Cell> cells;
+
+    // Generates the cells of one layer on the job system, then emits them in order
+    template <typename BuildFn>
+    void BuildCells(int startCell, int endCell, BuildFn build);
+    void DrawCells(Color color, DrawList& list) const;
     
     // Constants for generation
     const int CellSize = 40;
@@ -0,0 +1,186 @@
+#include "CompositeHitbox.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    float Dot(Vector2 a, Vector2 b) { return a.x * b.x + a.y * b.y; }
+    Vector2 Perp(Vector2 v) { return { -v.y, v.x }; }
+
+    void BoxCorners(const HitPart& box, Vector2* out) {
+        Vector2 u = { box.axis.x * box.extents.x, box.axis.y * box.extents.x };
+        Vector2 v = { -box.axis.y * box.extents.y, box.axis.x * box.extents.y };
+        out[0] = { box.center.x - u.x - v.x, box.center.y - u.y - v.y };
+        out[1] = { box.center.x + u.x - v.x, box.center.y + u.y - v.y };
+        out[2] = { box.center.x + u.x + v.x, box.center.y + u.y + v.y };
+        out[3] = { box.center.x - u.x + v.x, box.center.y - u.y + v.y };
+    }
+
+    // Separating axis test over the two axes of each box
+    bool BoxesOverlap(const HitPart& a, const HitPart& b) {
+        const Vector2 axes[4] = { a.axis, Perp(a.axis), b.axis, Perp(b.axis) };
+        Vector2 d = { b.center.x - a.center.x, b.center.y - a.center.y };
+        for (Vector2 axis : axes) {
+            float ra = a.extents.x * std::fabs(Dot(a.axis, axis)) + a.extents.y * std::fabs(Dot(Perp(a.axis), axis));
+            float rb = b.extents.x * std::fabs(Dot(b.axis, axis)) + b.extents.y * std::fabs(Dot(Perp(b.axis), axis));
+            if (std::fabs(Dot(d, axis)) >= ra + rb) return false;
+        }
+        return true;
+    }
+
+    // Scaled so the ellipse becomes the unit circle, the box becomes a
+    // parallelogram; they meet if the circle's center is inside it or an
+    // edge comes closer than 1
+    bool BoxEllipseOverlap(const HitPart& box, const HitPart& ellipse) {
+        Vector2 corners[4];
+        BoxCorners(box, corners);
+        for (Vector2& p : corners) {
+            p = { (p.x - ellipse.center.x) / ellipse.extents.x, (p.y - ellipse.center.y) / ellipse.extents.y };
+        }
+
+        bool inside = true;
+        for (int i = 0; i < 4; i++) {
+            Vector2 p = corners[i], q = corners[(i + 1) % 4];
+            Vector2 edge = { q.x - p.x, q.y - p.y };
+            // Corners go clockwise on screen (y down); the origin is inside if it's right of every edge
+            if (edge.x * -p.y - edge.y * -p.x < 0.0f) inside = false;
+
+            float t = std::clamp(-Dot(p, edge) / std::max(Dot(edge, edge), 1e-12f), 0.0f, 1.0f);
+            Vector2 closest = { p.x + edge.x * t, p.y + edge.y * t };
+            if (Dot(closest, closest) < 1.0f) return true;
+        }
+        return inside;
+    }
+
+    bool PartsOverlap(const HitPart& a, const HitPart& b) {
+        using Kind = HitPart::Kind;
+        if (a.kind == Kind::Box && b.kind == Kind::Box) return BoxesOverlap(a, b);
+        if (a.kind == Kind::Box) return BoxEllipseOverlap(a, b);
+        if (b.kind == Kind::Box) return BoxEllipseOverlap(b, a);
+        // Nothing pairs two ellipses yet; the second one counts as its bounds
+        Rectangle r = b.GetBounds();
+        HitPart box = { Kind::Box, { r.x + r.width / 2, r.y + r.height / 2 }, { r.width / 2, r.height / 2 } };
+        return BoxEllipseOverlap(box, a);
+    }
+
+    Rectangle Union(Rectangle a, Rectangle b) {
+        float x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+        float x1 = std::max(a.x + a.width, b.x + b.width), y1 = std::max(a.y + a.height, b.y + b.height);
+        return { x0, y0, x1 - x0, y1 - y0 };
+    }
+}
+
+Rectangle HitPart::GetBounds() const {
+    float halfW = extents.x, halfH = extents.y;
+    if (kind == Kind::Box) {
+        halfW = std::fabs(axis.x) * extents.x + std::fabs(axis.y) * extents.y;
+        halfH = std::fabs(axis.y) * extents.x + std::fabs(axis.x) * extents.y;
+    }
+    return { center.x - halfW, center.y - halfH, halfW * 2, halfH * 2 };
+}
+
+bool HitPart::SpanAt(float y, float* left, float* right) const {
+    if (kind == Kind::Ellipse) {
+        float dy = (y - center.y) / extents.y;
+        if (dy <= -1.0f || dy >= 1.0f) return false;
+        float halfWidth = extents.x * std::sqrt(1.0f - dy * dy);
+        *left = center.x - halfWidth;
+        *right = center.x + halfWidth;
+        return true;
+    }
+
+    // Where the line crosses the edges, as OccupancyMask fills triangles
+    Vector2 corners[4];
+    BoxCorners(*this, corners);
+    float lo = 1e9f, hi = -1e9f;
+    for (int i = 0; i < 4; i++) {
+        Vector2 p = corners[i], q = corners[(i + 1) % 4];
+        if ((y < p.y) == (y < q.y)) continue;
+        float x = p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y);
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+    }
+    if (lo > hi) return false;
+    *left = lo;
+    *right = hi;
+    return true;
+}
+
+CompositeHitbox CompositeHitbox::FromShapes(const std::vector<Shape>& shapes) {
+    CompositeHitbox hitbox;
+    for (const Shape& shape : shapes) {
+        // Spins inside its guard ring
+        if (shape.id == TAIL_ROTOR) continue;
+        const Rectangle& r = shape.rect;
+        switch (shape.type) {
+            case RECTANGLE:
+                hitbox.AddBox(r);
+                break;
+            case ELLIPSE:
+                // Drawn around (x, y) with the size as radii
+                hitbox.AddEllipse({ r.x, r.y }, { r.width, r.height });
+                break;
+            case RING:
+                hitbox.AddEllipse({ r.x + r.width / 2, r.y + r.width / 2 }, { r.width / 2, r.width / 2 });
+                break;
+            case TRIANGLE:
+                hitbox.AddBox(r);
+                break;
+        }
+    }
+    return hitbox;
+}
+
+void CompositeHitbox::AddBox(Rectangle rect) {
+    Add({ HitPart::Kind::Box, { rect.x + rect.width / 2, rect.y + rect.height / 2 }, { rect.width / 2, rect.height / 2 } });
+}
+
+void CompositeHitbox::AddOrientedBox(Vector2 center, Vector2 halfExtents, float degrees) {
+    Add({ HitPart::Kind::Box, center, halfExtents, { cosf(degrees * DEG2RAD), sinf(degrees * DEG2RAD) } });
+}
+
+void CompositeHitbox::AddEllipse(Vector2 center, Vector2 radii) {
+    Add({ HitPart::Kind::Ellipse, center, radii });
+}
+
+void CompositeHitbox::Add(const HitPart& part) {
+    if (count == MaxParts) {
+        TraceLog(LOG_WARNING, "HITBOX: More than %d parts, the rest is ignored", MaxParts);
+        return;
+    }
+    bounds = count == 0 ? part.GetBounds() : Union(bounds, part.GetBounds());
+    parts[count++] = part;
+}
+
+CompositeHitbox CompositeHitbox::Translated(Vector2 offset) const {
+    CompositeHitbox moved = *this;
+    for (int i = 0; i < count; i++) {
+        moved.parts[i].center.x += offset.x;
+        moved.parts[i].center.y += offset.y;
+    }
+    moved.bounds.x += offset.x;
+    moved.bounds.y += offset.y;
+    return moved;
+}
+
+bool CompositeHitbox::Overlaps(Rectangle rect) const {
+    if (!CheckCollisionRecs(bounds, rect)) return false;
+    HitPart box = { HitPart::Kind::Box, { rect.x + rect.width / 2, rect.y + rect.height / 2 }, { rect.width / 2, rect.height / 2 } };
+    for (int i = 0; i < count; i++) {
+        if (CheckCollisionRecs(parts[i].GetBounds(), rect) && PartsOverlap(parts[i], box)) return true;
+    }
+    return false;
+}
+
+bool CompositeHitbox::Overlaps(const CompositeHitbox& other) const {
+    if (!CheckCollisionRecs(bounds, other.bounds)) return false;
+    for (int i = 0; i < count; i++) {
+        Rectangle partBounds = parts[i].GetBounds();
+        if (!CheckCollisionRecs(partBounds, other.bounds)) continue;
+        for (int j = 0; j < other.count; j++) {
+            if (CheckCollisionRecs(partBounds, other.parts[j].GetBounds()) && PartsOverlap(parts[i], other.parts[j])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
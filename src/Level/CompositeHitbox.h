@@ -0,0 +1,54 @@
+#pragma once
+#include "raylib.h"
+#include "Shape.h"
+#include <cstdint>
+#include <vector>
+
+// One solid piece of a hitbox: a box turned by `axis`, or an axis-aligned ellipse
+struct HitPart {
+    enum class Kind : uint8_t { Box, Ellipse };
+
+    Kind kind;
+    Vector2 center;
+    Vector2 extents;            // Box: half width and height. Ellipse: radii.
+    Vector2 axis = { 1, 0 };    // Box: direction of its width (cos, sin)
+
+    Rectangle GetBounds() const;
+    // Where the line at height y crosses the part; false if it misses it
+    bool SpanAt(float y, float* left, float* right) const;
+};
+
+// A shape's collision geometry as a few parts under one bounding box. Tests
+// check the bounding boxes first, so a miss costs one rect test, and only
+// look at the parts when those overlap. Fixed capacity: copying one (for
+// example to move it) never allocates.
+class CompositeHitbox {
+public:
+    static constexpr int MaxParts = 12;
+
+    // Rectangles, ellipses, rings (as discs) and triangles (as their rect)
+    // of `shapes`, unrotated and at full size; animated parts are covered by
+    // their rest pose
+    static CompositeHitbox FromShapes(const std::vector<Shape>& shapes);
+
+    void AddBox(Rectangle rect);
+    void AddOrientedBox(Vector2 center, Vector2 halfExtents, float degrees);
+    void AddEllipse(Vector2 center, Vector2 radii);
+
+    CompositeHitbox Translated(Vector2 offset) const;
+
+    Rectangle GetBounds() const { return bounds; }
+    int GetPartCount() const { return count; }
+    const HitPart& GetPart(int index) const { return parts[index]; }
+
+    // Touching edges don't count as overlap, as in CheckCollisionRecs()
+    bool Overlaps(Rectangle rect) const;
+    bool Overlaps(const CompositeHitbox& other) const;
+
+private:
+    void Add(const HitPart& part);
+
+    HitPart parts[MaxParts];
+    int count = 0;
+    Rectangle bounds = {};
+};
@@ -1,17 +1,44 @@
 #include "Level.h"
+#include "GameRandom.h"
 #include "Constants.h"
+#include "StateHash.h"
+#include <algorithm>
 #include <cmath>
 
+namespace {
+    // Widest spike half-width plus its column
+    constexpr int OccupancyLookahead = 64;
+
+    template<typename... Values>
+    uint64_t Fold(uint64_t hash, const Values&... values) {
+        StateHash next(hash);
+        (next.Put(values), ...);
+        return next.Get();
+    }
+}
+
+Level::Level(std::pmr::memory_resource* resource)
+    : levelTexts(resource), walls(resource), triangleObstacles(resource), obstacles(resource) {}
+
 void Level::Init() {
     obstacles.clear();
     walls.clear();
     triangleObstacles.clear();
     levelTexts.clear();
-    distanceTraveled = 0.0f;
-    lastY = (Constants::ScreenHeight + Constants::ControlPanelHeight) / 2.0f;
+    obstaclesAdded = trianglesAdded = wallsAdded = columnsAdded = 0;
+    pieceHash = 0;
+    lastWallX = -1e6f; // No wall yet
+    distanceTraveled = Scalar(0);
+    lastY = Scalar(Constants::ScreenHeight + Constants::ControlPanelHeight) / 2;
     targetY = lastY;
     stepsToTarget = 0;
-    currentGapHeight = 300.0f; // Start wide
+    currentGapHeight = Scalar(300); // Start wide
+
+    if (!occupancy) occupancy = std::make_shared<OccupancyMask>();
+    occupancy->Clear();
+    occupancy->ClearAhead(500 + OccupancyLookahead);
+    if (!history) history = std::make_shared<TerrainHistory>();
+    history->Clear();
 
     // Initialize Start Pad
     startPad = {50, 350, 100, 20};
@@ -21,8 +48,9 @@ void Level::Init() {
         int ceilingY = Constants::ControlPanelHeight + 50; 
         int floorY = 400; 
 
-        obstacles.push_back({(float)x, (float)Constants::ControlPanelHeight, (float)Constants::TerrainStep, (float)(ceilingY - Constants::ControlPanelHeight)});
-        obstacles.push_back({(float)x, (float)floorY, (float)Constants::TerrainStep, (float)(Constants::ScreenHeight - floorY)});
+        AddObstacle({(float)x, (float)Constants::ControlPanelHeight, (float)Constants::TerrainStep, (float)(ceilingY - Constants::ControlPanelHeight)});
+        AddObstacle({(float)x, (float)floorY, (float)Constants::TerrainStep, (float)(Constants::ScreenHeight - floorY)});
+        AddColumn(ceilingY, floorY, 0);
     }
 
     // Add Tutorial Text
@@ -37,79 +65,124 @@ void Level::Init() {
 }
 
 void Level::Update() {
-    // Scroll obstacles
+    Scroll(Constants::ScrollSpeed);
+    distanceTraveled += Scalar(Constants::ScrollSpeed);
+
+    // Generate new obstacles if needed
+    // Check rightmost obstacle
+    float rightEdge = 0;
+    if (!obstacles.empty()) {
+        rightEdge = obstacles.back().x + obstacles.back().width;
+    }
+
+    if (rightEdge < Constants::ScreenWidth + 50) {
+        GenerateChunk((int)rightEdge, 100);
+    }
+}
+
+void Level::Scroll(float amount) {
     for (auto& obs : obstacles) {
-        obs.x -= Constants::ScrollSpeed;
+        obs.x -= amount;
     }
-    
-    // Scroll start pad
-    startPad.x -= Constants::ScrollSpeed;
-    
-    // Scroll texts
+    startPad.x -= amount;
     for (auto& txt : levelTexts) {
-        txt.position.x -= Constants::ScrollSpeed;
+        txt.position.x -= amount;
+    }
+    for (auto& wall : walls) {
+        wall.rect.x -= amount;
+        wall.weakSpot.x -= amount;
+    }
+    lastWallX -= amount;
+    for (auto& tri : triangleObstacles) {
+        tri.p1.x -= amount;
+        tri.p2.x -= amount;
+        tri.p3.x -= amount;
     }
 
-    // Remove off-screen texts
-    if (!levelTexts.empty() && levelTexts.front().position.x < -300) {
+    // Cull whatever left the screen
+    while (!levelTexts.empty() && levelTexts.front().position.x < -300) {
         levelTexts.pop_front();
     }
-    
-    distanceTraveled += Constants::ScrollSpeed;
-
     while (!obstacles.empty() && obstacles.front().x + obstacles.front().width < 0) {
         obstacles.pop_front();
     }
-
-    // Scroll walls
-    for (auto& wall : walls) {
-        wall.rect.x -= Constants::ScrollSpeed;
-        wall.weakSpot.x -= Constants::ScrollSpeed;
-    }
-    
-    // Cull off-screen walls
-    while (!walls.empty() && walls.front().rect.x + walls.front().rect.width < 0) {
+    // Broken walls go as soon as nothing older is left in front of them
+    while (!walls.empty() && (!walls.front().active || walls.front().rect.x + walls.front().rect.width < 0)) {
         walls.pop_front();
     }
-    
-    // Scroll Triangles
-    for (auto& tri : triangleObstacles) {
-        tri.p1.x -= Constants::ScrollSpeed;
-        tri.p2.x -= Constants::ScrollSpeed;
-        tri.p3.x -= Constants::ScrollSpeed;
-    }
-    
-    // Cull off-screen triangles
     while (!triangleObstacles.empty() && triangleObstacles.front().p3.x < 0) {
         triangleObstacles.pop_front();
     }
+}
 
-    // Generate new obstacles if needed
-    // Check rightmost obstacle
-    float rightEdge = 0;
+void Level::RebuildOccupancy() {
+    // GenerateChunk cleared up to just past the newest column, which is also the newest obstacle
+    int clearedTo = 500 + OccupancyLookahead;
     if (!obstacles.empty()) {
-        rightEdge = obstacles.back().x + obstacles.back().width;
+        clearedTo = std::max(clearedTo, ToInt(distanceTraveled) + (int)obstacles.back().x + Constants::TerrainStep + OccupancyLookahead);
     }
+    occupancy->Clear(clearedTo);
 
-    if (rightEdge < Constants::ScreenWidth + 50) {
-        GenerateChunk((int)rightEdge, 100);
+    // Pieces that already scrolled off were culled and are not redrawn; the
+    // mask is never queried that far left
+    for (const auto& obs : obstacles) occupancy->FillRect(ToWorld(obs), OccupancyMask::Layer::Terrain);
+    float offset = GetDistance();
+    for (const auto& tri : triangleObstacles) {
+        occupancy->FillTriangle({tri.p1.x + offset, tri.p1.y}, {tri.p2.x + offset, tri.p2.y}, {tri.p3.x + offset, tri.p3.y});
     }
+    for (const auto& wall : walls) {
+        if (wall.active) occupancy->FillRect(ToWorld(wall.rect), OccupancyMask::Layer::Walls);
+    }
+    history->Truncate((int)columnsAdded);
+}
+
+void Level::AddObstacle(Rectangle rect) {
+    obstacles.push_back(rect);
+    obstaclesAdded++;
+    pieceHash = Fold(pieceHash, 'O', rect);
+    occupancy->FillRect(ToWorld(rect), OccupancyMask::Layer::Terrain);
+}
+
+void Level::AddTriangle(Vector2 p1, Vector2 p2, Vector2 p3) {
+    triangleObstacles.push_back({p1, p2, p3, true});
+    trianglesAdded++;
+    pieceHash = Fold(pieceHash, 'T', p1, p2, p3);
+    float offset = GetDistance();
+    occupancy->FillTriangle({p1.x + offset, p1.y}, {p2.x + offset, p2.y}, {p3.x + offset, p3.y});
+}
+
+void Level::AddWall(Rectangle rect, Rectangle weakSpot) {
+    walls.push_back({rect, weakSpot, true});
+    wallsAdded++;
+    pieceHash = Fold(pieceHash, 'W', rect, weakSpot);
+    lastWallX = rect.x;
+    occupancy->FillRect(ToWorld(rect), OccupancyMask::Layer::Walls);
+}
+
+void Level::AddColumn(int ceilingY, int floorY, uint8_t flags) {
+    // Rock starts at the control panel and ends at the bottom of the screen
+    TerrainHistory::Column column = { (uint16_t)std::max(ceilingY, Constants::ControlPanelHeight),
+                                      (uint16_t)std::min(floorY, Constants::ScreenHeight), flags };
+    history->Append(column);
+    columnsAdded++;
 }
 
 void Level::GenerateChunk(int startX, int width) {
     for (int x = startX; x < startX + width; x += Constants::TerrainStep) {
+        // Spikes reach past their own column, so clear a little further ahead
+        occupancy->ClearAhead(ToInt(distanceTraveled) + x + Constants::TerrainStep + OccupancyLookahead);
         
         // Narrow the gap
-        if (currentGapHeight > Constants::Level::MinGapHeight) {
-            currentGapHeight -= 0.05f; // Shrink slowly
+        if (currentGapHeight > Scalar(Constants::Level::MinGapHeight)) {
+            currentGapHeight -= Scalar(0.05f); // Shrink slowly
         }
 
         // Target Logic
         stepsToTarget--;
         if (stepsToTarget <= 0) {
             // Pick new target based on CURRENT gap height, respecting Control Panel
-            int minSafe = Constants::ControlPanelHeight + (int)(currentGapHeight / 2.0f) + 50;
-            int maxSafe = Constants::ScreenHeight - (int)(currentGapHeight / 2.0f) - 50;
+            int minSafe = Constants::ControlPanelHeight + ToInt(currentGapHeight / 2) + 50;
+            int maxSafe = Constants::ScreenHeight - ToInt(currentGapHeight / 2) - 50;
             
             // Ensure bounds are valid (avoid crossing)
             if (minSafe > maxSafe) {
@@ -117,77 +190,70 @@ void Level::GenerateChunk(int startX, int width) {
                 maxSafe = (Constants::ScreenHeight + Constants::ControlPanelHeight) / 2 + 20;
             }
 
-            targetY = (float)GetRandomValue(minSafe, maxSafe);
-            stepsToTarget = GetRandomValue(30, 80);
+            targetY = Scalar(GameRandom::Range(minSafe, maxSafe));
+            stepsToTarget = GameRandom::Range(30, 80);
         }
 
         // Move towards target (Smoothing)
-        float diff = targetY - lastY;
-        float move = 0.0f;
-        if (std::abs(diff) > 1.0f) {
-             move = (diff > 0) ? 1.0f : -1.0f;
+        Scalar diff = targetY - lastY;
+        Scalar move = Scalar(0);
+        if (diff > Scalar(1) || diff < Scalar(-1)) {
+             move = (diff > Scalar(0)) ? Scalar(1) : Scalar(-1);
         } else {
              move = diff; // Snap to small diffs
         }
         
         // Very occasional noise for slight organic feel, but mostly smooth
-        if (GetRandomValue(0, 10) == 0) {
-            move += (float)GetRandomValue(-1, 1) * 0.5f;
+        if (GameRandom::Range(0, 10) == 0) {
+            move += Scalar(GameRandom::Range(-1, 1)) / 2;
         }
 
         lastY += move;
         
         // Clamp
-        float minH = Constants::ControlPanelHeight + currentGapHeight / 2.0f + 20.0f;
-        float maxH = Constants::ScreenHeight - currentGapHeight / 2.0f - 20.0f;
+        Scalar minH = Scalar(Constants::ControlPanelHeight) + currentGapHeight / 2 + Scalar(20);
+        Scalar maxH = Scalar(Constants::ScreenHeight) - currentGapHeight / 2 - Scalar(20);
         
         if (lastY < minH) lastY = minH;
         if (lastY > maxH) lastY = maxH;
 
-        int ceilingY = (int)(lastY - currentGapHeight / 2.0f);
-        int floorY = (int)(lastY + currentGapHeight / 2.0f);
+        int ceilingY = ToInt(lastY - currentGapHeight / 2);
+        int floorY = ToInt(lastY + currentGapHeight / 2);
 
         if (ceilingY > Constants::ControlPanelHeight) {
-            obstacles.push_back({(float)x, (float)Constants::ControlPanelHeight, (float)Constants::TerrainStep, (float)(ceilingY - Constants::ControlPanelHeight)});
+            AddObstacle({(float)x, (float)Constants::ControlPanelHeight, (float)Constants::TerrainStep, (float)(ceilingY - Constants::ControlPanelHeight)});
         }
         if (floorY < Constants::ScreenHeight) {
-            obstacles.push_back({(float)x, (float)floorY, (float)Constants::TerrainStep, (float)(Constants::ScreenHeight - floorY)});
+            AddObstacle({(float)x, (float)floorY, (float)Constants::TerrainStep, (float)(Constants::ScreenHeight - floorY)});
         }
         
         // Random Stalactites/Stalagmites (Obstacles)
-        if (GetRandomValue(0, 25) == 0) {
-            bool onCeiling = GetRandomValue(0, 1) == 0;
-            float triH = (float)GetRandomValue(30, 80);
-            float triW = (float)GetRandomValue(15, 30);
+        uint8_t flags = 0;
+        if (GameRandom::Range(0, 25) == 0) {
+            bool onCeiling = GameRandom::Range(0, 1) == 0;
+            flags |= onCeiling ? TerrainHistory::CeilingSpike : TerrainHistory::FloorSpike;
+            float triH = (float)GameRandom::Range(30, 80);
+            float triW = (float)GameRandom::Range(15, 30);
             
             float centerX = (float)x + Constants::TerrainStep / 2.0f;
             
             if (onCeiling) {
                  float base = (float)(ceilingY) - 15;
-                 triangleObstacles.push_back({
-                     {centerX - triW, base},
-                     {centerX, base + triH},
-                     {centerX + triW, base},
-                     true
-                 });
+                 AddTriangle({centerX - triW, base},
+                             {centerX, base + triH},
+                             {centerX + triW, base});
             } else {
                  float base = (float)(floorY) + 15;
-                 triangleObstacles.push_back({
-                     {centerX - triW, base},
-                     {centerX + triW, base},
-                     {centerX, base - triH},
-                     true
-                 });
+                 AddTriangle({centerX - triW, base},
+                             {centerX + triW, base},
+                             {centerX, base - triH});
             }
         }
         
         // Spawn walls (2% chance per step)
-        if (distanceTraveled > 500 && GetRandomValue(0, 100) < 2) { 
+        if (distanceTraveled > Scalar(500) && GameRandom::Range(0, 100) < 2) { 
              // ensure distance from last wall
-             bool canSpawn = true;
-             if (!walls.empty()) {
-                 if (x - walls.back().rect.x < 400) canSpawn = false; 
-             }
+             bool canSpawn = x - lastWallX >= 400;
              
              if (canSpawn && (floorY - ceilingY) > Constants::Level::MinGapHeight * 0.6f) {
                  float tWidth = (float)Constants::Level::TargetWidth;
@@ -199,64 +265,49 @@ void Level::GenerateChunk(int startX, int width) {
                  float gapTop = ceilingY + 20;
                  float gapHeight = (float)(floorY - ceilingY) - 40;
                  
-                 float wY = (float)GetRandomValue((int)gapTop, (int)(gapTop + gapHeight - wHeight));
+                 float wY = (float)GameRandom::Range((int)gapTop, (int)(gapTop + gapHeight - wHeight));
                  
-                 walls.push_back({{tX, tY, tWidth, tHeight}, {tX, wY, tWidth, wHeight}, true});
+                 AddWall({tX, tY, tWidth, tHeight}, {tX, wY, tWidth, wHeight});
+                 flags |= TerrainHistory::Wall;
              }
         }
+        AddColumn(ceilingY, floorY, flags);
     }
 }
 
-void Level::Draw(const Font& font) {
-    DrawRectangleRec(startPad, GRAY);
-    
-    for (const auto& txt : levelTexts) {
-        DrawTextEx(font, txt.text, txt.position, (float)txt.fontSize, 1.0f, txt.color);
-    }
-    
+void Level::Draw(DrawList& list) const {
+    list.SetLayer(DrawLayer::StartPad);
+    list.Rect(startPad, GRAY);
+
+    // Terrain is generated well past the right edge; the list culls it
+    list.SetLayer(DrawLayer::Terrain);
     for (const auto& wall : walls) {
         if (!wall.active) continue;
-        DrawRectangleRec(wall.rect, LIGHTGRAY);
-        DrawRectangleRec(wall.weakSpot, GREEN);
+        list.Rect(wall.rect, LIGHTGRAY);
+        list.Rect(wall.weakSpot, GREEN);
     }
 
     for (const auto& obs : obstacles) {
-        DrawRectangleRec(obs, BROWN);
+        list.Rect(obs, BROWN);
     }
     
     for (const auto& tri : triangleObstacles) {
-        DrawTriangle(tri.p1, tri.p2, tri.p3, BROWN);
+        list.Triangle(tri.p1, tri.p2, tri.p3, BROWN);
     }
 }
 
-bool Level::CheckCollision(Rectangle playerRect) {
-
-    for (const auto& obs : obstacles) {
-        if (CheckCollisionRecs(playerRect, obs)) {
-            return true;
-        }
-    }
-    
-    for (const auto& tri : triangleObstacles) {
-        // Approximate collision (check player corners against triangle)
-        Vector2 tl = {playerRect.x, playerRect.y};
-        Vector2 tr = {playerRect.x + playerRect.width, playerRect.y};
-        Vector2 bl = {playerRect.x, playerRect.y + playerRect.height};
-        Vector2 br = {playerRect.x + playerRect.width, playerRect.y + playerRect.height};
-        
-        if (CheckCollisionPointTriangle(tl, tri.p1, tri.p2, tri.p3) ||
-            CheckCollisionPointTriangle(tr, tri.p1, tri.p2, tri.p3) ||
-            CheckCollisionPointTriangle(bl, tri.p1, tri.p2, tri.p3) ||
-            CheckCollisionPointTriangle(br, tri.p1, tri.p2, tri.p3)) {
-            return true;        
-        }
-    }
-    
-    for (const auto& wall : walls) {
-        if (wall.active && CheckCollisionRecs(playerRect, wall.rect)) {
-            return true;
-        }
+void Level::DrawText(const Font& font, TextCache& textCache) const {
+    // Glyphs are laid out once per line; scrolling only moves them
+    int slot = 0;
+    for (const auto& txt : levelTexts) {
+        textCache.Set(slot++, font, txt.text, txt.position, (float)txt.fontSize, 1.0f, txt.color);
     }
+    textCache.Truncate(slot);
+    textCache.Draw();
+}
+
+bool Level::CheckCollision(Rectangle playerRect) const {
+    if (occupancy->Overlaps(ToWorld(playerRect))) return true;
 
     // Also check screen bounds if no obstacles generated there (e.g. initial gap)
     if (playerRect.y + playerRect.height > Constants::ScreenHeight) return true;
@@ -264,28 +315,144 @@ bool Level::CheckCollision(Rectangle playerRect) {
     return false;
 }
 
-bool Level::CheckProjectileCollision(Rectangle projRect) {
-    // Check Obstacles
+bool Level::CheckCollision(const CompositeHitbox& hitbox) const {
+    Rectangle bounds = hitbox.GetBounds();
+    if (!CheckCollision(bounds)) return false;
+    if (bounds.y + bounds.height > Constants::ScreenHeight) return true;
+
+    // One-pixel-high queries along each covered row, at the row's center line
+    for (int i = 0; i < hitbox.GetPartCount(); i++) {
+        const HitPart& part = hitbox.GetPart(i);
+        Rectangle partBounds = part.GetBounds();
+        int r0 = std::max((int)std::ceil(partBounds.y - 0.5f), 0);
+        int r1 = std::min((int)std::ceil(partBounds.y + partBounds.height - 0.5f) - 1, Constants::ScreenHeight - 1);
+        for (int row = r0; row <= r1; row++) {
+            float left, right;
+            if (!part.SpanAt(row + 0.5f, &left, &right)) continue;
+            if (occupancy->Overlaps(ToWorld({ left, (float)row, right - left, 1.0f }))) return true;
+        }
+    }
+    return false;
+}
+
+DeathCause Level::GetCollisionCause(const CompositeHitbox& hitbox) const {
+    for (const auto& wall : walls) {
+        if (wall.active && hitbox.Overlaps(wall.rect)) return DeathCause::Wall;
+    }
     for (const auto& obs : obstacles) {
-        if (CheckCollisionRecs(projRect, obs)) return true;
+        if (hitbox.Overlaps(obs)) return DeathCause::Terrain;
+    }
+    // Spikes only by their bounds; the mask may also have caught an edge
+    // pixel the exact test above misses, which counts as terrain
+    for (const auto& tri : triangleObstacles) {
+        float x0 = std::min({ tri.p1.x, tri.p2.x, tri.p3.x }), x1 = std::max({ tri.p1.x, tri.p2.x, tri.p3.x });
+        float y0 = std::min({ tri.p1.y, tri.p2.y, tri.p3.y }), y1 = std::max({ tri.p1.y, tri.p2.y, tri.p3.y });
+        if (hitbox.Overlaps(Rectangle{ x0, y0, x1 - x0, y1 - y0 })) return DeathCause::Spike;
     }
+    return DeathCause::Terrain;
+}
 
-    // Check Walls
-    for (auto& wall : walls) {
-        if (!wall.active) continue;
-        if (CheckCollisionRecs(projRect, wall.rect)) {
-            // Check Weak Spot
-            if (CheckCollisionRecs(projRect, wall.weakSpot)) {
-                wall.active = false; // Destroy!
-                return true; 
+namespace {
+    // Slab test of a segment against a box grown by `radius` on every side.
+    // Returns the entry time in [0, 1], or a negative value on a miss.
+    float SweepBox(Vector2 from, Vector2 delta, Rectangle box, float radius) {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        const float lo[2] = { box.x - radius, box.y - radius };
+        const float hi[2] = { box.x + box.width + radius, box.y + box.height + radius };
+        const float p[2] = { from.x, from.y };
+        const float d[2] = { delta.x, delta.y };
+
+        for (int axis = 0; axis < 2; axis++) {
+            if (std::fabs(d[axis]) < 1e-6f) {
+                if (p[axis] <= lo[axis] || p[axis] >= hi[axis]) return -1.0f;
+                continue;
             }
-            return true; // Wall hit
+            float t1 = (lo[axis] - p[axis]) / d[axis];
+            float t2 = (hi[axis] - p[axis]) / d[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin >= tMax) return -1.0f;
         }
+        return tMin;
+    }
+
+    // Box around both, grown a little so rounding never leaves a pixel out
+    Rectangle Cover(Rectangle a, Rectangle b) {
+        const float margin = 0.01f;
+        float x0 = std::min(a.x, b.x) - margin, y0 = std::min(a.y, b.y) - margin;
+        float x1 = std::max(a.x + a.width, b.x + b.width) + margin, y1 = std::max(a.y + a.height, b.y + b.height) + margin;
+        return { x0, y0, x1 - x0, y1 - y0 };
+    }
+
+    // First step in [first, last] whose box `touches`, or -1. The box
+    // around a run of steps covers every step in it, so a run is only split
+    // when that box touches something: a clear segment costs one query and
+    // a hit about two per halving.
+    template<typename BoxAt, typename Touches>
+    int FirstTouchingStep(int first, int last, const BoxAt& boxAt, const Touches& touches) {
+        if (first == last) return touches(boxAt(first)) ? first : -1;
+        if (!touches(Cover(boxAt(first), boxAt(last)))) return -1;
+        int mid = first + (last - first) / 2;
+        int step = FirstTouchingStep(first, mid, boxAt, touches);
+        return step >= 0 ? step : FirstTouchingStep(mid + 1, last, boxAt, touches);
+    }
+}
+
+bool Level::CheckProjectileCollision(Vector2 from, Vector2 to, float radius, ProjectileHit* hit,
+                                     const std::vector<char>* brokenWalls) const {
+    Vector2 delta = { to.x - from.x, to.y - from.y };
+    float earliest = 2.0f;
+    bool weakSpot = false;
+    int hitWall = -1;
+
+    // Terrain and spikes: the first of the box's positions a pixel apart
+    // along the segment that touches the mask
+    int steps = std::max(1, (int)std::ceil(std::max(std::fabs(delta.x), std::fabs(delta.y))));
+    auto boxAt = [&](int i) {
+        float t = (float)i / steps;
+        return Rectangle{ from.x + delta.x * t - radius, from.y + delta.y * t - radius, radius * 2, radius * 2 };
+    };
+    auto touches = [&](Rectangle box) { return occupancy->OverlapsTerrain(ToWorld(box)); };
+    int step = FirstTouchingStep(0, steps, boxAt, touches);
+    if (step >= 0) earliest = (float)step / steps;
+
+    // Check Walls
+    for (int i = 0; i < (int)walls.size(); i++) {
+        const Wall& wall = walls[i];
+        if (!wall.active || (brokenWalls && (*brokenWalls)[i])) continue;
+        float t = SweepBox(from, delta, wall.rect, radius);
+        if (t < 0.0f || t >= earliest) continue;
+        earliest = t;
+
+        // The weak spot counts only if the shot enters the wall through it
+        float tWeak = SweepBox(from, delta, wall.weakSpot, radius);
+        weakSpot = tWeak >= 0.0f && tWeak <= t + 1e-4f;
+        hitWall = i;
     }
     
     // Check Bounds
-    if (projRect.y + projRect.height > Constants::ScreenHeight) return true;
+    if (to.y + radius > Constants::ScreenHeight) {
+        float t = (from.y + radius >= Constants::ScreenHeight) ? 0.0f : (Constants::ScreenHeight - radius - from.y) / delta.y;
+        if (t < earliest) {
+            earliest = t;
+            weakSpot = false;
+            hitWall = -1;
+        }
+    }
     
-    return false;
+    if (earliest > 1.0f) return false;
+
+    if (hit) {
+        *hit = { earliest, Vector2{from.x + delta.x * earliest, from.y + delta.y * earliest}, weakSpot, hitWall };
+    }
+    return true;
 }
 
+void Level::DestroyWall(int index) {
+    walls[index].active = false;
+    // By the wall's number since Init(); indices shift as walls are culled
+    pieceHash = Fold(pieceHash, 'D', wallsAdded - (unsigned int)walls.size() + (unsigned int)index);
+    occupancy->ClearRect(ToWorld(walls[index].rect), OccupancyMask::Layer::Walls);
+}
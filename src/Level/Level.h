@@ -1,16 +1,66 @@
 #pragma once
 #include "raylib.h"
+#include "TextCache.h"
+#include "DrawList.h"
+#include "OccupancyMask.h"
+#include "CompositeHitbox.h"
+#include "TerrainHistory.h"
+#include "DeathCause.h"
+#include "SimScalar.h"
 #include <deque>
+#include <memory>
+#include <memory_resource>
+#include <vector>
 
 class Level {
+    friend class SpectatorEncoder;
+    friend class SpectatorDecoder;
+    friend class StateSerializer;
+
 public:
-    bool CheckProjectileCollision(Rectangle projRect);
+    // Terrain containers allocate from `resource`; copies use the default heap
+    explicit Level(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    struct ProjectileHit {
+        float time;     // Fraction of the swept segment travelled before impact
+        Vector2 point;  // Projectile center at impact
+        bool weakSpot;  // Hit the wall's weak spot; pass `wall` to DestroyWall()
+        int wall;       // Index of the wall that was hit, or -1
+    };
+
+    // Sweeps a projectile (a box of half-size `radius`) from `from` to `to`
+    // through terrain, spikes, walls and weak spots and reports the earliest
+    // impact, to the pixel. Read-only, so projectiles can be swept in parallel.
+    // Walls flagged in `brokenWalls` (by index) are treated as already gone.
+    bool CheckProjectileCollision(Vector2 from, Vector2 to, float radius, ProjectileHit* hit = nullptr,
+                                  const std::vector<char>* brokenWalls = nullptr) const;
+    void DestroyWall(int index);
     void Init();
     void Update();
-    void Draw(const Font& font);
-    bool CheckCollision(Rectangle playerRect);
-    float GetDistance() const { return distanceTraveled; }
-    float GetCurrentGapCenter() const { return lastY; }
+    // Moves everything left by `amount` pixels and culls what scrolled off
+    void Scroll(float amount);
+    // Tutorial text layout is cached by the caller, so a Level can be copied into snapshots cheaply
+    void Draw(DrawList& list) const;
+    // Tutorial lines; drawn between the start pad and the terrain
+    void DrawText(const Font& font, TextCache& textCache) const;
+    // Pixel test against terrain, spikes and active walls
+    bool CheckCollision(Rectangle playerRect) const;
+    // Same against each part's pixel rows, after the bounds were found to touch something
+    bool CheckCollision(const CompositeHitbox& hitbox) const;
+    // Which kind of piece a colliding hitbox touches. Slow (it tests the
+    // pieces one by one); meant for the tick a run ends.
+    DeathCause GetCollisionCause(const CompositeHitbox& hitbox) const;
+    float GetDistance() const { return ToFloat(distanceTraveled); }
+    float GetCurrentGapCenter() const { return ToFloat(lastY); }
+    // Redraws the collision mask from the pieces held, after they were
+    // replaced wholesale (StateSerializer::Load), and drops history columns
+    // generated after the restored state
+    void RebuildOccupancy();
+    // Every column generated since Init(), one per TerrainStep of distance
+    const TerrainHistory& GetHistory() const { return *history; }
+    // Obstacles, spikes, walls and texts currently held
+    int GetWallCount() const { return (int)walls.size(); }
+    size_t GetPieceCount() const { return obstacles.size() + triangleObstacles.size() + walls.size() + levelTexts.size(); }
 
 private:
     struct LevelText {
@@ -19,7 +69,7 @@ private:
         int fontSize;
         Color color;
     };
-    std::deque<LevelText> levelTexts;
+    std::pmr::deque<LevelText> levelTexts;
 
     struct Wall {
         Rectangle rect;
@@ -32,17 +82,38 @@ private:
         bool active;
     };
     
-    std::deque<Wall> walls;
-    std::deque<TriangleObstacle> triangleObstacles;
-    std::deque<Rectangle> obstacles;
+    std::pmr::deque<Wall> walls;
+    float lastWallX = 0.0f; // Screen x of the newest wall, which may be gone already
+    std::pmr::deque<TriangleObstacle> triangleObstacles;
+    std::pmr::deque<Rectangle> obstacles;
     Rectangle startPad;
-    float distanceTraveled = 0.0f;
-    float lastY = 250.0f; 
+    Scalar distanceTraveled = Scalar(0);
+    Scalar lastY = Scalar(250); 
     
-    float targetY = 250.0f;
+    Scalar targetY = Scalar(250);
     int stepsToTarget = 0;
     
-    float currentGapHeight = 300.0f;
+    Scalar currentGapHeight = Scalar(300);
+
+    // Running totals since Init(); tell spectators which pieces are new
+    unsigned int obstaclesAdded = 0;
+    unsigned int trianglesAdded = 0;
+    unsigned int wallsAdded = 0;
+    unsigned int columnsAdded = 0;
+    // Rolling StateHash of every piece added and every wall broken since
+    // Init(), so hashing the level doesn't walk the pieces it holds
+    uint64_t pieceHash = 0;
+
+    // Rasterized terrain for collision. Snapshot copies share it but never
+    // query it; only the simulation's Level reads or writes the mask.
+    std::shared_ptr<OccupancyMask> occupancy;
+    // Same sharing rule as the mask
+    std::shared_ptr<TerrainHistory> history;
 
+    Rectangle ToWorld(Rectangle rect) const { return { rect.x + GetDistance(), rect.y, rect.width, rect.height }; }
+    void AddObstacle(Rectangle rect);
+    void AddTriangle(Vector2 p1, Vector2 p2, Vector2 p3);
+    void AddWall(Rectangle rect, Rectangle weakSpot);
+    void AddColumn(int ceilingY, int floorY, uint8_t flags);
     void GenerateChunk(int startX, int width);
 };
@@ -0,0 +1,130 @@
+#include "OccupancyMask.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Range of pixel indices whose centers lie in [lo, hi)
+    int FirstPixel(float lo) { return (int)std::ceil(lo - 0.5f); }
+    int LastPixel(float hi) { return (int)std::ceil(hi - 0.5f) - 1; }
+
+    int RingColumn(int x, int width) {
+        int c = x % width;
+        return c < 0 ? c + width : c;
+    }
+}
+
+OccupancyMask::OccupancyMask()
+    : terrain(Height * WordsPerRow, 0), walls(Height * WordsPerRow, 0) {}
+
+void OccupancyMask::Clear(int clearedTo) {
+    std::fill(terrain.begin(), terrain.end(), 0);
+    std::fill(walls.begin(), walls.end(), 0);
+    frontier = clearedTo;
+}
+
+void OccupancyMask::ClearAhead(int worldX) {
+    if (worldX <= frontier) return;
+    int x0 = std::max(frontier, worldX - Width);
+    for (int row = 0; row < Height; row++) {
+        SetSpan(terrain, row, x0, worldX - 1, false);
+        SetSpan(walls, row, x0, worldX - 1, false);
+    }
+    frontier = worldX;
+}
+
+void OccupancyMask::SetSpan(std::vector<uint64_t>& plane, int row, int x0, int x1, bool value) {
+    uint64_t* words = &plane[row * WordsPerRow];
+    for (int x = x0; x <= x1; ) {
+        int column = RingColumn(x, Width);
+        int bit = column & 63;
+        int count = std::min(64 - bit, x1 - x + 1);
+        uint64_t bits = (count == 64 ? ~0ull : ((1ull << count) - 1)) << bit;
+        if (value) words[column >> 6] |= bits;
+        else words[column >> 6] &= ~bits;
+        x += count;
+    }
+}
+
+void OccupancyMask::FillRect(Rectangle rect, Layer layer) {
+    int r0 = std::max(FirstPixel(rect.y), 0);
+    int r1 = std::min(LastPixel(rect.y + rect.height), Height - 1);
+    int x0 = FirstPixel(rect.x);
+    int x1 = LastPixel(rect.x + rect.width);
+    for (int row = r0; row <= r1; row++) SetSpan(Plane(layer), row, x0, x1, true);
+}
+
+void OccupancyMask::ClearRect(Rectangle rect, Layer layer) {
+    int r0 = std::max(FirstPixel(rect.y), 0);
+    int r1 = std::min(LastPixel(rect.y + rect.height), Height - 1);
+    int x0 = FirstPixel(rect.x);
+    int x1 = LastPixel(rect.x + rect.width);
+    for (int row = r0; row <= r1; row++) SetSpan(Plane(layer), row, x0, x1, false);
+}
+
+void OccupancyMask::FillTriangle(Vector2 a, Vector2 b, Vector2 c) {
+    const Vector2 v[3] = { a, b, c };
+    float minY = std::min({a.y, b.y, c.y});
+    float maxY = std::max({a.y, b.y, c.y});
+    int r0 = std::max(FirstPixel(minY), 0);
+    int r1 = std::min(LastPixel(maxY), Height - 1);
+
+    for (int row = r0; row <= r1; row++) {
+        // Where the row's center line crosses the edges
+        float y = row + 0.5f;
+        float left = 1e9f;
+        float right = -1e9f;
+        for (int e = 0; e < 3; e++) {
+            Vector2 p = v[e];
+            Vector2 q = v[(e + 1) % 3];
+            if ((y < p.y) == (y < q.y)) continue;
+            float x = p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y);
+            left = std::min(left, x);
+            right = std::max(right, x);
+        }
+        if (left > right) continue;
+        SetSpan(terrain, row, FirstPixel(left), LastPixel(right), true);
+    }
+}
+
+int OccupancyMask::BuildWordMasks(int x0, int x1, WordMask* out) const {
+    int count = 0;
+    for (int x = x0; x <= x1; ) {
+        int column = RingColumn(x, Width);
+        int bit = column & 63;
+        int n = std::min(64 - bit, x1 - x + 1);
+        out[count++] = { column >> 6, (n == 64 ? ~0ull : ((1ull << n) - 1)) << bit };
+        x += n;
+    }
+    return count;
+}
+
+bool OccupancyMask::Query(Rectangle rect, bool includeWalls) const {
+    int r0 = std::max(FirstPixel(rect.y), 0);
+    int r1 = std::min(LastPixel(rect.y + rect.height), Height - 1);
+    // Only columns still inside the ring window hold valid data
+    int x0 = std::max(FirstPixel(rect.x), frontier - Width);
+    int x1 = std::min(LastPixel(rect.x + rect.width), frontier - 1);
+    if (r0 > r1 || x0 > x1) return false;
+
+    WordMask masks[WordsPerRow + 1];
+    int maskCount = BuildWordMasks(x0, x1, masks);
+
+    for (int row = r0; row <= r1; row++) {
+        const uint64_t* terrainRow = &terrain[row * WordsPerRow];
+        const uint64_t* wallRow = &walls[row * WordsPerRow];
+        for (int i = 0; i < maskCount; i++) {
+            uint64_t occupied = terrainRow[masks[i].word];
+            if (includeWalls) occupied |= wallRow[masks[i].word];
+            if (occupied & masks[i].bits) return true;
+        }
+    }
+    return false;
+}
+
+bool OccupancyMask::Overlaps(Rectangle rect) const {
+    return Query(rect, true);
+}
+
+bool OccupancyMask::OverlapsTerrain(Rectangle rect) const {
+    return Query(rect, false);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "raylib.h"
+#include "Constants.h"
+#include <cstdint>
+#include <vector>
+
+// One bit per pixel of the cave in world coordinates (screen x plus the
+// distance travelled), stored as 64-bit words per row. The x axis is a ring
+// of Width columns: columns are cleared just ahead of terrain generation and
+// reused once they have scrolled far off the left edge.
+//
+// Terrain (columns and spikes) and walls are kept in separate planes so a
+// destroyed wall can be erased without touching the rock around it. A rect
+// query is a few ANDs per row, independent of how much terrain is on screen.
+class OccupancyMask {
+public:
+    static constexpr int Width = Constants::Level::OccupancyWidth;
+    static constexpr int Height = Constants::ScreenHeight;
+
+    enum class Layer { Terrain, Walls };
+
+    OccupancyMask();
+
+    // Empties both planes. Columns left of `clearedTo` count as cleared
+    // already, as if ClearAhead(clearedTo) had run.
+    void Clear(int clearedTo = 0);
+    // Empties the columns between the last cleared one and worldX so they can
+    // be drawn into. Everything drawn must lie left of the cleared frontier.
+    void ClearAhead(int worldX);
+
+    // Pixels are covered when their center lies inside the shape
+    void FillRect(Rectangle rect, Layer layer);
+    void ClearRect(Rectangle rect, Layer layer);
+    void FillTriangle(Vector2 a, Vector2 b, Vector2 c);
+
+    // True if any covered pixel of `rect` is set. Columns outside the ring
+    // window count as empty.
+    bool Overlaps(Rectangle rect) const;
+    bool OverlapsTerrain(Rectangle rect) const;
+
+private:
+    static constexpr int WordsPerRow = Width / 64;
+    static_assert(Width % 64 == 0, "Ring width must be a whole number of words");
+
+    struct WordMask {
+        int word;
+        uint64_t bits;
+    };
+
+    std::vector<uint64_t>& Plane(Layer layer) { return layer == Layer::Terrain ? terrain : walls; }
+    void SetSpan(std::vector<uint64_t>& plane, int row, int x0, int x1, bool value);
+    // Splits the column range into per-word masks; returns the count
+    int BuildWordMasks(int x0, int x1, WordMask* out) const;
+    bool Query(Rectangle rect, bool includeWalls) const;
+
+    std::vector<uint64_t> terrain;
+    std::vector<uint64_t> walls;
+    int frontier = 0; // First column not cleared yet
+};
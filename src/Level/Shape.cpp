@@ -1,52 +1,54 @@
 #include "Shape.h"
-#include "rlgl.h"
+#include "DrawList.h"
+#include <cmath>
 
-void Shape::Draw(Vector2 offset) const {
+void Shape::Draw(DrawList& list, Vector2 offset) const {
     float posX = offset.x + rect.x;
     float posY = offset.y + rect.y;
 
-    if (rotation != 0.0f) {
-        float centerX = posX + rect.width / 2.0f;
-        float centerY = posY + rect.height / 2.0f;
-        
-        rlPushMatrix();
-        rlTranslatef(centerX, centerY, 0);
-        rlRotatef(rotation, 0, 0, 1);
-        rlTranslatef(-centerX, -centerY, 0);
-    }
+    // Rotation turns the shape about its center. Only rectangles and
+    // triangles are ever rotated; ellipses and rings are drawn as they are.
+    float centerX = posX + rect.width / 2.0f;
+    float centerY = posY + rect.height / 2.0f;
+    float cs = cosf(rotation * DEG2RAD);
+    float sn = sinf(rotation * DEG2RAD);
+    auto place = [&](float x, float y) {
+        if (rotation == 0.0f) return Vector2{ x, y };
+        float dx = x - centerX, dy = y - centerY;
+        return Vector2{ centerX + dx * cs - dy * sn, centerY + dx * sn + dy * cs };
+    };
 
     switch (type) {
-        case RECTANGLE:
-            DrawRectangle((int)posX, (int)posY, (int)rect.width, (int)rect.height, color);
+        case RECTANGLE: {
+            float x = (float)(int)posX, y = (float)(int)posY;
+            float w = (float)(int)rect.width, h = (float)(int)rect.height;
+            if (rotation == 0.0f) list.Rect({ x, y, w, h }, color);
+            else list.Quad(place(x, y), place(x, y + h), place(x + w, y + h), place(x + w, y), color);
             break;
+        }
         case ELLIPSE:
-            DrawEllipse((int)posX, (int)posY, (int)rect.width, (int)rect.height, color);
+            list.Ellipse({ (float)(int)posX, (float)(int)posY }, (float)(int)rect.width, (float)(int)rect.height, color);
             break;
         case TRIANGLE:
             // Draw an isosceles triangle fitting in the rect
             // Point 1: Top Center
             // Point 2: Bottom Right
             // Point 3: Bottom Left
-            DrawTriangle(
-                {posX + rect.width / 2, posY}, 
-                {posX, posY + rect.height}, 
-                {posX + rect.width, posY + rect.height}, 
+            list.Triangle(
+                place(posX + rect.width / 2, posY), 
+                place(posX, posY + rect.height), 
+                place(posX + rect.width, posY + rect.height), 
                 color
             );
             break;
         case RING:
             float radius = rect.width / 2.0f;
-            DrawRing(
+            list.Ring(
                 {posX + radius, posY + radius}, 
                 radius - param, // Inner radius
                 radius,         // Outer radius
-                0, 360, 0,      // Start/End angle, segments
                 color
             );
             break;
     }
-
-    if (rotation != 0.0f) {
-        rlPopMatrix();
-    }
 }
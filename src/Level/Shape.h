@@ -1,6 +1,8 @@
 #pragma once
 #include "raylib.h"
 
+class DrawList;
+
 enum ShapeType {
     RECTANGLE,
     ELLIPSE,
@@ -22,5 +24,5 @@ struct Shape {
     float rotation = 0.0f;
     float param = 0.0f; // For RING: thickness
 
-    void Draw(Vector2 offset) const;
+    void Draw(DrawList& list, Vector2 offset) const;
 };
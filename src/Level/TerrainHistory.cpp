@@ -0,0 +1,196 @@
+#include "TerrainHistory.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstdlib>
+
+using LevelConst = Constants::Level;
+
+namespace {
+    constexpr int ChunkColumns = LevelConst::HistoryChunkColumns;
+    constexpr int BlockShift = LevelConst::HistoryBlockShift;
+    constexpr int BlockColumns = 1 << BlockShift;
+
+    // Byte layout: bits 0-2 ceiling delta + 3, bits 3-5 floor delta + 3,
+    // bits 6-7 marker. A ceiling field of 7 escapes to: flags, ceiling and
+    // floor as little-endian 16 bits.
+    constexpr int MaxDelta = 3;
+    constexpr uint8_t Escape = 7;
+    constexpr uint8_t MarkerFlags[4] = { 0, TerrainHistory::Wall, TerrainHistory::CeilingSpike, TerrainHistory::FloorSpike };
+
+    int MarkerOf(uint8_t flags) {
+        for (int i = 0; i < 4; i++) {
+            if (MarkerFlags[i] == flags) return i;
+        }
+        return -1;
+    }
+
+    constexpr TerrainHistory::Summary EmptySummary = { 0, 0xffff, 0 };
+}
+
+void TerrainHistory::Clear() {
+    chunks.clear();
+    count = 0;
+    last = {};
+    levels.clear();
+    partial = EmptySummary;
+    partialCount = 0;
+}
+
+void TerrainHistory::Append(const Column& column) {
+    if (count % ChunkColumns == 0) chunks.push_back({ last, {} });
+    Encode(chunks.back(), last, column);
+    last = column;
+    count++;
+    AddToPyramid(column);
+}
+
+void TerrainHistory::Encode(Chunk& chunk, const Column& previous, const Column& column) {
+    int dc = column.ceiling - previous.ceiling;
+    int df = column.floor - previous.floor;
+    int marker = MarkerOf(column.flags);
+    if (std::abs(dc) <= MaxDelta && std::abs(df) <= MaxDelta && marker >= 0) {
+        chunk.bytes.push_back((uint8_t)((dc + MaxDelta) | ((df + MaxDelta) << 3) | (marker << 6)));
+        return;
+    }
+    const uint8_t escaped[6] = { Escape, column.flags, (uint8_t)column.ceiling, (uint8_t)(column.ceiling >> 8),
+                                 (uint8_t)column.floor, (uint8_t)(column.floor >> 8) };
+    chunk.bytes.insert(chunk.bytes.end(), escaped, escaped + 6);
+}
+
+TerrainHistory::Column TerrainHistory::Decode(const uint8_t* bytes, size_t& pos, const Column& previous) {
+    uint8_t b = bytes[pos++];
+    if ((b & 7) == Escape) {
+        Column column = { (uint16_t)(bytes[pos + 1] | (bytes[pos + 2] << 8)),
+                          (uint16_t)(bytes[pos + 3] | (bytes[pos + 4] << 8)), bytes[pos] };
+        pos += 5;
+        return column;
+    }
+    return { (uint16_t)(previous.ceiling + (b & 7) - MaxDelta),
+             (uint16_t)(previous.floor + ((b >> 3) & 7) - MaxDelta), MarkerFlags[b >> 6] };
+}
+
+void TerrainHistory::Merge(Summary& into, const Summary& from) {
+    into.ceiling = std::max(into.ceiling, from.ceiling);
+    into.floor = std::min(into.floor, from.floor);
+    into.flags |= from.flags;
+}
+
+void TerrainHistory::AddToPyramid(const Column& column) {
+    Merge(partial, column);
+    if (++partialCount < BlockColumns) return;
+
+    // A full block goes into level 0; every completed pair moves up a level
+    Summary summary = partial;
+    partial = EmptySummary;
+    partialCount = 0;
+    for (size_t k = 0; ; k++) {
+        if (levels.size() == k) levels.emplace_back();
+        levels[k].push_back(summary);
+        size_t size = levels[k].size();
+        if (size % 2 != 0) break;
+        summary = levels[k][size - 2];
+        Merge(summary, levels[k][size - 1]);
+    }
+}
+
+void TerrainHistory::Truncate(int newCount) {
+    if (newCount >= count) return;
+    if (newCount <= 0) {
+        Clear();
+        return;
+    }
+
+    // Find where the column ends in its chunk and what it decoded to
+    int chunkIndex = (newCount - 1) / ChunkColumns;
+    Chunk& chunk = chunks[chunkIndex];
+    Column column = chunk.start;
+    size_t pos = 0;
+    for (int i = chunkIndex * ChunkColumns; i < newCount; i++) column = Decode(chunk.bytes.data(), pos, column);
+    chunk.bytes.resize(pos);
+    chunks.resize(chunkIndex + 1);
+    last = column;
+    count = newCount;
+
+    for (size_t k = 0; k < levels.size(); k++) {
+        levels[k].resize(std::min(levels[k].size(), (size_t)(newCount >> (BlockShift + (int)k))));
+    }
+    partialCount = newCount & (BlockColumns - 1);
+    partial = Summarize(newCount - partialCount, newCount);
+}
+
+TerrainHistory::Column TerrainHistory::GetColumn(int index) const {
+    const Chunk& chunk = chunks[index / ChunkColumns];
+    Column column = chunk.start;
+    size_t pos = 0;
+    for (int i = index - index % ChunkColumns; i <= index; i++) column = Decode(chunk.bytes.data(), pos, column);
+    return column;
+}
+
+TerrainHistory::Summary TerrainHistory::Summarize(int first, int end) const {
+    Summary result = EmptySummary;
+    first = std::max(first, 0);
+    end = std::min(end, count);
+    if (first >= end) return result;
+
+    // Columns outside whole blocks are decoded, from the start of their chunk
+    auto decodeRange = [&](int from, int to) {
+        for (int c = from; c < to; ) {
+            const Chunk& chunk = chunks[c / ChunkColumns];
+            int chunkFirst = c - c % ChunkColumns;
+            int chunkEnd = std::min(chunkFirst + ChunkColumns, to);
+            Column column = chunk.start;
+            size_t pos = 0;
+            for (int i = chunkFirst; i < chunkEnd; i++) {
+                column = Decode(chunk.bytes.data(), pos, column);
+                if (i >= c) Merge(result, column);
+            }
+            c = chunkEnd;
+        }
+    };
+
+    int fullBlocks = levels.empty() ? 0 : (int)levels[0].size();
+    int b0 = (first + BlockColumns - 1) >> BlockShift;
+    int b1 = std::min(end >> BlockShift, fullBlocks);
+    if (b0 >= b1) {
+        decodeRange(first, end);
+        return result;
+    }
+
+    decodeRange(first, b0 << BlockShift);
+    // Largest aligned entries that fit, as in a segment tree
+    for (int b = b0; b < b1; ) {
+        size_t k = 0;
+        while (k + 1 < levels.size() && (b & ((2 << k) - 1)) == 0 && b + (2 << k) <= b1 &&
+               (size_t)(b >> (k + 1)) < levels[k + 1].size()) {
+            k++;
+        }
+        Merge(result, levels[k][b >> k]);
+        b += 1 << k;
+    }
+    decodeRange(b1 << BlockShift, end);
+    return result;
+}
+
+TerrainHistory::Minimap TerrainHistory::BuildMinimap(int width, int columns, int deathColumn) const {
+    Minimap minimap;
+    columns = std::min(columns, count);
+    if (columns <= 0 || width <= 0) return minimap;
+
+    minimap.pixels.resize(width);
+    for (int p = 0; p < width; p++) {
+        int first = (int)((long long)p * columns / width);
+        int end = std::max((int)((long long)(p + 1) * columns / width), first + 1);
+        minimap.pixels[p] = Summarize(first, end);
+    }
+    if (deathColumn >= 0) {
+        minimap.deathPixel = std::min((int)((long long)deathColumn * width / columns), width - 1);
+    }
+    return minimap;
+}
+
+size_t TerrainHistory::GetByteSize() const {
+    size_t bytes = 0;
+    for (const Chunk& chunk : chunks) bytes += chunk.bytes.size() + sizeof(Column);
+    for (const auto& level : levels) bytes += level.size() * sizeof(Summary);
+    return bytes;
+}
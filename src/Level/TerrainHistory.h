@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Every terrain column generated in a run, kept after it scrolls away. A
+// column is one byte when its ceiling and floor moved by at most 3 px and it
+// has at most one marker; other columns escape to six bytes. Columns are
+// stored in chunks that each start from known heights, so one column can be
+// decoded without reading the whole run.
+//
+// A pyramid of per-block summaries (narrowest ceiling/floor and the markers
+// seen) is extended as columns arrive, so summarizing any range of the run,
+// as the minimap does once per pixel, reads a handful of entries.
+class TerrainHistory {
+public:
+    enum Flags : uint8_t {
+        Wall = 1,
+        CeilingSpike = 2,
+        FloorSpike = 4,
+    };
+
+    struct Column {
+        uint16_t ceiling;   // Screen y where the ceiling rock ends
+        uint16_t floor;     // Screen y where the floor rock begins
+        uint8_t flags;
+    };
+
+    // Lowest ceiling, highest floor and every marker of a range of columns.
+    // An empty range has ceiling 0 and floor 0xffff.
+    using Summary = Column;
+
+    // One summary per pixel of a strip showing the whole run
+    struct Minimap {
+        std::vector<Summary> pixels;
+        int deathPixel = -1;
+    };
+
+    void Clear();
+    void Append(const Column& column);
+    // Forgets the columns from `count` on, after the level was rewound
+    void Truncate(int count);
+
+    int GetColumnCount() const { return count; }
+    Column GetColumn(int index) const;
+    Summary Summarize(int first, int end) const;
+    // `width` pixels over the first `columns` columns; `deathColumn` (or -1) is marked
+    Minimap BuildMinimap(int width, int columns, int deathColumn) const;
+
+    // Encoded columns plus the pyramid
+    size_t GetByteSize() const;
+
+private:
+    struct Chunk {
+        Column start;               // Heights before the first column; flags unused
+        std::vector<uint8_t> bytes;
+    };
+
+    static void Merge(Summary& into, const Summary& from);
+    // Decodes the next column of a chunk at `pos`, relative to `previous`
+    static Column Decode(const uint8_t* bytes, size_t& pos, const Column& previous);
+    void Encode(Chunk& chunk, const Column& previous, const Column& column);
+    void AddToPyramid(const Column& column);
+
+    std::vector<Chunk> chunks;
+    int count = 0;
+    Column last = {};
+
+    // levels[k][i] covers columns [i, i + 1) << (BlockShift + k); only full
+    // blocks are kept, the newest incomplete one of level 0 is `partial`
+    std::vector<std::vector<Summary>> levels;
+    Summary partial = {};
+    int partialCount = 0;
+};
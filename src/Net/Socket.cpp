@@ -0,0 +1,152 @@
+#include "Socket.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    using Native = SOCKET;
+
+    bool Startup() {
+        static bool started = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+    }
+
+    bool WouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+    void CloseNative(Native s) { closesocket(s); }
+
+    void SetNonBlocking(Native s) {
+        u_long enabled = 1;
+        ioctlsocket(s, FIONBIO, &enabled);
+    }
+#else
+    using Native = int;
+
+    bool Startup() { return true; }
+    bool WouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+    void CloseNative(Native s) { close(s); }
+
+    void SetNonBlocking(Native s) {
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+    }
+#endif
+
+#ifdef MSG_NOSIGNAL
+    constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int SendFlags = 0;
+#endif
+
+    Native ToNative(Net::Handle h) { return (Native)h; }
+
+    // Small packets every tick: send them now rather than batching for 40ms
+    void Configure(Native s) {
+        int enabled = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&enabled, sizeof(enabled));
+#ifdef SO_NOSIGPIPE
+        setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+        SetNonBlocking(s);
+    }
+
+    sockaddr_in LoopbackAddress(const char* host, int port) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((unsigned short)port);
+        if (inet_pton(AF_INET, host, &address.sin_addr) != 1) {
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        }
+        return address;
+    }
+}
+
+namespace Net {
+    Handle Listen(int port) {
+        if (!Startup()) return InvalidHandle;
+        Native s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s == (Native)InvalidHandle) return InvalidHandle;
+
+        int reuse = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+        sockaddr_in address = LoopbackAddress("127.0.0.1", port);
+        if (bind(s, (const sockaddr*)&address, sizeof(address)) != 0 || listen(s, 64) != 0) {
+            CloseNative(s);
+            return InvalidHandle;
+        }
+        SetNonBlocking(s);
+        return (Handle)s;
+    }
+
+    Handle Accept(Handle listener) {
+        Native s = accept(ToNative(listener), nullptr, nullptr);
+        if (s == (Native)InvalidHandle) return InvalidHandle;
+        Configure(s);
+        return (Handle)s;
+    }
+
+    Handle Connect(const char* host, int port) {
+        if (!Startup()) return InvalidHandle;
+        Native s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s == (Native)InvalidHandle) return InvalidHandle;
+
+        sockaddr_in address = LoopbackAddress(host, port);
+        if (connect(s, (const sockaddr*)&address, sizeof(address)) != 0) {
+            CloseNative(s);
+            return InvalidHandle;
+        }
+        Configure(s);
+        return (Handle)s;
+    }
+
+    void Close(Handle socket) {
+        if (socket != InvalidHandle) CloseNative(ToNative(socket));
+    }
+
+    long SendPair(Handle socket, const void* first, size_t firstSize, const void* second, size_t secondSize) {
+#ifdef _WIN32
+        WSABUF buffers[2] = {
+            { (ULONG)firstSize, (CHAR*)first },
+            { (ULONG)secondSize, (CHAR*)second },
+        };
+        DWORD sent = 0;
+        if (WSASend(ToNative(socket), buffers, secondSize ? 2 : 1, &sent, 0, nullptr, nullptr) != 0) {
+            return WouldBlock() ? 0 : -1;
+        }
+        return (long)sent;
+#else
+        iovec buffers[2] = {
+            { const_cast<void*>(first), firstSize },
+            { const_cast<void*>(second), secondSize },
+        };
+        msghdr message = {};
+        message.msg_iov = buffers;
+        message.msg_iovlen = secondSize ? 2 : 1;
+        ssize_t sent = sendmsg(ToNative(socket), &message, SendFlags);
+        if (sent < 0) return WouldBlock() ? 0 : -1;
+        return (long)sent;
+#endif
+    }
+
+    long Receive(Handle socket, void* buffer, size_t size) {
+        long received = (long)recv(ToNative(socket), (char*)buffer, (int)size, 0);
+        if (received > 0) return received;
+        if (received < 0 && WouldBlock()) return 0;
+        return -1; // Closed (0) or failed
+    }
+}
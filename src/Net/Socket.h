@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Minimal non-blocking TCP over the loopback interface. Kept free of raylib
+// so the platform socket headers (winsock2 on Windows) never meet raylib.h.
+namespace Net {
+    using Handle = intptr_t;
+    constexpr Handle InvalidHandle = -1;
+
+    // Binds 127.0.0.1:<port>; returns InvalidHandle on failure
+    Handle Listen(int port);
+    // Returns InvalidHandle when nobody is waiting
+    Handle Accept(Handle listener);
+    // Blocking connect, then switches the socket to non-blocking
+    Handle Connect(const char* host, int port);
+    void Close(Handle socket);
+
+    // Sends `first` followed by `second` in one call without joining them.
+    // Returns the bytes taken by the kernel, 0 if the socket is full and -1
+    // once the peer is gone.
+    long SendPair(Handle socket, const void* first, size_t firstSize, const void* second, size_t secondSize);
+    // Returns the bytes read, 0 if nothing is pending and -1 once the peer is gone
+    long Receive(Handle socket, void* buffer, size_t size);
+}
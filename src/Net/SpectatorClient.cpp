@@ -0,0 +1,63 @@
+#include "SpectatorClient.h"
+#include "Constants.h"
+#include "raylib.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t ReadChunk = 64 * 1024;
+}
+
+bool SpectatorClient::Connect(const char* host, int port) {
+    Close();
+    socket = Net::Connect(host, port);
+    if (socket == Net::InvalidHandle) {
+        TraceLog(LOG_WARNING, "SPECTATOR: Could not connect to %s:%d", host, port);
+        return false;
+    }
+    TraceLog(LOG_INFO, "SPECTATOR: Watching %s:%d", host, port);
+    return true;
+}
+
+void SpectatorClient::Close() {
+    Net::Close(socket);
+    socket = Net::InvalidHandle;
+    used = 0;
+}
+
+bool SpectatorClient::Poll(SimSnapshot& view) {
+    if (socket == Net::InvalidHandle) return false;
+
+    for (;;) {
+        if (buffer.size() - used < ReadChunk) buffer.resize(used + ReadChunk);
+        long received = Net::Receive(socket, buffer.data() + used, buffer.size() - used);
+        if (received < 0) {
+            TraceLog(LOG_INFO, "SPECTATOR: Broadcast ended");
+            Close();
+            return false;
+        }
+        if (received == 0) break;
+        used += (size_t)received;
+    }
+
+    // Apply every complete packet; a partial one waits for the next poll
+    size_t at = 0;
+    while (used - at >= SpectatorProtocol::HeaderSize) {
+        uint32_t size = SpectatorProtocol::ReadSize(buffer.data() + at);
+        if (size < SpectatorProtocol::HeaderSize || size > (uint32_t)Constants::Spectator::RingBytes) {
+            TraceLog(LOG_WARNING, "SPECTATOR: Malformed packet header");
+            Close();
+            return false;
+        }
+        if (used - at < size) break;
+
+        if (!decoder.Apply(buffer.data() + at, size, view)) {
+            TraceLog(LOG_WARNING, "SPECTATOR: Malformed packet");
+            Close();
+            return false;
+        }
+        at += size;
+    }
+    memmove(buffer.data(), buffer.data() + at, used - at);
+    used -= at;
+    return true;
+}
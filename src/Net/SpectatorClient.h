@@ -0,0 +1,28 @@
+#pragma once
+#include "SimSnapshot.h"
+#include "SpectatorCodec.h"
+#include "Socket.h"
+#include <cstdint>
+#include <vector>
+
+// Receives a SpectatorServer broadcast and keeps a snapshot up to date with it
+class SpectatorClient {
+public:
+    SpectatorClient() = default;
+    ~SpectatorClient() { Close(); }
+    SpectatorClient(const SpectatorClient&) = delete;
+    SpectatorClient& operator=(const SpectatorClient&) = delete;
+
+    bool Connect(const char* host, int port);
+    void Close();
+    // Reads whatever has arrived and applies every complete packet to `view`.
+    // Returns false once the broadcast has ended or sent something unreadable.
+    bool Poll(SimSnapshot& view);
+    bool HasState() const { return decoder.HasState(); }
+
+private:
+    Net::Handle socket = Net::InvalidHandle;
+    std::vector<uint8_t> buffer;
+    size_t used = 0;
+    SpectatorDecoder decoder;
+};
@@ -0,0 +1,463 @@
+#include "SpectatorCodec.h"
+#include "MissileFactory.h"
+#include "ByteStream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace SpectatorProtocol;
+
+namespace {
+    enum GameFlags : uint8_t { FlagGameOver = 1, FlagStarted = 2, FlagFacingRight = 4 };
+
+    constexpr float PositionScale = 8.0f;
+    constexpr float RotationScale = 50.0f;  // 1/50 degree
+    constexpr float TimerScale = 1000.0f;   // Milliseconds
+
+    int32_t Quantize(float value) { return (int32_t)lroundf(value * PositionScale); }
+    int16_t ToExtra(float value) { return (int16_t)std::clamp(lroundf(value), -32768L, 32767L); }
+    Vector2 Dequantize(const EntityRecord& r) { return { r.x / PositionScale, r.y / PositionScale }; }
+
+    void PutRecord(ByteWriter& writer, int kind, const EntityRecord& r) {
+        if (kind == Missiles) writer.PutU8(r.type);
+        writer.Put(r.x);
+        writer.Put(r.y);
+        writer.Put(r.extra);
+    }
+
+    EntityRecord GetRecord(ByteReader& reader, int kind) {
+        EntityRecord r = {};
+        if (kind == Missiles) r.type = (uint8_t)reader.GetU8();
+        r.x = reader.Get<int32_t>();
+        r.y = reader.Get<int32_t>();
+        r.extra = reader.Get<int16_t>();
+        return r;
+    }
+
+    // Drops the entries whose `keep` flag is clear, preserving order
+    template<typename Vec>
+    void Compact(Vec& items, const std::vector<char>& keep) {
+        size_t out = 0;
+        for (size_t i = 0; i < items.size(); i++) {
+            if (!keep[i]) continue;
+            if (out != i) items[out] = std::move(items[i]);
+            out++;
+        }
+        items.erase(items.begin() + out, items.end());
+    }
+}
+
+namespace SpectatorProtocol {
+    uint32_t ReadSize(const uint8_t* header) {
+        uint32_t size;
+        memcpy(&size, header, sizeof(size));
+        return size;
+    }
+
+    PacketKind ReadKind(const uint8_t* header) {
+        return (PacketKind)header[8];
+    }
+}
+
+// --- Encoder ---
+
+bool SpectatorEncoder::Encode(const SimSnapshot& view, bool keyframe, std::vector<uint8_t>& out) {
+    const Level& level = view.level;
+    // A restart renumbers entities and terrain, so the old state is useless
+    if (!hasState || view.run != run || level.obstaclesAdded < obstaclesSent) keyframe = true;
+
+    size_t start = out.size();
+    ByteWriter writer(out);
+    writer.Put((uint32_t)0); // Size, patched below
+    writer.Put((uint32_t)view.tick);
+    writer.PutU8((int)(keyframe ? PacketKind::Keyframe : PacketKind::Delta));
+
+    const Helicopter& heli = view.helicopter;
+    uint8_t flags = (view.isGameOver ? FlagGameOver : 0) | (heli.HasStarted() ? FlagStarted : 0) | (heli.IsFacingRight() ? FlagFacingRight : 0);
+    writer.PutU8(std::clamp(view.ammo, 0, 255));
+    writer.PutU8(flags);
+    writer.PutVector(heli.GetPosition());
+    writer.Put(heli.GetAnimationTimer());
+
+    EncodeLevel(level, keyframe, out);
+    for (int kind = 0; kind < EntityKindCount; kind++) {
+        Collect(view, kind);
+        EncodeEntities(kind, keyframe, out);
+    }
+
+    uint32_t size = (uint32_t)(out.size() - start);
+    memcpy(out.data() + start, &size, sizeof(size));
+
+    hasState = true;
+    run = view.run;
+    return keyframe;
+}
+
+void SpectatorEncoder::EncodeLevel(const Level& level, bool keyframe, std::vector<uint8_t>& out) {
+    ByteWriter writer(out);
+    writer.Put(level.GetDistance());
+
+    const unsigned int firstWall = level.wallsAdded - (unsigned int)level.walls.size();
+    if (keyframe) {
+        writer.PutRect(level.startPad);
+        writer.PutU8((int)std::min<size_t>(level.levelTexts.size(), 255));
+        for (size_t i = 0; i < level.levelTexts.size() && i < 255; i++) {
+            const auto& text = level.levelTexts[i];
+            size_t length = std::min<size_t>(strlen(text.text), 255);
+            writer.PutVector(text.position);
+            writer.PutU8(text.fontSize);
+            writer.PutU8(text.color.r);
+            writer.PutU8(text.color.g);
+            writer.PutU8(text.color.b);
+            writer.PutU8(text.color.a);
+            writer.PutU8((int)length);
+            out.insert(out.end(), text.text, text.text + length);
+        }
+
+        writer.PutU16(level.obstacles.size());
+        for (const auto& obs : level.obstacles) writer.PutRect(obs);
+        writer.PutU16(level.triangleObstacles.size());
+        for (const auto& tri : level.triangleObstacles) {
+            writer.PutVector(tri.p1);
+            writer.PutVector(tri.p2);
+            writer.PutVector(tri.p3);
+        }
+        writer.Put((uint32_t)firstWall);
+        writer.PutU16(level.walls.size());
+        brokenWallsSent.clear();
+        for (size_t i = 0; i < level.walls.size(); i++) {
+            const auto& wall = level.walls[i];
+            writer.PutRect(wall.rect);
+            writer.PutRect(wall.weakSpot);
+            writer.PutU8(wall.active);
+            if (!wall.active) brokenWallsSent.push_back(firstWall + (unsigned int)i);
+        }
+    } else {
+        // Pieces are appended in order, so the new ones are at the back
+        size_t newObstacles = std::min<size_t>(level.obstaclesAdded - obstaclesSent, level.obstacles.size());
+        writer.PutU16(newObstacles);
+        for (size_t i = level.obstacles.size() - newObstacles; i < level.obstacles.size(); i++) {
+            writer.PutRect(level.obstacles[i]);
+        }
+
+        size_t newTriangles = std::min<size_t>(level.trianglesAdded - trianglesSent, level.triangleObstacles.size());
+        writer.PutU16(newTriangles);
+        for (size_t i = level.triangleObstacles.size() - newTriangles; i < level.triangleObstacles.size(); i++) {
+            const auto& tri = level.triangleObstacles[i];
+            writer.PutVector(tri.p1);
+            writer.PutVector(tri.p2);
+            writer.PutVector(tri.p3);
+        }
+
+        size_t newWalls = std::min<size_t>(level.wallsAdded - wallsSent, level.walls.size());
+        writer.PutU16(newWalls);
+        for (size_t i = level.walls.size() - newWalls; i < level.walls.size(); i++) {
+            writer.PutRect(level.walls[i].rect);
+            writer.PutRect(level.walls[i].weakSpot);
+        }
+
+        // Walls broken since the last packet, by running number
+        brokenWallsSent.erase(std::remove_if(brokenWallsSent.begin(), brokenWallsSent.end(),
+            [&](unsigned int wall) { return wall < firstWall; }), brokenWallsSent.end());
+        size_t countAt = out.size();
+        writer.PutU16(0);
+        uint16_t broken = 0;
+        for (size_t i = 0; i < level.walls.size(); i++) {
+            unsigned int wall = firstWall + (unsigned int)i;
+            if (level.walls[i].active) continue;
+            if (std::find(brokenWallsSent.begin(), brokenWallsSent.end(), wall) != brokenWallsSent.end()) continue;
+            brokenWallsSent.push_back(wall);
+            writer.Put((uint32_t)wall);
+            broken++;
+        }
+        memcpy(out.data() + countAt, &broken, sizeof(broken));
+    }
+
+    obstaclesSent = level.obstaclesAdded;
+    trianglesSent = level.trianglesAdded;
+    wallsSent = level.wallsAdded;
+}
+
+void SpectatorEncoder::Collect(const SimSnapshot& view, int kind) {
+    const EntityManager& entities = view.entities;
+    current.clear();
+    switch (kind) {
+        case Missiles:
+            for (const auto& m : entities.missiles) {
+                if (!m->IsActive()) continue;
+                Rectangle r = m->GetRect();
+                current.push_back({m->GetId(), Quantize(r.x), Quantize(r.y),
+                                   ToExtra(remainderf(m->GetRotation(), 360.0f) * RotationScale), (uint8_t)m->GetType()});
+            }
+            break;
+        case Projectiles:
+            for (const auto& p : entities.projectiles) {
+                if (!p.IsActive()) continue;
+                Vector2 pos = p.GetPosition();
+                current.push_back({p.GetId(), Quantize(pos.x), Quantize(pos.y), 0, 0});
+            }
+            break;
+        case Rocks:
+            for (const auto& r : entities.rocks) {
+                if (!r.IsActive()) continue;
+                Vector2 pos = r.GetPosition();
+                current.push_back({r.GetId(), Quantize(pos.x), Quantize(pos.y), ToExtra(r.GetRadius() * PositionScale), 0});
+            }
+            break;
+        case Explosions:
+            for (const auto& e : entities.explosions) {
+                if (!e.IsActive()) continue;
+                Vector2 pos = e.GetPosition();
+                current.push_back({e.GetId(), Quantize(pos.x), Quantize(pos.y), ToExtra(e.GetTimer() * TimerScale), 0});
+            }
+            break;
+    }
+}
+
+void SpectatorEncoder::EncodeEntities(int kind, bool keyframe, std::vector<uint8_t>& out) {
+    ByteWriter writer(out);
+    std::vector<EntityRecord>& viewer = sent[kind];
+
+    if (keyframe) {
+        writer.PutU16(current.size());
+        for (const auto& r : current) PutRecord(writer, kind, r);
+        viewer.assign(current.begin(), current.end());
+        return;
+    }
+
+    // Both lists are in spawn order, which is id order: walk them together.
+    // Entries that left are named by their index in the viewer's list.
+    size_t removedAt = out.size();
+    writer.PutU16(0);
+    uint16_t removed = 0;
+    size_t j = 0;
+    size_t survivors = 0;
+    for (size_t i = 0; i < viewer.size(); i++) {
+        while (j < current.size() && current[j].id < viewer[i].id) j++; // Never sent; cannot happen
+        if (j < current.size() && current[j].id == viewer[i].id) {
+            // Survivors are compacted to the front as we go
+            viewer[survivors] = viewer[i];
+            current[survivors] = current[j++];
+            survivors++;
+        } else {
+            writer.Put((uint16_t)i);
+            removed++;
+        }
+    }
+    memcpy(out.data() + removedAt, &removed, sizeof(removed));
+    size_t firstAdded = j;
+
+    // Moves: one bit per survivor, then the changed ones
+    size_t maskAt = out.size();
+    out.resize(out.size() + (survivors + 7) / 8, 0);
+    for (size_t i = 0; i < survivors; i++) {
+        EntityRecord& known = viewer[i];
+        const EntityRecord& now = current[i];
+        int32_t dx = std::clamp(now.x - known.x, -32768, 32767);
+        int32_t dy = std::clamp(now.y - known.y, -32768, 32767);
+        if (dx == 0 && dy == 0 && now.extra == known.extra) continue;
+
+        out[maskAt + i / 8] |= (uint8_t)(1 << (i % 8));
+        writer.Put((int16_t)dx);
+        writer.Put((int16_t)dy);
+        writer.Put(now.extra);
+        // Track what the viewer will hold; a clamped move catches up next tick
+        known.x += dx;
+        known.y += dy;
+        known.extra = now.extra;
+    }
+    viewer.resize(survivors);
+
+    // Current entries past the survivors are new and have the highest ids
+    writer.PutU16(current.size() - firstAdded);
+    for (size_t k = firstAdded; k < current.size(); k++) {
+        PutRecord(writer, kind, current[k]);
+        viewer.push_back(current[k]);
+    }
+}
+
+// --- Decoder ---
+
+bool SpectatorDecoder::Apply(const uint8_t* packet, size_t size, SimSnapshot& view) {
+    if (size < HeaderSize || ReadSize(packet) != size) return false;
+    ByteReader reader(packet, size);
+    reader.Get<uint32_t>();
+    uint32_t tick = reader.Get<uint32_t>();
+    bool keyframe = (PacketKind)reader.GetU8() == PacketKind::Keyframe;
+    if (!keyframe && !hasState) return true;
+
+    view.tick = tick;
+    view.ammo = reader.GetU8();
+    int flags = reader.GetU8();
+    view.isGameOver = (flags & FlagGameOver) != 0;
+    Helicopter& heli = view.helicopter;
+    heli.position = SimVec2::From(reader.GetVector());
+    heli.animationTimer = reader.GetF32();
+    heli.hasStarted = (flags & FlagStarted) != 0;
+    heli.facingRight = (flags & FlagFacingRight) != 0;
+
+    // Terrain
+    Level& level = view.level;
+    float distance = reader.GetF32();
+    if (keyframe) {
+        level.startPad = reader.GetRect();
+        level.levelTexts.clear();
+        int textCount = reader.GetU8();
+        for (int i = 0; i < textCount && reader.Ok(); i++) {
+            Level::LevelText text;
+            text.position = reader.GetVector();
+            text.fontSize = reader.GetU8();
+            text.color.r = (unsigned char)reader.GetU8();
+            text.color.g = (unsigned char)reader.GetU8();
+            text.color.b = (unsigned char)reader.GetU8();
+            text.color.a = (unsigned char)reader.GetU8();
+            int length = reader.GetU8();
+            const uint8_t* bytes = reader.GetBytes(length);
+            if (!bytes) break;
+            text.text = texts.emplace((const char*)bytes, (size_t)length).first->c_str();
+            level.levelTexts.push_back(text);
+        }
+
+        level.obstacles.clear();
+        int obstacleCount = reader.GetU16();
+        for (int i = 0; i < obstacleCount && reader.Ok(); i++) level.obstacles.push_back(reader.GetRect());
+
+        level.triangleObstacles.clear();
+        int triangleCount = reader.GetU16();
+        for (int i = 0; i < triangleCount && reader.Ok(); i++) {
+            Vector2 p1 = reader.GetVector();
+            Vector2 p2 = reader.GetVector();
+            Vector2 p3 = reader.GetVector();
+            level.triangleObstacles.push_back({p1, p2, p3, true});
+        }
+
+        level.walls.clear();
+        unsigned int firstWall = reader.Get<uint32_t>();
+        int wallCount = reader.GetU16();
+        for (int i = 0; i < wallCount && reader.Ok(); i++) {
+            Rectangle rect = reader.GetRect();
+            Rectangle weakSpot = reader.GetRect();
+            bool active = reader.GetU8() != 0;
+            level.walls.push_back({rect, weakSpot, active});
+        }
+        level.wallsAdded = firstWall + (unsigned int)level.walls.size();
+    } else {
+        float shift = distance - level.GetDistance();
+        if (shift != 0.0f) level.Scroll(shift);
+
+        int obstacleCount = reader.GetU16();
+        for (int i = 0; i < obstacleCount && reader.Ok(); i++) level.obstacles.push_back(reader.GetRect());
+
+        int triangleCount = reader.GetU16();
+        for (int i = 0; i < triangleCount && reader.Ok(); i++) {
+            Vector2 p1 = reader.GetVector();
+            Vector2 p2 = reader.GetVector();
+            Vector2 p3 = reader.GetVector();
+            level.triangleObstacles.push_back({p1, p2, p3, true});
+        }
+
+        int wallCount = reader.GetU16();
+        for (int i = 0; i < wallCount && reader.Ok(); i++) {
+            Rectangle rect = reader.GetRect();
+            Rectangle weakSpot = reader.GetRect();
+            level.walls.push_back({rect, weakSpot, true});
+            level.wallsAdded++;
+        }
+
+        int brokenCount = reader.GetU16();
+        unsigned int firstWall = level.wallsAdded - (unsigned int)level.walls.size();
+        for (int i = 0; i < brokenCount && reader.Ok(); i++) {
+            unsigned int wall = reader.Get<uint32_t>();
+            if (wall >= firstWall && wall - firstWall < level.walls.size()) level.walls[wall - firstWall].active = false;
+        }
+    }
+    level.distanceTraveled = Scalar(distance);
+
+    // Entities
+    EntityManager& entities = view.entities;
+    std::vector<char> keep;
+    for (int kind = 0; kind < EntityKindCount && reader.Ok(); kind++) {
+        std::vector<EntityRecord>& records = known[kind];
+
+        if (keyframe) {
+            records.clear();
+        } else {
+            keep.assign(records.size(), 1);
+            int removedCount = reader.GetU16();
+            for (int i = 0; i < removedCount && reader.Ok(); i++) {
+                size_t index = reader.GetU16();
+                if (index >= keep.size()) return false;
+                keep[index] = 0;
+            }
+            Compact(records, keep);
+
+            size_t maskSize = (records.size() + 7) / 8;
+            const uint8_t* mask = reader.GetBytes(maskSize);
+            if (!mask) return false;
+            for (size_t i = 0; i < records.size(); i++) {
+                if (!(mask[i / 8] & (1 << (i % 8)))) continue;
+                records[i].x += reader.Get<int16_t>();
+                records[i].y += reader.Get<int16_t>();
+                records[i].extra = reader.Get<int16_t>();
+            }
+        }
+
+        size_t survivors = records.size();
+        int addedCount = reader.GetU16();
+        for (int i = 0; i < addedCount && reader.Ok(); i++) records.push_back(GetRecord(reader, kind));
+        if (!reader.Ok()) return false;
+
+        // Mirror the records into the entity list the renderer draws
+        switch (kind) {
+            case Missiles:
+                if (keyframe) entities.missiles.clear();
+                else Compact(entities.missiles, keep);
+                for (size_t i = 0; i < records.size(); i++) {
+                    const EntityRecord& r = records[i];
+                    Vector2 pos = Dequantize(r);
+                    if (i >= survivors) {
+                        MissileType type = (MissileType)r.type;
+                        if (type == MissileType::Random || type > MissileType::Seeker) type = MissileType::Standard;
+                        entities.missiles.push_back(MissileFactory::Create(type, pos));
+                    }
+                    Missile& m = *entities.missiles[i];
+                    m.position = SimVec2::From(pos);
+                    m.rotation = r.extra / RotationScale;
+                }
+                break;
+            case Projectiles:
+                if (keyframe) entities.projectiles.clear();
+                else Compact(entities.projectiles, keep);
+                for (size_t i = 0; i < records.size(); i++) {
+                    Projectile p(Dequantize(records[i]), Vector2{0, 0}, true);
+                    if (i < survivors) entities.projectiles[i] = p;
+                    else entities.projectiles.push_back(p);
+                }
+                break;
+            case Rocks:
+                if (keyframe) entities.rocks.clear();
+                else Compact(entities.rocks, keep);
+                for (size_t i = 0; i < records.size(); i++) {
+                    Rock rock(Dequantize(records[i]), records[i].extra / PositionScale);
+                    if (i < survivors) entities.rocks[i] = rock;
+                    else entities.rocks.push_back(rock);
+                }
+                break;
+            case Explosions:
+                if (keyframe) entities.explosions.clear();
+                else Compact(entities.explosions, keep);
+                for (size_t i = 0; i < records.size(); i++) {
+                    if (i >= survivors) entities.explosions.emplace_back(Dequantize(records[i]));
+                    Explosion& e = entities.explosions[i];
+                    e.position = Dequantize(records[i]);
+                    e.timer = records[i].extra / TimerScale;
+                    e.active = e.timer > 0.0f;
+                }
+                break;
+        }
+    }
+    if (!reader.Ok()) return false;
+
+    hasState = true;
+    return true;
+}
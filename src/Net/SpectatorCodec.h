@@ -0,0 +1,78 @@
+#pragma once
+#include "SimSnapshot.h"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+// Wire format between the spectator server and its viewers. Every packet is
+//   u32 size | u32 tick | u8 kind | body
+// A keyframe carries everything a viewer draws. A delta carries only what
+// changed since the previous packet in the stream: the scroll distance, new
+// terrain pieces, broken walls, and per entity kind the removed entries,
+// the moved survivors and the new ones. Positions are quantized to 1/8 px.
+namespace SpectatorProtocol {
+    constexpr size_t HeaderSize = 9;
+
+    enum class PacketKind : uint8_t {
+        Delta = 0,
+        Keyframe = 1
+    };
+
+    uint32_t ReadSize(const uint8_t* header);
+    PacketKind ReadKind(const uint8_t* header);
+
+    // One entity as the viewer knows it
+    struct EntityRecord {
+        uint32_t id;    // Encoder side only
+        int32_t x;      // 1/8 px
+        int32_t y;
+        int16_t extra;  // Missile rotation, rock radius or explosion timer
+        uint8_t type;   // MissileType for missiles
+    };
+
+    enum EntityKind { Missiles, Projectiles, Rocks, Explosions, EntityKindCount };
+}
+
+// Publisher side: turns successive snapshots into packets
+class SpectatorEncoder {
+public:
+    // Appends one packet for `view` to `out`. A delta is relative to the
+    // previous Encode(); a keyframe is written instead when `keyframe` is set
+    // or the game restarted. Returns true if the packet is a keyframe.
+    bool Encode(const SimSnapshot& view, bool keyframe, std::vector<uint8_t>& out);
+
+private:
+    using EntityRecord = SpectatorProtocol::EntityRecord;
+
+    bool hasState = false;
+    unsigned int run = 0;
+    unsigned int obstaclesSent = 0;
+    unsigned int trianglesSent = 0;
+    unsigned int wallsSent = 0;
+    std::vector<unsigned int> brokenWallsSent; // Running wall numbers
+
+    // What the viewers hold, per entity kind, in their list order
+    std::vector<EntityRecord> sent[SpectatorProtocol::EntityKindCount];
+    std::vector<EntityRecord> current;  // Scratch
+
+    void Collect(const SimSnapshot& view, int kind);
+    void EncodeLevel(const Level& level, bool keyframe, std::vector<uint8_t>& out);
+    void EncodeEntities(int kind, bool keyframe, std::vector<uint8_t>& out);
+};
+
+// Viewer side: applies packets to a snapshot that the game then draws
+class SpectatorDecoder {
+public:
+    // Returns false if the packet is malformed. Deltas are ignored until the
+    // first keyframe arrives.
+    bool Apply(const uint8_t* packet, size_t size, SimSnapshot& view);
+    bool HasState() const { return hasState; }
+
+private:
+    using EntityRecord = SpectatorProtocol::EntityRecord;
+
+    bool hasState = false;
+    std::vector<EntityRecord> known[SpectatorProtocol::EntityKindCount];
+    std::set<std::string> texts;  // Backing storage for tutorial text pointers
+};
@@ -0,0 +1,167 @@
+#include "SpectatorServer.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+bool SpectatorServer::Start(int port) {
+    Stop();
+    listener = Net::Listen(port);
+    if (listener == Net::InvalidHandle) {
+        TraceLog(LOG_WARNING, "SPECTATOR: Could not listen on 127.0.0.1:%d", port);
+        return false;
+    }
+
+    ring.assign(SpectatorConst::RingBytes, 0);
+    head = 0;
+    reclaim = 0;
+    for (auto& keyframe : keyframes) keyframe = NoKeyframe;
+    hasPublished = false;
+    dropped = false;
+    keyframeRequested = true; // The ring starts empty
+    stopping = false;
+    thread = std::thread(&SpectatorServer::NetworkLoop, this);
+    TraceLog(LOG_INFO, "SPECTATOR: Broadcasting on 127.0.0.1:%d", port);
+    return true;
+}
+
+void SpectatorServer::Stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+
+    for (auto& viewer : viewers) Net::Close(viewer.socket);
+    viewers.clear();
+    Net::Close(listener);
+    listener = Net::InvalidHandle;
+
+    if (packetsPublished > 0) {
+        TraceLog(LOG_INFO, "SPECTATOR: %lu packets (%lu keyframes), %.1f bytes per packet",
+                 packetsPublished, keyframesPublished, (double)head.load() / packetsPublished);
+    }
+}
+
+void SpectatorServer::Publish(const SimSnapshot& view) {
+    if (!thread.joinable()) return;
+    if (hasPublished && view.tick == lastTick && view.run == lastRun) return;
+    hasPublished = true;
+    lastTick = view.tick;
+    lastRun = view.run;
+
+    // After a dropped packet the chain of deltas is broken for everyone
+    bool keyframe = dropped || keyframeRequested.exchange(false) || ++ticksSinceKeyframe >= SpectatorConst::KeyframeInterval;
+    packet.clear();
+    keyframe = encoder.Encode(view, keyframe, packet);
+
+    const uint64_t size = ring.size();
+    const uint64_t position = head.load(std::memory_order_relaxed);
+    if (position + packet.size() > reclaim.load(std::memory_order_acquire) + size) {
+        // A viewer is still sending from the space we need; never block the game on it
+        dropped = true;
+        return;
+    }
+
+    size_t start = (size_t)(position % size);
+    size_t first = std::min(packet.size(), (size_t)size - start);
+    memcpy(ring.data() + start, packet.data(), first);
+    memcpy(ring.data(), packet.data() + first, packet.size() - first);
+
+    if (keyframe) {
+        int slot = nextKeyframeSlot.load(std::memory_order_relaxed);
+        keyframes[slot].store(position, std::memory_order_relaxed);
+        nextKeyframeSlot.store((slot + 1) % SpectatorConst::KeyframeHistory, std::memory_order_relaxed);
+        ticksSinceKeyframe = 0;
+        keyframesPublished++;
+    }
+    head.store(position + packet.size(), std::memory_order_release);
+    dropped = false;
+    packetsPublished++;
+
+    wake.notify_one();
+}
+
+uint64_t SpectatorServer::FindKeyframe(uint64_t from, uint64_t head) const {
+    uint64_t newest = NoKeyframe;
+    for (const auto& slot : keyframes) {
+        uint64_t position = slot.load(std::memory_order_relaxed);
+        if (position < from || position >= head) continue;
+        if (newest == NoKeyframe || position > newest) newest = position;
+    }
+    return newest;
+}
+
+uint32_t SpectatorServer::ReadPacketSize(uint64_t position) const {
+    uint8_t header[4];
+    for (int i = 0; i < 4; i++) header[i] = ring[(position + i) % ring.size()];
+    return SpectatorProtocol::ReadSize(header);
+}
+
+bool SpectatorServer::Serve(Viewer& viewer, uint64_t head) {
+    const uint64_t size = ring.size();
+
+    if (viewer.synced && viewer.cursor == viewer.packetEnd && head - viewer.cursor > size / 2) {
+        // Too slow to follow the deltas; skip ahead to a fresh keyframe
+        viewer.synced = false;
+    }
+    if (!viewer.synced) {
+        uint64_t keyframe = FindKeyframe(viewer.cursor, head);
+        if (keyframe == NoKeyframe || head - keyframe > size / 2) {
+            viewer.cursor = viewer.packetEnd = head;
+            keyframeRequested = true;
+            return true;
+        }
+        viewer.cursor = viewer.packetEnd = keyframe;
+        viewer.synced = true;
+    }
+
+    // Stalled in the middle of a packet: the ring is about to need those bytes
+    if (head - viewer.cursor > size * 3 / 4) return false;
+    if (viewer.cursor == head) return true;
+
+    // Straight from the ring; at most two pieces when the data wraps
+    size_t start = (size_t)(viewer.cursor % size);
+    size_t pending = (size_t)(head - viewer.cursor);
+    size_t first = std::min(pending, (size_t)size - start);
+    long sent = Net::SendPair(viewer.socket, ring.data() + start, first, ring.data(), pending - first);
+    if (sent < 0) return false;
+
+    viewer.cursor += sent;
+    while (viewer.packetEnd < viewer.cursor) viewer.packetEnd += ReadPacketSize(viewer.packetEnd);
+    return true;
+}
+
+void SpectatorServer::NetworkLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            // Woken by every publish; the timeout retries full sockets and accepts newcomers
+            wake.wait_for(lock, std::chrono::milliseconds(5));
+            if (stopping) return;
+        }
+
+        const uint64_t position = head.load(std::memory_order_acquire);
+        for (Net::Handle socket; (socket = Net::Accept(listener)) != Net::InvalidHandle; ) {
+            viewers.push_back({socket, position, position, false});
+            keyframeRequested = true;
+            TraceLog(LOG_INFO, "SPECTATOR: Viewer connected (%d watching)", (int)viewers.size());
+        }
+
+        uint64_t oldest = position;
+        for (size_t i = 0; i < viewers.size(); ) {
+            if (!Serve(viewers[i], position)) {
+                Net::Close(viewers[i].socket);
+                viewers.erase(viewers.begin() + i);
+                TraceLog(LOG_INFO, "SPECTATOR: Viewer disconnected (%d watching)", (int)viewers.size());
+                continue;
+            }
+            oldest = std::min(oldest, viewers[i].cursor);
+            i++;
+        }
+        reclaim.store(oldest, std::memory_order_release);
+        viewerCount.store((int)viewers.size(), std::memory_order_relaxed);
+    }
+}
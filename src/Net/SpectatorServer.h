@@ -0,0 +1,79 @@
+#pragma once
+#include "SimSnapshot.h"
+#include "SpectatorCodec.h"
+#include "Socket.h"
+#include "Constants.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Broadcasts the game to local viewers (--spectate) over loopback TCP.
+//
+// Each tick is encoded once, as a delta against the previous tick, into a
+// ring shared by every viewer. A network thread sends each viewer the bytes
+// between its cursor and the head straight out of the ring, so the cost on
+// the game thread does not grow with the number of viewers and every viewer
+// receives the same stream. Viewers that join, or fall more than half a ring
+// behind, are moved to the next keyframe.
+class SpectatorServer {
+public:
+    SpectatorServer() = default;
+    ~SpectatorServer() { Stop(); }
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+
+    bool Start(int port);
+    void Stop();
+    // Encodes `view` into the ring; repeated calls with the same tick are ignored
+    void Publish(const SimSnapshot& view);
+    int GetViewerCount() const { return viewerCount.load(std::memory_order_relaxed); }
+
+private:
+    using SpectatorConst = Constants::Spectator;
+    static constexpr uint64_t NoKeyframe = ~0ull;
+
+    struct Viewer {
+        Net::Handle socket;
+        uint64_t cursor;     // Next stream byte to send
+        uint64_t packetEnd;  // End of the packet `cursor` is in
+        bool synced;         // Positioned at or after a keyframe
+    };
+
+    void NetworkLoop();
+    // Returns false once the viewer should be dropped
+    bool Serve(Viewer& viewer, uint64_t head);
+    // Newest keyframe in [from, head), or NoKeyframe
+    uint64_t FindKeyframe(uint64_t from, uint64_t head) const;
+    uint32_t ReadPacketSize(uint64_t position) const;
+
+    // Game thread
+    SpectatorEncoder encoder;
+    std::vector<uint8_t> packet;
+    bool hasPublished = false;
+    unsigned long lastTick = 0;
+    unsigned int lastRun = 0;
+    int ticksSinceKeyframe = 0;
+    bool dropped = false;
+    unsigned long packetsPublished = 0;
+    unsigned long keyframesPublished = 0;
+
+    // Shared; stream positions count bytes since Start() and never wrap
+    std::vector<uint8_t> ring;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> reclaim{0};  // The game thread may write up to reclaim + ring size
+    std::atomic<uint64_t> keyframes[SpectatorConst::KeyframeHistory];
+    std::atomic<int> nextKeyframeSlot{0};
+    std::atomic<bool> keyframeRequested{false};
+    std::atomic<int> viewerCount{0};
+
+    // Network thread
+    Net::Handle listener = Net::InvalidHandle;
+    std::vector<Viewer> viewers;
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
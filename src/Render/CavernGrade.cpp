@@ -0,0 +1,178 @@
+#include "CavernGrade.h"
+#include "Constants.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define CAVERN_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CAVERN_TARGET_AVX2
+#else
+#define CAVERN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+using RenderConst = Constants::Render;
+
+namespace {
+    // Tint of the shader, per channel
+    constexpr float TintR = 0.9f;
+    constexpr float TintG = 0.95f;
+    constexpr float TintB = 1.05f;
+
+    // smoothstep(0.9, 0.2, len)
+    double Vignette(double len) {
+        double t = std::clamp((len - 0.9) / (0.2 - 0.9), 0.0, 1.0);
+        return t * t * (3.0 - 2.0 * t);
+    }
+
+    // Squared distances run up to 0.5 (the corners), so index
+    // (int)(d2 * scale + 0.5) stays inside the table without clamping
+    constexpr int LutSize = RenderConst::VignetteLutSize;
+    constexpr float LutScale = (LutSize - 1) / 0.5f;
+
+    // The kernels share this operation order so they produce the same bytes.
+    // 255 goes first so the compiler emits minss instead of a branch.
+    inline uint32_t GradeChannel(uint32_t value, float factor) {
+        return (uint32_t)(std::min(255.0f, (float)value * factor) + 0.5f);
+    }
+
+    void GradeRowScalar(uint32_t* row, int begin, int end, const float* columnSquares,
+                        float rowSquare, const float* vignette) {
+        for (int x = begin; x < end; x++) {
+            float k = vignette[(int)((columnSquares[x] + rowSquare) * LutScale + 0.5f)];
+            uint32_t p = row[x];
+            row[x] = GradeChannel(p & 0xff, k * TintR) |
+                     (GradeChannel((p >> 8) & 0xff, k * TintG) << 8) |
+                     (GradeChannel((p >> 16) & 0xff, k * TintB) << 16) |
+                     (p & 0xff000000u);
+        }
+    }
+
+#ifdef CAVERN_AVX2
+    CAVERN_TARGET_AVX2
+    __m256i GradeChannels8(__m256i channel, __m256 factor) {
+        __m256 value = _mm256_cvtepi32_ps(channel);
+        value = _mm256_min_ps(_mm256_mul_ps(value, factor), _mm256_set1_ps(255.0f));
+        return _mm256_cvttps_epi32(_mm256_add_ps(value, _mm256_set1_ps(0.5f)));
+    }
+
+    // Eight pixels per step, the rest through the scalar loop
+    CAVERN_TARGET_AVX2
+    void GradeRowAvx2(uint32_t* row, int width, const float* columnSquares, float rowSquare,
+                      const float* vignette) {
+        const __m256 rowD2 = _mm256_set1_ps(rowSquare);
+        const __m256 scale = _mm256_set1_ps(LutScale);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256i byteMask = _mm256_set1_epi32(0xff);
+        const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000u);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            __m256 d2 = _mm256_add_ps(_mm256_loadu_ps(columnSquares + x), rowD2);
+            __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(d2, scale), half));
+            __m256 k = _mm256_i32gather_ps(vignette, index, 4);
+
+            __m256i p = _mm256_loadu_si256((const __m256i*)(row + x));
+            __m256i r = GradeChannels8(_mm256_and_si256(p, byteMask), _mm256_mul_ps(k, _mm256_set1_ps(TintR)));
+            __m256i g = GradeChannels8(_mm256_and_si256(_mm256_srli_epi32(p, 8), byteMask),
+                                       _mm256_mul_ps(k, _mm256_set1_ps(TintG)));
+            __m256i b = GradeChannels8(_mm256_and_si256(_mm256_srli_epi32(p, 16), byteMask),
+                                       _mm256_mul_ps(k, _mm256_set1_ps(TintB)));
+
+            __m256i out = _mm256_or_si256(r, _mm256_slli_epi32(g, 8));
+            out = _mm256_or_si256(out, _mm256_slli_epi32(b, 16));
+            out = _mm256_or_si256(out, _mm256_and_si256(p, alphaMask));
+            _mm256_storeu_si256((__m256i*)(row + x), out);
+        }
+        // Dirty upper halves would slow down the SSE code that runs next
+        _mm256_zeroupper();
+        GradeRowScalar(row, x, width, columnSquares, rowSquare, vignette);
+    }
+
+    bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
+
+CavernGrade::CavernGrade(int width, int height)
+    : width(width), height(height), kernel(BestKernel()),
+      columnSquares(width), rowSquares(height), vignette(LutSize) {
+    for (int x = 0; x < width; x++) {
+        float u = (x + 0.5f) / width - 0.5f;
+        columnSquares[x] = u * u;
+    }
+    for (int y = 0; y < height; y++) {
+        float v = (y + 0.5f) / height - 0.5f;
+        rowSquares[y] = v * v;
+    }
+    // Sampled at the squared distance each entry stands for, then folded with the 50% mix
+    for (int i = 0; i < LutSize; i++) {
+        vignette[i] = (float)(0.5 + 0.5 * Vignette(std::sqrt(i / (double)LutScale)));
+    }
+}
+
+void CavernGrade::Apply(uint32_t* pixels) const {
+    Jobs::ParallelFor(height, RenderConst::PostRowGrain, [&](int begin, int end) {
+        ApplyRows(pixels, begin, end);
+    });
+}
+
+void CavernGrade::ApplyRows(uint32_t* pixels, int firstRow, int endRow) const {
+    for (int y = firstRow; y < endRow; y++) {
+        uint32_t* row = pixels + (size_t)y * width;
+#ifdef CAVERN_AVX2
+        if (kernel == Kernel::Avx2) {
+            GradeRowAvx2(row, width, columnSquares.data(), rowSquares[y], vignette.data());
+            continue;
+        }
+#endif
+        GradeRowScalar(row, 0, width, columnSquares.data(), rowSquares[y], vignette.data());
+    }
+}
+
+void CavernGrade::SetKernel(Kernel value) {
+    kernel = value == Kernel::Avx2 ? BestKernel() : value;
+}
+
+CavernGrade::Kernel CavernGrade::BestKernel() {
+#ifdef CAVERN_AVX2
+    static const bool hasAvx2 = CpuHasAvx2();
+    if (hasAvx2) return Kernel::Avx2;
+#endif
+    return Kernel::Scalar;
+}
+
+const char* CavernGrade::GetKernelName(Kernel kernel) {
+    return kernel == Kernel::Avx2 ? "AVX2" : "scalar";
+}
+
+uint32_t CavernGrade::Reference(uint32_t pixel, int x, int y, int width, int height) {
+    double u = (x + 0.5) / width - 0.5;
+    double v = (y + 0.5) / height - 0.5;
+    double vignette = Vignette(std::sqrt(u * u + v * v));
+
+    // texelColor.rgb *= tint; mix(rgb, rgb * vignette, 0.5); stored as unorm8
+    const double tint[3] = { TintR, TintG, TintB };
+    uint32_t out = pixel & 0xff000000u;
+    for (int c = 0; c < 3; c++) {
+        double value = ((pixel >> (c * 8)) & 0xff) * tint[c];
+        value = value * 0.5 + value * vignette * 0.5;
+        out |= (uint32_t)std::lround(std::clamp(value, 0.0, 255.0)) << (c * 8);
+    }
+    return out;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// CPU version of assets/cavern.fs: a radial vignette mixed in at 50% and a
+// cold RGB tint, applied in place to an RGBA8 framebuffer. The vignette is
+// looked up by squared distance from the center (per-column and per-row
+// squares are precomputed for the framebuffer size), so the per-pixel work
+// is an add, a table load and three multiplies. Rows are split across the
+// job system; the AVX2 kernel does eight pixels per step and is picked at
+// runtime when the CPU has it.
+class CavernGrade {
+public:
+    enum class Kernel { Scalar, Avx2 };
+
+    CavernGrade(int width, int height);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    // Row-major, top row first, width * height pixels; alpha is left alone
+    void Apply(uint32_t* pixels) const;
+    void ApplyRows(uint32_t* pixels, int firstRow, int endRow) const;
+
+    // Defaults to the best one the CPU runs; forcing Avx2 without CPU support falls back
+    void SetKernel(Kernel value);
+    Kernel GetKernel() const { return kernel; }
+    static Kernel BestKernel();
+    static const char* GetKernelName(Kernel kernel);
+
+    // The shader's formula evaluated exactly in float for the pixel at
+    // (x, y), for checking the kernels
+    static uint32_t Reference(uint32_t pixel, int x, int y, int width, int height);
+
+private:
+    int width;
+    int height;
+    Kernel kernel;
+    std::vector<float> columnSquares;   // ((x + 0.5) / width - 0.5)^2
+    std::vector<float> rowSquares;
+    std::vector<float> vignette;        // Brightness factor by squared distance
+};
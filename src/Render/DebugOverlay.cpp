@@ -0,0 +1,134 @@
+#include "DebugOverlay.h"
+#include "Gfx.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    constexpr int PanelX = 10;
+    constexpr int PanelY = Constants::ControlPanelHeight + 10;
+    constexpr int PanelWidth = 2 * 240 + 20;
+    constexpr int LineHeight = 14;
+    constexpr int GraphHeight = 40;
+    constexpr float LatencyGraphMs = 50.0f; // Full height of the latency graph
+
+    // Percentile of a history window; copies because nth_element reorders
+    template<int N>
+    float Percentile(const float (&history)[N], float p) {
+        float sorted[N];
+        std::copy(history, history + N, sorted);
+        int index = std::clamp((int)(p / 100.0f * (N - 1)), 0, N - 1);
+        std::nth_element(sorted, sorted + index, sorted + N);
+        return sorted[index];
+    }
+}
+
+void DebugOverlay::Sample() {
+    for (int i = 0; i < TagCount; i++) {
+        AllocTracker::Stats s = AllocTracker::GetStats((AllocTracker::Tag)i);
+        allocsPerFrame[i] = s.allocations - lastAllocations[i];
+        lastAllocations[i] = s.allocations;
+    }
+
+    size_t frameAllocs = 0;
+    for (int i = 0; i < TagCount; i++) frameAllocs += allocsPerFrame[i];
+    liveHistory[head] = AllocTracker::GetTotals().liveBytes;
+    allocHistory[head] = frameAllocs;
+    head = (head + 1) % HistoryLength;
+}
+
+void DebugOverlay::SampleTiming(double latencyMs, double pacingErrorMs) {
+    // Frames that showed no new tick keep the previous latency
+    if (latencyMs < 0.0) latencyMs = latencyHistory[(timingHead + HistoryLength - 1) % HistoryLength];
+    latencyHistory[timingHead] = (float)latencyMs;
+    pacingHistory[timingHead] = (float)pacingErrorMs;
+    timingHead = (timingHead + 1) % HistoryLength;
+}
+
+void DebugOverlay::SampleParticles(int count, double updateMs) {
+    particleCount = count;
+    particleHistory[particleHead] = (float)updateMs;
+    particleHead = (particleHead + 1) % HistoryLength;
+}
+
+void DebugOverlay::SampleDraw(const DrawList& list) {
+    for (int i = 0; i < SubsystemCount; i++) drawStats[i] = list.GetStats((DrawList::Subsystem)i);
+}
+
+void DebugOverlay::Draw() {
+    if (!visible) return;
+
+    char line[128];
+    int slot = 0;
+    int y = PanelY + 6;
+
+    const int lines = TagCount + 6 + SubsystemCount;
+    const int panelHeight = 6 + lines * LineHeight + 3 * (GraphHeight + 6) + 6;
+    Gfx::DrawRectangle(PanelX, PanelY, PanelWidth, panelHeight, (Color){0, 0, 0, 180});
+
+    AllocTracker::Stats totals = AllocTracker::GetTotals();
+    snprintf(line, sizeof(line), "Heap  %8.1f KB live  %4zu allocs/frame",
+             totals.liveBytes / 1024.0, allocHistory[(head + HistoryLength - 1) % HistoryLength]);
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, WHITE);
+    y += LineHeight;
+
+    snprintf(line, sizeof(line), "%-9s %10s %8s %10s", "tag", "live KB", "/frame", "allocs");
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, GRAY);
+    y += LineHeight;
+
+    for (int i = 0; i < TagCount; i++) {
+        AllocTracker::Stats s = AllocTracker::GetStats((AllocTracker::Tag)i);
+        snprintf(line, sizeof(line), "%-9s %10.1f %8zu %10zu", AllocTracker::GetTagName((AllocTracker::Tag)i),
+                 s.liveBytes / 1024.0, allocsPerFrame[i], s.allocations);
+        text.SetDefault(slot++, line, PanelX + 6, y, 10, LIGHTGRAY);
+        y += LineHeight;
+    }
+
+    snprintf(line, sizeof(line), "Input->present  p50 %5.1f  p99 %5.1f ms",
+             Percentile(latencyHistory, 50), Percentile(latencyHistory, 99));
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, LIME);
+    y += LineHeight;
+    snprintf(line, sizeof(line), "Pacing error    p50 %5.2f  p99 %5.2f ms",
+             Percentile(pacingHistory, 50), Percentile(pacingHistory, 99));
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, LIGHTGRAY);
+    y += LineHeight;
+    snprintf(line, sizeof(line), "Particles %6d  update p99 %5.3f ms",
+             particleCount, Percentile(particleHistory, 99));
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, LIGHTGRAY);
+    y += LineHeight;
+
+    snprintf(line, sizeof(line), "%-10s %6s %6s %6s %7s %7s", "draw", "cmds", "culled", "calls", "verts", "flushes");
+    text.SetDefault(slot++, line, PanelX + 6, y, 10, GRAY);
+    y += LineHeight;
+    for (int i = 0; i < SubsystemCount; i++) {
+        const DrawList::Stats& s = drawStats[i];
+        snprintf(line, sizeof(line), "%-10s %6d %6d %6d %7d %7d", DrawList::GetSubsystemName((DrawList::Subsystem)i),
+                 s.commands, s.culled, s.drawCalls, s.vertices, s.flushes);
+        text.SetDefault(slot++, line, PanelX + 6, y, 10, LIGHTGRAY);
+        y += LineHeight;
+    }
+    text.Draw();
+
+    // Oldest sample on the left; a healthy session is flat on top and empty below
+    size_t maxLive = 1;
+    size_t maxAllocs = 1;
+    for (int i = 0; i < HistoryLength; i++) {
+        maxLive = std::max(maxLive, liveHistory[i]);
+        maxAllocs = std::max(maxAllocs, allocHistory[i]);
+    }
+    int liveBase = y + GraphHeight;
+    int allocBase = liveBase + 6 + GraphHeight;
+    int latencyBase = allocBase + 6 + GraphHeight;
+    for (int i = 0; i < HistoryLength; i++) {
+        int sample = (head + i) % HistoryLength;
+        int x = PanelX + 10 + i * 2;
+        int liveH = (int)(GraphHeight * (double)liveHistory[sample] / maxLive);
+        int allocH = (int)(GraphHeight * (double)allocHistory[sample] / maxAllocs);
+        Gfx::DrawRectangle(x, liveBase - liveH, 2, liveH, SKYBLUE);
+        Gfx::DrawRectangle(x, allocBase - allocH, 2, allocH, ORANGE);
+
+        int timing = (timingHead + i) % HistoryLength;
+        int latencyH = (int)(GraphHeight * std::min(latencyHistory[timing] / LatencyGraphMs, 1.0f));
+        Gfx::DrawRectangle(x, latencyBase - latencyH, 2, latencyH, LIME);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "raylib.h"
+#include "AllocTracker.h"
+#include "TextCache.h"
+#include "DrawList.h"
+#include <cstddef>
+
+// F3 overlay with runtime counters. Samples are taken every frame, visible
+// or not, so the history graphs are already filled when it is opened.
+class DebugOverlay {
+public:
+    void Toggle() { visible = !visible; }
+    bool IsVisible() const { return visible; }
+
+    // Call once per frame
+    void Sample();
+    // Input-to-present latency of the frame just shown (negative if it showed
+    // no new tick) and how late the frame pacer woke
+    void SampleTiming(double latencyMs, double pacingErrorMs);
+    // Live particles and the time their update took this frame
+    void SampleParticles(int count, double updateMs);
+    // Command counts of the frame's world geometry
+    void SampleDraw(const DrawList& list);
+    void Draw();
+
+private:
+    static constexpr int HistoryLength = 240;
+    static constexpr int TagCount = (int)AllocTracker::Tag::Count;
+
+    bool visible = false;
+
+    // Heap graph: live bytes and allocations per frame over the last frames
+    size_t liveHistory[HistoryLength] = {};
+    size_t allocHistory[HistoryLength] = {};
+    int head = 0;
+
+    // Frame timing graph, same window as the heap graph
+    float latencyHistory[HistoryLength] = {};
+    float pacingHistory[HistoryLength] = {};
+    int timingHead = 0;
+
+    int particleCount = 0;
+    float particleHistory[HistoryLength] = {}; // Update ms
+    int particleHead = 0;
+
+    static constexpr int SubsystemCount = (int)DrawList::Subsystem::Count;
+    DrawList::Stats drawStats[SubsystemCount];
+
+    size_t lastAllocations[TagCount] = {};
+    size_t allocsPerFrame[TagCount] = {};
+
+    TextCache text;
+};
@@ -0,0 +1,221 @@
+#include "DrawList.h"
+#include "Constants.h"
+#include "Gfx.h"
+#include "SoftRenderer.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+using RenderConst = Constants::Render;
+
+namespace {
+    constexpr DrawList::Subsystem LayerSubsystem[] = {
+        DrawList::Subsystem::Background,    // BackgroundFar
+        DrawList::Subsystem::Background,    // BackgroundNear
+        DrawList::Subsystem::Level,         // StartPad
+        DrawList::Subsystem::Level,         // Terrain
+        DrawList::Subsystem::Entities,      // Entities
+        DrawList::Subsystem::Helicopter,    // Helicopter
+    };
+    static_assert(sizeof(LayerSubsystem) / sizeof(LayerSubsystem[0]) == (int)DrawLayer::Count, "One subsystem per layer");
+
+    // Same tessellation as raylib's DrawCircleV(), DrawEllipse() and DrawRing()
+    constexpr int Segments = 36;
+    struct UnitCircle {
+        float cs[Segments + 1], sn[Segments + 1];
+        UnitCircle() {
+            for (int i = 0; i <= Segments; i++) {
+                float angle = DEG2RAD * 360.0f * i / Segments;
+                cs[i] = cosf(angle);
+                sn[i] = sinf(angle);
+            }
+        }
+    };
+    const UnitCircle Unit;
+
+    // Per DrawList::Primitive: rlgl mode and vertices
+    constexpr int Modes[] = { RL_QUADS, RL_QUADS, RL_QUADS, RL_TRIANGLES, RL_TRIANGLES, RL_TRIANGLES };
+    constexpr int VertexCounts[] = { 4, 4, Segments * 4, 3, Segments * 3, Segments * 3 };
+
+    bool Overlaps(Rectangle a, Rectangle b) {
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    Rectangle Bounds(std::initializer_list<Vector2> points) {
+        Vector2 lo = *points.begin(), hi = lo;
+        for (Vector2 p : points) {
+            lo = { std::min(lo.x, p.x), std::min(lo.y, p.y) };
+            hi = { std::max(hi.x, p.x), std::max(hi.y, p.y) };
+        }
+        return { lo.x, lo.y, hi.x - lo.x, hi.y - lo.y };
+    }
+
+    void Vertex(Vector2 p) { rlVertex2f(p.x, p.y); }
+}
+
+const char* DrawList::GetSubsystemName(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Background: return "background";
+        case Subsystem::Level:      return "level";
+        case Subsystem::Entities:   return "entities";
+        case Subsystem::Helicopter: return "heli";
+        default:                    return "?";
+    }
+}
+
+void DrawList::Begin(Rectangle view) {
+    viewport = view;
+    layer = DrawLayer::BackgroundFar;
+    commands.clear();
+    keys.clear();
+    replayed = 0;
+    batchVertices = 0;
+    batchDraws = 0;
+    for (Stats& s : stats) s = Stats();
+}
+
+void DrawList::Add(Primitive primitive, Rectangle bounds, Color color, Vector2 a, Vector2 b, Vector2 c, Vector2 d) {
+    Stats& s = stats[(int)LayerSubsystem[(int)layer]];
+    s.commands++;
+    // Touching counts as visible: an edge on the viewport border can still cover pixel centers
+    bounds.width = std::max(bounds.width, 1.0f);
+    bounds.height = std::max(bounds.height, 1.0f);
+    if (color.a == 0 || !Overlaps(bounds, viewport)) {
+        s.culled++;
+        return;
+    }
+    commands.push_back({ { a, b, c, d }, color, primitive, layer });
+}
+
+void DrawList::Rect(Rectangle rec, Color color) {
+    if (rec.width <= 0 || rec.height <= 0) return;
+    Add(Primitive::Rect, rec, color, { rec.x, rec.y }, { rec.width, rec.height });
+}
+
+void DrawList::Quad(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4, Color color) {
+    Add(Primitive::Quad, Bounds({ p1, p2, p3, p4 }), color, p1, p2, p3, p4);
+}
+
+void DrawList::Triangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    Add(Primitive::Triangle, Bounds({ v1, v2, v3 }), color, v1, v2, v3);
+}
+
+void DrawList::Circle(Vector2 center, float radius, Color color) {
+    if (radius <= 0) return;
+    Add(Primitive::Circle, { center.x - radius, center.y - radius, radius * 2, radius * 2 }, color, center, { radius, 0 });
+}
+
+void DrawList::Ellipse(Vector2 center, float radiusH, float radiusV, Color color) {
+    Add(Primitive::Ellipse, { center.x - radiusH, center.y - radiusV, radiusH * 2, radiusV * 2 }, color, center, { radiusH, radiusV });
+}
+
+void DrawList::Ring(Vector2 center, float innerRadius, float outerRadius, Color color) {
+    Add(Primitive::Ring, { center.x - outerRadius, center.y - outerRadius, outerRadius * 2, outerRadius * 2 },
+        color, center, { innerRadius, outerRadius });
+}
+
+void DrawList::Sort() {
+    // layer:8 | blend:1 | primitive:3 | unused | index:32. The helicopter's
+    // parts are stacked on purpose, so its layer sorts by index alone.
+    keys.resize(commands.size());
+    for (size_t i = 0; i < commands.size(); i++) {
+        const Command& c = commands[i];
+        uint64_t key = (uint64_t)c.layer << 56;
+        if (c.layer != DrawLayer::Helicopter) {
+            key |= (uint64_t)(c.color.a < 255) << 55;
+            key |= (uint64_t)c.primitive << 52;
+        }
+        keys[i] = key | i;
+    }
+    std::sort(keys.begin(), keys.end());
+}
+
+void DrawList::ReplayThrough(DrawLayer last) {
+    const bool software = Gfx::IsSoftware();
+    // Whatever was drawn in between may have left another texture bound
+    if (!software) rlSetTexture(rlGetTextureIdDefault());
+    lastMode = -1;
+
+    for (; replayed < keys.size(); replayed++) {
+        const Command& c = commands[(uint32_t)keys[replayed]];
+        if (c.layer > last) break;
+
+        Stats& s = stats[(int)LayerSubsystem[(int)c.layer]];
+        const int mode = Modes[(int)c.primitive];
+        const int vertices = VertexCounts[(int)c.primitive];
+        if (batchVertices + vertices > RenderConst::BatchVertices ||
+            (mode != lastMode && batchDraws >= RenderConst::BatchDrawCalls)) {
+            s.flushes++;
+            batchVertices = 0;
+            batchDraws = 0;
+            lastMode = -1;
+        }
+        if (mode != lastMode) {
+            s.drawCalls++;
+            batchDraws++;
+            lastMode = mode;
+        }
+        batchVertices += vertices;
+        s.vertices += vertices;
+
+        Replay(c);
+    }
+
+    if (!software) rlSetTexture(0);
+}
+
+void DrawList::Replay(const Command& c) {
+    const Vector2* v = c.v;
+
+    if (SoftRenderer* soft = Gfx::GetSoftware()) {
+        switch (c.primitive) {
+            case Primitive::Rect:     soft->FillRect(v[0].x, v[0].y, v[1].x, v[1].y, c.color); break;
+            case Primitive::Quad:     soft->FillQuad(v[0], v[1], v[2], v[3], c.color); break;
+            case Primitive::Ring:     soft->FillRing(v[0], v[1].x, v[1].y, 0, 360, c.color); break;
+            case Primitive::Triangle: soft->FillTriangle(v[0], v[1], v[2], c.color); break;
+            case Primitive::Circle:   soft->FillCircle(v[0], v[1].x, c.color); break;
+            case Primitive::Ellipse:  soft->FillEllipse(v[0], v[1].x, v[1].y, c.color); break;
+        }
+        return;
+    }
+
+    // rlBegin() only starts a new draw call when the mode changes
+    rlCheckRenderBatchLimit(VertexCounts[(int)c.primitive]);
+    rlBegin(Modes[(int)c.primitive]);
+    rlColor4ub(c.color.r, c.color.g, c.color.b, c.color.a);
+    switch (c.primitive) {
+        case Primitive::Rect:
+            Vertex(v[0]);
+            Vertex({ v[0].x, v[0].y + v[1].y });
+            Vertex({ v[0].x + v[1].x, v[0].y + v[1].y });
+            Vertex({ v[0].x + v[1].x, v[0].y });
+            break;
+        case Primitive::Quad:
+            for (int i = 0; i < 4; i++) Vertex(v[i]);
+            break;
+        case Primitive::Ring:
+            for (int i = 0; i < Segments; i++) {
+                Vertex({ v[0].x + Unit.cs[i] * v[1].y, v[0].y + Unit.sn[i] * v[1].y });
+                Vertex({ v[0].x + Unit.cs[i] * v[1].x, v[0].y + Unit.sn[i] * v[1].x });
+                Vertex({ v[0].x + Unit.cs[i + 1] * v[1].x, v[0].y + Unit.sn[i + 1] * v[1].x });
+                Vertex({ v[0].x + Unit.cs[i + 1] * v[1].y, v[0].y + Unit.sn[i + 1] * v[1].y });
+            }
+            break;
+        case Primitive::Triangle:
+            for (int i = 0; i < 3; i++) Vertex(v[i]);
+            break;
+        case Primitive::Circle:
+        case Primitive::Ellipse: {
+            // A circle is an ellipse with equal radii
+            float rh = v[1].x;
+            float rv = c.primitive == Primitive::Circle ? v[1].x : v[1].y;
+            for (int i = 0; i < Segments; i++) {
+                Vertex(v[0]);
+                Vertex({ v[0].x + Unit.cs[i + 1] * rh, v[0].y + Unit.sn[i + 1] * rv });
+                Vertex({ v[0].x + Unit.cs[i] * rh, v[0].y + Unit.sn[i] * rv });
+            }
+            break;
+        }
+    }
+    rlEnd();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Back to front. Each layer belongs to one subsystem for the statistics.
+enum class DrawLayer : uint8_t {
+    BackgroundFar,
+    BackgroundNear,
+    StartPad,
+    Terrain,
+    Entities,
+    Helicopter,     // Kept in emission order: its parts overlap
+    Count
+};
+
+// Per-frame buffer of world geometry. Subsystems emit compact commands in
+// world space; anything outside the viewport is dropped on the spot. Sort()
+// then orders the rest by layer, blend state (opaque before translucent) and
+// primitive, so the replay switches rlgl's draw mode as rarely as possible,
+// and ReplayThrough() draws them through rlgl or the bound SoftRenderer.
+// Within a layer only commands of the same primitive and blend keep their
+// relative order, which the emitters rely on being harmless.
+class DrawList {
+public:
+    enum class Subsystem : uint8_t { Background, Level, Entities, Helicopter, Count };
+
+    // Counts for the last frame, one set per subsystem. Draw calls and
+    // flushes are what rlgl's default batch makes of the replay.
+    struct Stats {
+        int commands = 0;   // Emitted, including culled
+        int culled = 0;
+        int drawCalls = 0;
+        int vertices = 0;
+        int flushes = 0;
+    };
+
+    // Starts a frame; commands outside `viewport` are culled
+    void Begin(Rectangle viewport);
+    // Layer of the commands emitted from here on
+    void SetLayer(DrawLayer value) { layer = value; }
+
+    void Rect(Rectangle rec, Color color);
+    // Any convex quad, in the vertex order FillRect() uses: top left, bottom
+    // left, bottom right, top right before rotation
+    void Quad(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4, Color color);
+    // Counter-clockwise on screen, as DrawTriangle() expects
+    void Triangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+    void Circle(Vector2 center, float radius, Color color);
+    void Ellipse(Vector2 center, float radiusH, float radiusV, Color color);
+    void Ring(Vector2 center, float innerRadius, float outerRadius, Color color);
+
+    void Sort();
+    // Draws the sorted commands up to and including `last`; the next call
+    // carries on after it, so other drawing can go between layers
+    void ReplayThrough(DrawLayer last);
+
+    const Stats& GetStats(Subsystem subsystem) const { return stats[(int)subsystem]; }
+    static const char* GetSubsystemName(Subsystem subsystem);
+
+private:
+    // Grouped by the rlgl mode they replay in: quads first, then triangles
+    enum class Primitive : uint8_t { Rect, Quad, Ring, Triangle, Circle, Ellipse };
+
+    struct Command {
+        Vector2 v[4];   // Rect: position, size. Circle: center, (radius, -).
+                        // Ellipse: center, radii. Ring: center, (inner, outer).
+        Color color;
+        Primitive primitive;
+        DrawLayer layer;
+    };
+
+    void Add(Primitive primitive, Rectangle bounds, Color color, Vector2 a, Vector2 b, Vector2 c = {}, Vector2 d = {});
+    void Replay(const Command& command);
+
+    Rectangle viewport = {};
+    DrawLayer layer = DrawLayer::BackgroundFar;
+    std::vector<Command> commands;
+    std::vector<uint64_t> keys;     // Sort key, command index in the low bits
+    size_t replayed = 0;            // Keys drawn so far this frame
+
+    // rlgl batch as the replay has filled it
+    int lastMode = -1;
+    int batchVertices = 0;
+    int batchDraws = 0;
+
+    Stats stats[(int)Subsystem::Count];
+};
@@ -0,0 +1,113 @@
+#include "Gfx.h"
+#include "SoftRenderer.h"
+#include "rlgl.h"
+#include <algorithm>
+
+namespace {
+    SoftRenderer* software = nullptr;
+    Font fallbackFont = {};
+}
+
+void Gfx::BindSoftware(SoftRenderer* renderer) {
+    software = renderer;
+}
+
+SoftRenderer* Gfx::GetSoftware() {
+    return software;
+}
+
+bool Gfx::IsSoftware() {
+    return software != nullptr;
+}
+
+void Gfx::SetFallbackFont(const Font& font) {
+    fallbackFont = font;
+}
+
+Font Gfx::DefaultFont() {
+    return software ? fallbackFont : GetFontDefault();
+}
+
+void Gfx::PushMatrix() {
+    if (software) software->PushMatrix();
+    else rlPushMatrix();
+}
+
+void Gfx::PopMatrix() {
+    if (software) software->PopMatrix();
+    else rlPopMatrix();
+}
+
+void Gfx::Translate(float x, float y) {
+    if (software) software->Translate(x, y);
+    else rlTranslatef(x, y, 0);
+}
+
+void Gfx::Rotate(float degrees) {
+    if (software) software->Rotate(degrees);
+    else rlRotatef(degrees, 0, 0, 1);
+}
+
+void Gfx::DrawRectangle(int posX, int posY, int width, int height, Color color) {
+    if (software) software->FillRect((float)posX, (float)posY, (float)width, (float)height, color);
+    else ::DrawRectangle(posX, posY, width, height, color);
+}
+
+void Gfx::DrawRectangleRec(Rectangle rec, Color color) {
+    if (software) software->FillRect(rec.x, rec.y, rec.width, rec.height, color);
+    else ::DrawRectangleRec(rec, color);
+}
+
+void Gfx::DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    if (software) software->FillTriangle(v1, v2, v3, color);
+    else ::DrawTriangle(v1, v2, v3, color);
+}
+
+void Gfx::DrawCircle(int centerX, int centerY, float radius, Color color) {
+    if (software) software->FillCircle(Vector2{(float)centerX, (float)centerY}, radius, color);
+    else ::DrawCircle(centerX, centerY, radius, color);
+}
+
+void Gfx::DrawCircleV(Vector2 center, float radius, Color color) {
+    if (software) software->FillCircle(center, radius, color);
+    else ::DrawCircleV(center, radius, color);
+}
+
+void Gfx::DrawEllipse(int centerX, int centerY, float radiusH, float radiusV, Color color) {
+    if (software) software->FillEllipse(Vector2{(float)centerX, (float)centerY}, radiusH, radiusV, color);
+    else ::DrawEllipse(centerX, centerY, radiusH, radiusV, color);
+}
+
+void Gfx::DrawQuads(const float* x, const float* y, const float* size, const Color* colors, int count) {
+    if (software) {
+        for (int i = 0; i < count; i++) {
+            float half = size[i] * 0.5f;
+            software->FillRect(x[i] - half, y[i] - half, size[i], size[i], colors[i]);
+        }
+        return;
+    }
+
+    // Chunks that fit raylib's default vertex batch, so each one is a single draw
+    constexpr int QuadsPerChunk = 2048;
+    for (int start = 0; start < count; start += QuadsPerChunk) {
+        int end = std::min(start + QuadsPerChunk, count);
+        rlCheckRenderBatchLimit(4 * (end - start));
+        rlBegin(RL_QUADS);
+        for (int i = start; i < end; i++) {
+            float half = size[i] * 0.5f;
+            float x0 = x[i] - half, y0 = y[i] - half;
+            float x1 = x[i] + half, y1 = y[i] + half;
+            rlColor4ub(colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+            rlVertex2f(x0, y0);
+            rlVertex2f(x0, y1);
+            rlVertex2f(x1, y1);
+            rlVertex2f(x1, y0);
+        }
+        rlEnd();
+    }
+}
+
+void Gfx::DrawRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, int segments, Color color) {
+    if (software) software->FillRing(center, innerRadius, outerRadius, startAngle, endAngle, color);
+    else ::DrawRing(center, innerRadius, outerRadius, startAngle, endAngle, segments, color);
+}
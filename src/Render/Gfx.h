@@ -0,0 +1,33 @@
+#pragma once
+#include "raylib.h"
+
+class SoftRenderer;
+
+// Drawing entry points for the game world. They forward to raylib unless a
+// SoftRenderer is bound, in which case everything is rasterized on the CPU
+// and no GL context is needed.
+namespace Gfx {
+    void BindSoftware(SoftRenderer* renderer);
+    SoftRenderer* GetSoftware();
+    bool IsSoftware();
+
+    // Font used in place of raylib's default font (which needs GL) in software mode
+    void SetFallbackFont(const Font& font);
+    Font DefaultFont();
+
+    void PushMatrix();
+    void PopMatrix();
+    void Translate(float x, float y);
+    void Rotate(float degrees);
+
+    void DrawRectangle(int posX, int posY, int width, int height, Color color);
+    void DrawRectangleRec(Rectangle rec, Color color);
+    void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+    void DrawCircle(int centerX, int centerY, float radius, Color color);
+    void DrawCircleV(Vector2 center, float radius, Color color);
+    void DrawEllipse(int centerX, int centerY, float radiusH, float radiusV, Color color);
+    // Axis-aligned squares of edge size[i] centered on (x[i], y[i]), as one
+    // batch of quads instead of a draw call each
+    void DrawQuads(const float* x, const float* y, const float* size, const Color* colors, int count);
+    void DrawRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, int segments, Color color);
+}
@@ -0,0 +1,221 @@
+#include "ParticleSystem.h"
+#include "Constants.h"
+#include "Gfx.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+using ParticleConst = Constants::Particles;
+
+namespace {
+    static_assert(ParticleConst::Capacity % 4 == 0, "The update runs four particles per step");
+
+    constexpr float RandomScale = 1.0f / 2147483648.0f; // int32 to [-1, 1)
+
+    // One particle flavor of a burst
+    struct Recipe {
+        int count;
+        float speedMin, speedMax;   // px/s, in a random direction
+        float lift;                 // Extra upward speed, px/s
+        float lifeMin, lifeMax;     // Seconds
+        float sizeMin, sizeMax;     // px
+        float growth;               // px/s
+        float drag;                 // Velocity factor per update
+        float gravity;              // px/s^2
+        float turbulence;           // px/s per update
+        Color colors[3];
+    };
+
+    // Debris then smoke, per ParticleBurst::Kind
+    constexpr Recipe Recipes[] = {
+        // MissileKill: hot fragments and dark smoke
+        { 160,  80.0f, 320.0f,  60.0f,  0.4f, 1.0f,  1.5f, 3.5f,   0.0f, 0.97f, 420.0f,  0.0f,
+          { {255, 190,  60, 255}, {255, 120,  30, 255}, {170, 170, 180, 255} } },
+        {  90,  10.0f,  70.0f,  20.0f,  0.8f, 1.6f,  4.0f, 8.0f,  12.0f, 0.93f, -40.0f, 10.0f,
+          { { 70,  65,  60, 200}, { 95,  90,  85, 180}, { 50,  48,  46, 200} } },
+        // WallBreak: chunks of rock and a cloud of dust
+        { 240,  60.0f, 260.0f,  90.0f,  0.6f, 1.4f,  2.0f, 5.0f,   0.0f, 0.98f, 520.0f,  0.0f,
+          { {120, 110, 100, 255}, { 90,  80,  70, 255}, {150, 140, 125, 255} } },
+        { 120,  15.0f,  90.0f,  10.0f,  1.0f, 1.8f,  5.0f, 9.0f,  14.0f, 0.92f, -20.0f,  8.0f,
+          { {130, 120, 105, 150}, {105,  98,  88, 150}, {150, 142, 130, 130} } },
+        // RockHit: splinters of the rock
+        { 200,  70.0f, 280.0f,  70.0f,  0.5f, 1.2f,  1.5f, 4.0f,   0.0f, 0.97f, 480.0f,  0.0f,
+          { {139,  90,  43, 255}, {110,  70,  35, 255}, {160, 120,  70, 255} } },
+        {  60,  10.0f,  60.0f,  15.0f,  0.7f, 1.4f,  4.0f, 7.0f,  10.0f, 0.93f, -30.0f,  8.0f,
+          { {120,  95,  70, 160}, { 90,  75,  60, 160}, {140, 115,  90, 140} } },
+        // Impact: a few sparks and a puff
+        {  24,  60.0f, 220.0f,  40.0f,  0.2f, 0.5f,  1.0f, 2.5f,   0.0f, 0.95f, 300.0f,  0.0f,
+          { {255, 230, 120, 255}, {255, 170,  60, 255}, {255, 255, 200, 255} } },
+        {  12,  10.0f,  40.0f,  10.0f,  0.4f, 0.8f,  3.0f, 5.0f,   8.0f, 0.93f, -30.0f,  6.0f,
+          { { 90,  85,  80, 160}, { 70,  68,  65, 160}, {110, 105, 100, 140} } },
+    };
+
+    float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+    // Scalar step of one lane, matching the SSE2 version bit for bit
+    inline float NextLane(uint32_t& s) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return (float)(int32_t)s * RandomScale;
+    }
+
+#ifdef PARTICLES_SSE2
+    inline __m128 NextLanes(__m128i& s) {
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+        s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+        s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+        return _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_set1_ps(RandomScale));
+    }
+#endif
+
+    // Four values in [-1, 1), one per lane
+    void Next4(uint32_t (&state)[4], float (&out)[4]) {
+#ifdef PARTICLES_SSE2
+        __m128i s = _mm_loadu_si128((const __m128i*)state);
+        _mm_storeu_ps(out, NextLanes(s));
+        _mm_storeu_si128((__m128i*)state, s);
+#else
+        for (int lane = 0; lane < 4; lane++) out[lane] = NextLane(state[lane]);
+#endif
+    }
+}
+
+ParticleSystem::ParticleSystem()
+    : x(ParticleConst::Capacity), y(ParticleConst::Capacity),
+      vx(ParticleConst::Capacity), vy(ParticleConst::Capacity),
+      life(ParticleConst::Capacity), fade(ParticleConst::Capacity),
+      size(ParticleConst::Capacity), growth(ParticleConst::Capacity),
+      drag(ParticleConst::Capacity), gravity(ParticleConst::Capacity),
+      turbulence(ParticleConst::Capacity), color(ParticleConst::Capacity),
+      drawColors(ParticleConst::Capacity),
+      // Fixed seed: effects look the same on every run, so headless frames stay comparable
+      rng{0x9E3779B9u, 0x7F4A7C15u, 0x94D049BBu, 0x2545F491u} {}
+
+const char* ParticleSystem::GetKernelName() {
+#ifdef PARTICLES_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void ParticleSystem::Emit(const ParticleBurst& burst) {
+    int recipe = (int)burst.kind * 2;
+    Spawn(burst.position, recipe);      // Debris
+    Spawn(burst.position, recipe + 1);  // Smoke
+}
+
+void ParticleSystem::Spawn(Vector2 position, int recipe) {
+    const Recipe& r = Recipes[recipe];
+    float a[4], b[4];
+    for (int n = 0; n < r.count && count < ParticleConst::Capacity; n++) {
+        Next4(rng, a);
+        Next4(rng, b);
+
+        float angle = PI * a[0];
+        float speed = Lerp(r.speedMin, r.speedMax, a[1] * 0.5f + 0.5f);
+        float t = Lerp(r.lifeMin, r.lifeMax, a[2] * 0.5f + 0.5f);
+
+        int i = count++;
+        x[i] = position.x + b[0] * 4.0f;
+        y[i] = position.y + b[1] * 4.0f;
+        vx[i] = cosf(angle) * speed;
+        vy[i] = sinf(angle) * speed - r.lift;
+        life[i] = t;
+        fade[i] = 1.0f / t;
+        size[i] = Lerp(r.sizeMin, r.sizeMax, a[3] * 0.5f + 0.5f);
+        growth[i] = r.growth;
+        drag[i] = r.drag;
+        gravity[i] = r.gravity;
+        turbulence[i] = r.turbulence;
+        color[i] = r.colors[std::min((int)((b[2] * 0.5f + 0.5f) * 3.0f), 2)];
+    }
+}
+
+void ParticleSystem::Update(float dt, float scroll) {
+    // Rounded up to whole steps; the slots past `count` are dead and stay inside the arrays
+    const int end = (count + 3) & ~3;
+
+#ifdef PARTICLES_SSE2
+    __m128i s = _mm_loadu_si128((const __m128i*)rng);
+    const __m128 step = _mm_set1_ps(dt);
+    const __m128 shift = _mm_set1_ps(scroll);
+    for (int i = 0; i < end; i += 4) {
+        __m128 kickX = _mm_mul_ps(NextLanes(s), _mm_loadu_ps(&turbulence[i]));
+        __m128 kickY = _mm_mul_ps(NextLanes(s), _mm_loadu_ps(&turbulence[i]));
+        __m128 d = _mm_loadu_ps(&drag[i]);
+
+        __m128 velX = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&vx[i]), kickX), d);
+        __m128 velY = _mm_add_ps(_mm_loadu_ps(&vy[i]), _mm_mul_ps(_mm_loadu_ps(&gravity[i]), step));
+        velY = _mm_mul_ps(_mm_add_ps(velY, kickY), d);
+        _mm_storeu_ps(&vx[i], velX);
+        _mm_storeu_ps(&vy[i], velY);
+
+        __m128 posX = _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(velX, step));
+        _mm_storeu_ps(&x[i], _mm_sub_ps(posX, shift));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(velY, step)));
+        _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), step));
+        _mm_storeu_ps(&size[i], _mm_add_ps(_mm_loadu_ps(&size[i]), _mm_mul_ps(_mm_loadu_ps(&growth[i]), step)));
+    }
+    _mm_storeu_si128((__m128i*)rng, s);
+#else
+    for (int i = 0; i < end; i += 4) {
+        float kickX[4], kickY[4];
+        for (int lane = 0; lane < 4; lane++) kickX[lane] = NextLane(rng[lane]);
+        for (int lane = 0; lane < 4; lane++) kickY[lane] = NextLane(rng[lane]);
+        for (int lane = 0; lane < 4; lane++) {
+            int p = i + lane;
+            vx[p] = (vx[p] + kickX[lane] * turbulence[p]) * drag[p];
+            vy[p] = (vy[p] + gravity[p] * dt + kickY[lane] * turbulence[p]) * drag[p];
+            x[p] = (x[p] + vx[p] * dt) - scroll;
+            y[p] = y[p] + vy[p] * dt;
+            life[p] -= dt;
+            size[p] += growth[p] * dt;
+        }
+    }
+#endif
+
+    RemoveDead();
+}
+
+void ParticleSystem::RemoveDead() {
+    constexpr float Margin = 32.0f;
+    constexpr float Right = Constants::ScreenWidth + Margin;
+    constexpr float Bottom = Constants::ScreenHeight + Margin;
+
+    for (int i = 0; i < count; ) {
+        if (life[i] > 0.0f && x[i] > -Margin && x[i] < Right && y[i] < Bottom) {
+            i++;
+            continue;
+        }
+        int last = --count;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        life[i] = life[last];
+        fade[i] = fade[last];
+        size[i] = size[last];
+        growth[i] = growth[last];
+        drag[i] = drag[last];
+        gravity[i] = gravity[last];
+        turbulence[i] = turbulence[last];
+        color[i] = color[last];
+    }
+}
+
+void ParticleSystem::Draw() {
+    if (count == 0) return;
+
+    for (int i = 0; i < count; i++) {
+        Color c = color[i];
+        c.a = (unsigned char)(c.a * std::min(life[i] * fade[i], 1.0f));
+        drawColors[i] = c;
+    }
+    Gfx::DrawQuads(x.data(), y.data(), size.data(), drawColors.data(), count);
+}
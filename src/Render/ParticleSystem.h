@@ -0,0 +1,55 @@
+#pragma once
+#include "raylib.h"
+#include "ParticleBurst.h"
+#include <cstdint>
+#include <vector>
+
+// Debris and smoke for explosions. Particles are purely visual: they live on
+// the render side, are fed the bursts of each new tick and never feed back
+// into the simulation.
+//
+// The pool is a fixed-capacity structure of arrays so the update runs as one
+// SIMD pass over contiguous floats, four particles per step, with its own
+// four-lane xorshift generator for the turbulence. Dead particles are swapped
+// with the last live one, keeping [0, count) dense. When the pool is full new
+// particles are dropped rather than old ones recycled.
+class ParticleSystem {
+public:
+    ParticleSystem();
+
+    // Spawns the debris and smoke of one burst
+    void Emit(const ParticleBurst& burst);
+    // Advances every particle by `dt`; `scroll` is how far the terrain moved
+    // left since the last call, so debris stays attached to the world
+    void Update(float dt, float scroll);
+    // All particles as one batch of quads
+    void Draw();
+    void Clear() { count = 0; }
+
+    int GetCount() const { return count; }
+    static const char* GetKernelName();
+
+private:
+    int count = 0;
+
+    // Structure of arrays, Capacity entries each
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> life;      // Seconds left
+    std::vector<float> fade;      // 1 / initial life
+    std::vector<float> size;      // Quad edge in px
+    std::vector<float> growth;    // Edge change in px per second
+    std::vector<float> drag;      // Velocity factor per update
+    std::vector<float> gravity;   // px/s^2, negative rises
+    std::vector<float> turbulence;// Random velocity kick per update, px/s
+    std::vector<Color> color;
+
+    std::vector<Color> drawColors; // Faded colors for the batch
+
+    // Four independent xorshift32 lanes; the scalar fallback steps them the
+    // same way so both builds produce the same particles
+    uint32_t rng[4];
+
+    void Spawn(Vector2 position, int recipe);
+    void RemoveDead();
+};
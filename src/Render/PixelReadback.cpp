@@ -0,0 +1,101 @@
+#include "PixelReadback.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// glad comes with raylib and is loaded by it; only GL 3.3 has what this needs
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+#include "external/glad.h"
+#define READBACK_PBO 1
+#endif
+
+void PixelReadback::Unload() {
+    if (mapped) Release();
+    for (Buffer& buffer : buffers) {
+#ifdef READBACK_PBO
+        if (buffer.fence) glDeleteSync((GLsync)buffer.fence);
+        if (buffer.id != 0) glDeleteBuffers(1, &buffer.id);
+#else
+        if (buffer.fence) MemFree(buffer.fence);
+#endif
+        buffer = Buffer();
+    }
+    oldest = 0;
+    pending = 0;
+}
+
+bool PixelReadback::Request(const RenderTexture2D& target) {
+    if (mapped || pending == BufferCount) return false;
+    int width = target.texture.width, height = target.texture.height;
+    Buffer& buffer = buffers[(oldest + pending) % BufferCount];
+    size_t size = (size_t)width * height * sizeof(uint32_t);
+
+#ifdef READBACK_PBO
+    if (buffer.id == 0) glGenBuffers(1, &buffer.id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+    if (buffer.width != width || buffer.height != height) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_READ);
+    }
+    // With a pack buffer bound the read only queues a copy on the GPU
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.id);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+    // The fence slot holds the pixels themselves
+    (void)size;
+    buffer.fence = rlReadTexturePixels(target.texture.id, width, height, target.texture.format);
+#endif
+
+    buffer.width = width;
+    buffer.height = height;
+    pending++;
+    return true;
+}
+
+const uint32_t* PixelReadback::MapOldest(bool wait, int* width, int* height) {
+    if (mapped || pending == 0) return nullptr;
+    Buffer& buffer = buffers[oldest];
+    *width = buffer.width;
+    *height = buffer.height;
+
+#ifdef READBACK_PBO
+    // A zero timeout only asks; the flush makes sure the fence gets there
+    GLenum status = glClientWaitSync((GLsync)buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return nullptr;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)buffer.width * buffer.height * 4, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!pixels) {
+        // Lost; free the buffer for the next request
+        glDeleteSync((GLsync)buffer.fence);
+        buffer.fence = nullptr;
+        oldest = (oldest + 1) % BufferCount;
+        pending--;
+        return nullptr;
+    }
+#else
+    (void)wait;
+    const void* pixels = buffer.fence;
+#endif
+
+    mapped = true;
+    return (const uint32_t*)pixels;
+}
+
+void PixelReadback::Release() {
+    if (!mapped) return;
+    Buffer& buffer = buffers[oldest];
+#ifdef READBACK_PBO
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glDeleteSync((GLsync)buffer.fence);
+#else
+    MemFree(buffer.fence);
+#endif
+    buffer.fence = nullptr;
+    mapped = false;
+    oldest = (oldest + 1) % BufferCount;
+    pending--;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Reads a render target back without waiting for the GPU. Each request
+// copies the framebuffer into one of a few pixel pack buffers and fences
+// it; a buffer is only mapped once its fence has passed, normally two
+// frames later, so neither the read nor the map stalls the pipeline.
+//
+// Needs GL 3.3 (fences, buffer mapping). Other graphics APIs fall back to
+// a synchronous read that is ready straight away.
+class PixelReadback {
+public:
+    static constexpr int BufferCount = 3;
+
+    // GL objects are released by Unload(), while the context still exists
+    ~PixelReadback() = default;
+    void Unload();
+
+    // Queues a copy of the target's color. Returns false, and skips the
+    // frame, when every buffer is still waiting to be collected.
+    bool Request(const RenderTexture2D& target);
+
+    // Maps the oldest requested frame, bottom row first, if the GPU has
+    // finished it (or waits for it if `wait`). Returns nullptr if none is
+    // ready; otherwise Release() it before the next Request().
+    const uint32_t* MapOldest(bool wait, int* width, int* height);
+    void Release();
+
+    bool HasPending() const { return pending > 0; }
+
+private:
+    struct Buffer {
+        unsigned int id = 0;
+        void* fence = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    Buffer buffers[BufferCount];
+    int oldest = 0;     // Next buffer to be collected
+    int pending = 0;    // Requested and not released yet
+    bool mapped = false;
+};
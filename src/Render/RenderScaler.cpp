@@ -0,0 +1,63 @@
+#include "RenderScaler.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cmath>
+
+using RenderConst = Constants::Render;
+
+namespace {
+    float Quantize(float scale) {
+        scale = std::round(scale / RenderConst::ScaleStep) * RenderConst::ScaleStep;
+        return std::clamp(scale, RenderConst::MinScale, RenderConst::MaxScale);
+    }
+}
+
+void RenderScaler::Configure(float scale, bool automatic) {
+    this->scale = Quantize(scale);
+    this->automatic = automatic;
+    averageFrameTime = 0.0f;
+    framesSinceChange = 0;
+    probing = false;
+}
+
+bool RenderScaler::Update(float frameTime) {
+    if (!automatic) return false;
+
+    const float budget = 1.0f / Constants::TargetFPS;
+    averageFrameTime = (averageFrameTime == 0.0f) ? frameTime : averageFrameTime * 0.9f + frameTime * 0.1f;
+    framesSinceChange++;
+
+    // Give the new target a moment to settle before judging it
+    if (framesSinceChange < 30) return false;
+
+    if (averageFrameTime > budget * 1.1f && scale > RenderConst::MinScale) {
+        // A probe that immediately misses makes the next one wait twice as long
+        if (probing) probeDelay = std::min(probeDelay * 2, 60 * 60);
+        probing = false;
+        scale = Quantize(scale - 2 * RenderConst::ScaleStep);
+        framesSinceChange = 0;
+        return true;
+    }
+
+    if (averageFrameTime <= budget * 1.02f && framesSinceChange >= probeDelay && scale < RenderConst::MaxScale) {
+        probing = true;
+        scale = Quantize(scale + RenderConst::ScaleStep);
+        framesSinceChange = 0;
+        return true;
+    }
+
+    // A probe that held for a while was a success
+    if (probing && framesSinceChange >= 300) {
+        probing = false;
+        probeDelay = 180;
+    }
+    return false;
+}
+
+int RenderScaler::GetWidth() const {
+    return (int)(Constants::ScreenWidth * scale);
+}
+
+int RenderScaler::GetHeight() const {
+    return (int)(Constants::ScreenHeight * scale);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Picks the internal resolution of the scene render target. In automatic
+// mode it lowers the scale while frames miss their deadline and
+// periodically probes a step back up, backing off longer after each
+// failed probe.
+class RenderScaler {
+public:
+    void Configure(float scale, bool automatic);
+
+    // Feeds the last frame time; returns true if the scale changed
+    bool Update(float frameTime);
+
+    float GetScale() const { return scale; }
+    int GetWidth() const;
+    int GetHeight() const;
+
+private:
+    float scale = 1.0f;
+    bool automatic = false;
+
+    float averageFrameTime = 0.0f;
+    int framesSinceChange = 0;
+    int probeDelay = 180;   // frames of headroom before trying a larger scale
+    bool probing = false;
+};
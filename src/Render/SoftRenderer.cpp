@@ -0,0 +1,306 @@
+#include "SoftRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFT_RENDERER_SSE2 1
+#endif
+
+namespace {
+    uint32_t Pack(Color c) {
+        return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | ((uint32_t)c.a << 24);
+    }
+
+    // Exact round(x / 255) for x in [0, 255 * 255]
+    inline uint32_t Div255(uint32_t x) {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    inline uint32_t BlendPixel(uint32_t dst, Color c, uint32_t alpha) {
+        uint32_t inv = 255 - alpha;
+        uint32_t r = Div255(c.r * alpha + (dst & 0xff) * inv);
+        uint32_t g = Div255(c.g * alpha + ((dst >> 8) & 0xff) * inv);
+        uint32_t b = Div255(c.b * alpha + ((dst >> 16) & 0xff) * inv);
+        uint32_t a = Div255(alpha * alpha + (dst >> 24) * inv);
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+
+    // First pixel whose center lies at or right of x
+    inline int CeilCenter(float x) {
+        return (int)std::ceil(x - 0.5f);
+    }
+}
+
+SoftRenderer::SoftRenderer(int width, int height)
+    : width(width), height(height), pixels((size_t)width * height, 0), current{1, 0, 0, 1, 0, 0},
+      grade(width, height) {}
+
+void SoftRenderer::Clear(Color color) {
+    std::fill(pixels.begin(), pixels.end(), Pack(color));
+}
+
+void SoftRenderer::PushMatrix() {
+    stack.push_back(current);
+}
+
+void SoftRenderer::PopMatrix() {
+    if (stack.empty()) return;
+    current = stack.back();
+    stack.pop_back();
+}
+
+void SoftRenderer::Translate(float x, float y) {
+    current.tx += current.a * x + current.c * y;
+    current.ty += current.b * x + current.d * y;
+}
+
+void SoftRenderer::Rotate(float degrees) {
+    float rad = degrees * DEG2RAD;
+    float cs = cosf(rad);
+    float sn = sinf(rad);
+    Transform t = current;
+    current.a = t.a * cs + t.c * sn;
+    current.b = t.b * cs + t.d * sn;
+    current.c = t.c * cs - t.a * sn;
+    current.d = t.d * cs - t.b * sn;
+}
+
+Vector2 SoftRenderer::Apply(Vector2 p) const {
+    return { current.a * p.x + current.c * p.y + current.tx, current.b * p.x + current.d * p.y + current.ty };
+}
+
+bool SoftRenderer::IsAxisAligned() const {
+    return current.a == 1.0f && current.b == 0.0f && current.c == 0.0f && current.d == 1.0f;
+}
+
+void SoftRenderer::FillSpan(int y, int x0, int x1, Color color) {
+    if (y < 0 || y >= height || color.a == 0) return;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, width);
+    if (x0 >= x1) return;
+
+    uint32_t* row = pixels.data() + (size_t)y * width;
+    int x = x0;
+
+    if (color.a == 255) {
+        uint32_t packed = Pack(color);
+#ifdef SOFT_RENDERER_SSE2
+        __m128i fill = _mm_set1_epi32((int)packed);
+        for (; x + 4 <= x1; x += 4) {
+            _mm_storeu_si128((__m128i*)(row + x), fill);
+        }
+#endif
+        for (; x < x1; x++) row[x] = packed;
+        return;
+    }
+
+#ifdef SOFT_RENDERER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i inv = _mm_set1_epi16((short)(255 - color.a));
+    const __m128i src = _mm_set_epi16(
+        (short)(color.a * color.a), (short)(color.b * color.a), (short)(color.g * color.a), (short)(color.r * color.a),
+        (short)(color.a * color.a), (short)(color.b * color.a), (short)(color.g * color.a), (short)(color.r * color.a));
+    for (; x + 4 <= x1; x += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)(row + x));
+        __m128i lo = _mm_unpacklo_epi8(px, zero);
+        __m128i hi = _mm_unpackhi_epi8(px, zero);
+        lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, inv), src), bias);
+        hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, inv), src), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(row + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < x1; x++) row[x] = BlendPixel(row[x], color, color.a);
+}
+
+void SoftRenderer::FillPolygonRows(const Vector2* v, int count, Color color) {
+    float minY = v[0].y, maxY = v[0].y;
+    for (int i = 1; i < count; i++) {
+        minY = std::min(minY, v[i].y);
+        maxY = std::max(maxY, v[i].y);
+    }
+
+    int y0 = std::max(CeilCenter(minY), 0);
+    int y1 = std::min(CeilCenter(maxY), height);
+    for (int y = y0; y < y1; y++) {
+        float yc = y + 0.5f;
+        float left = 1e30f, right = -1e30f;
+        for (int i = 0; i < count; i++) {
+            Vector2 p = v[i];
+            Vector2 q = v[(i + 1) % count];
+            if (p.y == q.y) continue;
+            if (yc < std::min(p.y, q.y) || yc >= std::max(p.y, q.y)) continue;
+            float x = p.x + (yc - p.y) * (q.x - p.x) / (q.y - p.y);
+            left = std::min(left, x);
+            right = std::max(right, x);
+        }
+        if (left < right) FillSpan(y, CeilCenter(left), CeilCenter(right), color);
+    }
+}
+
+void SoftRenderer::FillQuad(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4, Color color) {
+    Vector2 v[4] = { p1, p2, p3, p4 };
+    FillPolygonRows(v, 4, color);
+}
+
+void SoftRenderer::FillRect(float x, float y, float w, float h, Color color) {
+    if (w <= 0 || h <= 0) return;
+
+    if (IsAxisAligned()) {
+        x += current.tx;
+        y += current.ty;
+        int x0 = CeilCenter(x), x1 = CeilCenter(x + w);
+        int y0 = std::max(CeilCenter(y), 0), y1 = std::min(CeilCenter(y + h), height);
+        for (int row = y0; row < y1; row++) FillSpan(row, x0, x1, color);
+        return;
+    }
+
+    FillQuad(Apply({x, y}), Apply({x, y + h}), Apply({x + w, y + h}), Apply({x + w, y}), color);
+}
+
+void SoftRenderer::FillTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    Vector2 v[3] = { Apply(v1), Apply(v2), Apply(v3) };
+
+    // rlgl culls back faces; in y-down screen space the visible winding has a negative cross product
+    float cross = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+    if (cross >= 0.0f) return;
+
+    FillPolygonRows(v, 3, color);
+}
+
+void SoftRenderer::FillCircle(Vector2 center, float radius, Color color) {
+    FillEllipse(center, radius, radius, color);
+}
+
+void SoftRenderer::FillEllipse(Vector2 center, float radiusH, float radiusV, Color color) {
+    if (radiusH <= 0 || radiusV <= 0) return;
+    float scale = std::sqrt(std::fabs(current.a * current.d - current.b * current.c));
+    Vector2 c = Apply(center);
+    radiusH *= scale;
+    radiusV *= scale;
+
+    int y0 = std::max(CeilCenter(c.y - radiusV), 0);
+    int y1 = std::min(CeilCenter(c.y + radiusV), height);
+    for (int y = y0; y < y1; y++) {
+        float dy = (y + 0.5f - c.y) / radiusV;
+        float t = 1.0f - dy * dy;
+        if (t <= 0.0f) continue;
+        float half = radiusH * std::sqrt(t);
+        FillSpan(y, CeilCenter(c.x - half), CeilCenter(c.x + half), color);
+    }
+}
+
+void SoftRenderer::FillRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, Color color) {
+    if (outerRadius <= 0 || innerRadius >= outerRadius) return;
+    float scale = std::sqrt(std::fabs(current.a * current.d - current.b * current.c));
+    Vector2 c = Apply(center);
+    float outer = outerRadius * scale;
+    float inner = std::max(innerRadius, 0.0f) * scale;
+    bool fullCircle = std::fabs(endAngle - startAngle) >= 360.0f;
+
+    int y0 = std::max(CeilCenter(c.y - outer), 0);
+    int y1 = std::min(CeilCenter(c.y + outer), height);
+    for (int y = y0; y < y1; y++) {
+        float dy = y + 0.5f - c.y;
+        float to = outer * outer - dy * dy;
+        if (to <= 0.0f) continue;
+        float ho = std::sqrt(to);
+        float ti = inner * inner - dy * dy;
+        float hi = (ti > 0.0f) ? std::sqrt(ti) : 0.0f;
+
+        if (fullCircle) {
+            if (hi == 0.0f) {
+                FillSpan(y, CeilCenter(c.x - ho), CeilCenter(c.x + ho), color);
+            } else {
+                FillSpan(y, CeilCenter(c.x - ho), CeilCenter(c.x - hi), color);
+                FillSpan(y, CeilCenter(c.x + hi), CeilCenter(c.x + ho), color);
+            }
+            continue;
+        }
+
+        // Partial rings are rare; test the angle per pixel
+        for (int x = CeilCenter(c.x - ho); x < CeilCenter(c.x + ho); x++) {
+            float dx = x + 0.5f - c.x;
+            if (std::fabs(dx) < hi) continue;
+            float angle = atan2f(dy, dx) * RAD2DEG;
+            while (angle < startAngle) angle += 360.0f;
+            if (angle <= endAngle) FillSpan(y, x, x + 1, color);
+        }
+    }
+}
+
+void SoftRenderer::DrawCoverage(const Image& coverage, Rectangle dst, Color color) {
+    if (!coverage.data || coverage.width <= 0 || coverage.height <= 0 || dst.width <= 0 || dst.height <= 0) return;
+    dst.x += current.tx;
+    dst.y += current.ty;
+
+    const unsigned char* src = (const unsigned char*)coverage.data;
+    int x0 = std::max(CeilCenter(dst.x), 0), x1 = std::min(CeilCenter(dst.x + dst.width), width);
+    int y0 = std::max(CeilCenter(dst.y), 0), y1 = std::min(CeilCenter(dst.y + dst.height), height);
+
+    for (int y = y0; y < y1; y++) {
+        int sy = std::min((int)((y + 0.5f - dst.y) / dst.height * coverage.height), coverage.height - 1);
+        uint32_t* row = pixels.data() + (size_t)y * width;
+        for (int x = x0; x < x1; x++) {
+            int sx = std::min((int)((x + 0.5f - dst.x) / dst.width * coverage.width), coverage.width - 1);
+            uint32_t alpha = Div255(src[sy * coverage.width + sx] * color.a);
+            if (alpha) row[x] = BlendPixel(row[x], color, alpha);
+        }
+    }
+}
+
+void SoftRenderer::ApplyCavernGrade() {
+    grade.Apply(pixels.data());
+}
+
+bool SoftRenderer::SavePPM(const char* fileName) const {
+    FILE* file = fopen(fileName, "wb");
+    if (!file) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> rgb((size_t)width * 3);
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = pixels.data() + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            rgb[x * 3 + 0] = (unsigned char)(row[x] & 0xff);
+            rgb[x * 3 + 1] = (unsigned char)((row[x] >> 8) & 0xff);
+            rgb[x * 3 + 2] = (unsigned char)((row[x] >> 16) & 0xff);
+        }
+        fwrite(rgb.data(), 1, rgb.size(), file);
+    }
+    fclose(file);
+    return true;
+}
+
+long SoftRenderer::ComparePPM(const char* fileName) const {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) return -1;
+
+    int w = 0, h = 0, maxValue = 0;
+    if (fscanf(file, "P6 %d %d %d", &w, &h, &maxValue) != 3 || w != width || h != height || maxValue != 255) {
+        fclose(file);
+        return -1;
+    }
+    fgetc(file); // single whitespace after the header
+
+    long differing = 0;
+    std::vector<unsigned char> rgb((size_t)width * 3);
+    for (int y = 0; y < height; y++) {
+        if (fread(rgb.data(), 1, rgb.size(), file) != rgb.size()) {
+            fclose(file);
+            return -1;
+        }
+        const uint32_t* row = pixels.data() + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            uint32_t expected = rgb[x * 3] | (rgb[x * 3 + 1] << 8) | (rgb[x * 3 + 2] << 16);
+            if ((row[x] & 0xffffff) != expected) differing++;
+        }
+    }
+    fclose(file);
+    return differing;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "raylib.h"
+#include "CavernGrade.h"
+#include <cstdint>
+#include <vector>
+
+// CPU rasterizer for the handful of primitives the game draws. Pixels are
+// sampled at their centers, spans are filled four at a time with SSE2 and
+// blended like raylib's default BLEND_ALPHA. Used for headless rendering,
+// frame dumps and golden-image comparisons.
+class SoftRenderer {
+public:
+    SoftRenderer(int width, int height);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    // RGBA8, row-major, top row first
+    const uint32_t* GetPixels() const { return pixels.data(); }
+    uint32_t* GetPixels() { return pixels.data(); }
+
+    void Clear(Color color);
+
+    // Same conventions as rlPushMatrix()/rlTranslatef()/rlRotatef()
+    void PushMatrix();
+    void PopMatrix();
+    void Translate(float x, float y);
+    void Rotate(float degrees);
+
+    void FillRect(float x, float y, float w, float h, Color color);
+    // Counter-clockwise on screen, as DrawTriangle() expects; other windings are culled
+    void FillTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+    // Convex, either winding
+    void FillQuad(Vector2 p1, Vector2 p2, Vector2 p3, Vector2 p4, Color color);
+    void FillCircle(Vector2 center, float radius, Color color);
+    void FillEllipse(Vector2 center, float radiusH, float radiusV, Color color);
+    void FillRing(Vector2 center, float innerRadius, float outerRadius, float startAngle, float endAngle, Color color);
+    // Blends an 8-bit coverage image (font glyph) stretched over dst
+    void DrawCoverage(const Image& coverage, Rectangle dst, Color color);
+
+    // CPU version of assets/cavern.fs (vignette + cold color grade), see CavernGrade
+    void ApplyCavernGrade();
+
+    bool SavePPM(const char* fileName) const;
+    // Number of pixels differing from a PPM written by SavePPM(), or -1 if it can't be read
+    long ComparePPM(const char* fileName) const;
+
+private:
+    struct Transform {
+        float a, b, c, d, tx, ty; // x' = a*x + c*y + tx, y' = b*x + d*y + ty
+    };
+
+    Vector2 Apply(Vector2 p) const;
+    bool IsAxisAligned() const;
+    void FillSpan(int y, int x0, int x1, Color color);
+    void FillPolygonRows(const Vector2* v, int count, Color color);
+
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+    Transform current;
+    std::vector<Transform> stack;
+    CavernGrade grade;
+};
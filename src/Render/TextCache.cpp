@@ -0,0 +1,172 @@
+#include "TextCache.h"
+#include "Gfx.h"
+#include "SoftRenderer.h"
+#include "rlgl.h"
+#include <algorithm>
+
+void TextCache::Set(int slot, const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color color) {
+    if (slot >= (int)labels.size()) labels.resize(slot + 1);
+    Label& label = labels[slot];
+
+    if (label.texture != font.texture.id || label.font.glyphs != font.glyphs || label.fontSize != fontSize || label.spacing != spacing || label.text != text) {
+        label.text = text;
+        label.font = font;
+        label.texture = font.texture.id;
+        label.fontSize = fontSize;
+        label.spacing = spacing;
+        Layout(label, font);
+    }
+
+    label.position = position;
+    label.color = color;
+    label.visible = true;
+}
+
+void TextCache::SetDefault(int slot, const char* text, int posX, int posY, int fontSize, Color color) {
+    // Mirrors DrawText(): minimum size 10, spacing of one pixel per 10px of size
+    const int defaultFontSize = 10;
+    if (fontSize < defaultFontSize) fontSize = defaultFontSize;
+    Set(slot, Gfx::DefaultFont(), text, Vector2{(float)posX, (float)posY}, (float)fontSize, (float)(fontSize / defaultFontSize), color);
+}
+
+void TextCache::Move(int slot, Vector2 position) {
+    if (slot < (int)labels.size()) labels[slot].position = position;
+}
+
+void TextCache::Hide(int slot) {
+    if (slot < (int)labels.size()) labels[slot].visible = false;
+}
+
+void TextCache::Truncate(int count) {
+    for (int i = count; i < (int)labels.size(); i++) labels[i].visible = false;
+}
+
+void TextCache::Clear() {
+    labels.clear();
+}
+
+Vector2 TextCache::Measure(int slot) const {
+    if (slot >= (int)labels.size()) return {0, 0};
+    return labels[slot].size;
+}
+
+void TextCache::Layout(Label& label, const Font& font) {
+    label.quads.clear();
+    if (!font.glyphs || font.baseSize == 0) {
+        label.size = {0, 0};
+        return;
+    }
+
+    // Same pen advance and glyph placement as DrawTextEx()/DrawTextCodepoint()
+    float scale = label.fontSize / (float)font.baseSize;
+    float padding = (float)font.glyphPadding;
+    // No atlas in software mode; UVs are unused there
+    float texWidth = (font.texture.width > 0) ? (float)font.texture.width : 1.0f;
+    float texHeight = (font.texture.height > 0) ? (float)font.texture.height : 1.0f;
+    float penX = 0.0f;
+    float penY = 0.0f;
+    float lineWidth = 0.0f;
+    float maxWidth = 0.0f;
+    int lines = 1;
+
+    for (const char* c = label.text.c_str(); *c; c++) {
+        int codepoint = (unsigned char)*c;
+        if (codepoint == '\n') {
+            maxWidth = std::max(maxWidth, lineWidth);
+            penX = 0.0f;
+            penY += label.fontSize + 2.0f;
+            lineWidth = 0.0f;
+            lines++;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        const GlyphInfo& glyph = font.glyphs[index];
+        const Rectangle& rec = font.recs[index];
+
+        if (codepoint != ' ' && codepoint != '\t') {
+            Quad quad;
+            quad.dst = {
+                penX + (glyph.offsetX - padding) * scale,
+                penY + (glyph.offsetY - padding) * scale,
+                (rec.width + 2.0f * padding) * scale,
+                (rec.height + 2.0f * padding) * scale
+            };
+            quad.u0 = (rec.x - padding) / texWidth;
+            quad.v0 = (rec.y - padding) / texHeight;
+            quad.u1 = (rec.x + rec.width + padding) / texWidth;
+            quad.v1 = (rec.y + rec.height + padding) / texHeight;
+            quad.glyph = index;
+            label.quads.push_back(quad);
+        }
+
+        float advance = (glyph.advanceX == 0) ? rec.width * scale : glyph.advanceX * scale;
+        lineWidth = penX + advance;
+        penX += advance + label.spacing;
+    }
+
+    maxWidth = std::max(maxWidth, lineWidth);
+    label.size = { maxWidth, lines * label.fontSize + (lines - 1) * 2.0f };
+}
+
+void TextCache::Draw() const {
+    if (Gfx::IsSoftware()) {
+        DrawSoftware();
+        return;
+    }
+
+    // One pass per atlas: at most the game font and raylib's default font
+    unsigned int drawn[4] = { 0 };
+    int drawnCount = 0;
+
+    for (const auto& first : labels) {
+        if (!first.visible || first.quads.empty()) continue;
+        unsigned int texture = first.texture;
+        if (std::find(drawn, drawn + drawnCount, texture) != drawn + drawnCount) continue;
+        if (drawnCount < 4) drawn[drawnCount++] = texture;
+
+        int quadCount = 0;
+        for (const auto& label : labels) {
+            if (label.visible && label.texture == texture) quadCount += (int)label.quads.size();
+        }
+        rlCheckRenderBatchLimit(4 * quadCount);
+
+        rlSetTexture(texture);
+        rlBegin(RL_QUADS);
+        for (const auto& label : labels) {
+            if (!label.visible || label.texture != texture) continue;
+            rlColor4ub(label.color.r, label.color.g, label.color.b, label.color.a);
+            for (const auto& q : label.quads) {
+                float x0 = label.position.x + q.dst.x;
+                float y0 = label.position.y + q.dst.y;
+                float x1 = x0 + q.dst.width;
+                float y1 = y0 + q.dst.height;
+                rlTexCoord2f(q.u0, q.v0); rlVertex2f(x0, y0);
+                rlTexCoord2f(q.u0, q.v1); rlVertex2f(x0, y1);
+                rlTexCoord2f(q.u1, q.v1); rlVertex2f(x1, y1);
+                rlTexCoord2f(q.u1, q.v0); rlVertex2f(x1, y0);
+            }
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+}
+
+void TextCache::DrawSoftware() const {
+    SoftRenderer* renderer = Gfx::GetSoftware();
+    for (const auto& label : labels) {
+        if (!label.visible) continue;
+        float scale = label.fontSize / (float)label.font.baseSize;
+        float padding = label.font.glyphPadding * scale;
+        for (const auto& q : label.quads) {
+            // The glyph bitmap covers the quad minus its padding
+            Rectangle dst = {
+                label.position.x + q.dst.x + padding,
+                label.position.y + q.dst.y + padding,
+                q.dst.width - 2.0f * padding,
+                q.dst.height - 2.0f * padding
+            };
+            renderer->DrawCoverage(label.font.glyphs[q.glyph].image, dst, label.color);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "raylib.h"
+#include <string>
+#include <vector>
+
+// Holds laid-out glyph quads for a set of text labels. A label is only laid
+// out again when its string, font, size or spacing changes; moving or
+// recoloring it is free. Draw() emits every visible label in one batch per
+// font atlas, or blits the glyph bitmaps when a SoftRenderer is bound.
+class TextCache {
+public:
+    // Updates label `slot` (growing the cache as needed)
+    void Set(int slot, const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color color);
+    // Same as Set() but with DrawText()'s default-font size and spacing rules
+    void SetDefault(int slot, const char* text, int posX, int posY, int fontSize, Color color);
+    void Move(int slot, Vector2 position);
+    void Hide(int slot);
+    // Hides every slot from `count` on
+    void Truncate(int count);
+    void Clear();
+
+    // Size of the laid-out text, as MeasureTextEx() would report it
+    Vector2 Measure(int slot) const;
+    void Draw() const;
+
+private:
+    struct Quad {
+        Rectangle dst; // relative to the label position
+        float u0, v0, u1, v1;
+        int glyph;
+    };
+
+    struct Label {
+        std::string text;
+        Font font = {};
+        unsigned int texture = 0;
+        float fontSize = 0.0f;
+        float spacing = 0.0f;
+        Vector2 position = {0, 0};
+        Color color = WHITE;
+        Vector2 size = {0, 0};
+        std::vector<Quad> quads;
+        bool visible = false;
+    };
+
+    void Layout(Label& label, const Font& font);
+    void DrawSoftware() const;
+
+    std::vector<Label> labels;
+};
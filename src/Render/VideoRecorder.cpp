@@ -0,0 +1,226 @@
+#include "VideoRecorder.h"
+#include "Constants.h"
+#include "raylib.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VIDEO_SSE2 1
+#endif
+
+using CaptureConst = Constants::Capture;
+
+namespace {
+    // BT.601 limited range in 8.8 fixed point. Chroma comes from the rounded
+    // mean of each 2x2 block, which is where C420jpeg sites it.
+    inline uint8_t Luma(int r, int g, int b) {
+        return (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+    inline uint8_t ChromaU(int r, int g, int b) {
+        return (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+    }
+    inline uint8_t ChromaV(int r, int g, int b) {
+        return (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    void ConvertPairScalar(const uint32_t* row0, const uint32_t* row1, int begin, int end,
+                           uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+        for (int x = begin; x < end; x += 2) {
+            int r = 2, g = 2, b = 2; // Rounding for the mean
+            for (const uint32_t p : { row0[x], row0[x + 1], row1[x], row1[x + 1] }) {
+                r += p & 0xff;
+                g += (p >> 8) & 0xff;
+                b += (p >> 16) & 0xff;
+            }
+            for (int i = 0; i < 2; i++) {
+                uint32_t p0 = row0[x + i], p1 = row1[x + i];
+                y0[x + i] = Luma(p0 & 0xff, (p0 >> 8) & 0xff, (p0 >> 16) & 0xff);
+                y1[x + i] = Luma(p1 & 0xff, (p1 >> 8) & 0xff, (p1 >> 16) & 0xff);
+            }
+            u[x / 2] = ChromaU(r >> 2, g >> 2, b >> 2);
+            v[x / 2] = ChromaV(r >> 2, g >> 2, b >> 2);
+        }
+    }
+
+#ifdef VIDEO_SSE2
+    struct Channels {
+        __m128i r, g, b; // Eight 16-bit lanes each
+    };
+
+    Channels Split(const uint32_t* pixels) {
+        const __m128i mask = _mm_set1_epi32(0xff);
+        __m128i lo = _mm_loadu_si128((const __m128i*)pixels);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(pixels + 4));
+        return {
+            _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask)),
+            _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask), _mm_and_si128(_mm_srli_epi32(hi, 8), mask)),
+            _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask), _mm_and_si128(_mm_srli_epi32(hi, 16), mask)),
+        };
+    }
+
+    // Same arithmetic as the scalar helpers. Luma sums reach 56,228, which
+    // still fits unsigned 16 bits; chroma stays within +-28,688.
+    __m128i Weigh(const Channels& c, short wr, short wg, short wb) {
+        return _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(c.r, _mm_set1_epi16(wr)),
+                                           _mm_mullo_epi16(c.g, _mm_set1_epi16(wg))),
+                             _mm_add_epi16(_mm_mullo_epi16(c.b, _mm_set1_epi16(wb)), _mm_set1_epi16(128)));
+    }
+
+    void StoreLuma(const Channels& c, uint8_t* out) {
+        __m128i y = _mm_add_epi16(_mm_srli_epi16(Weigh(c, 66, 129, 25), 8), _mm_set1_epi16(16));
+        _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(y, y));
+    }
+
+    // Means of horizontal pairs of a + b: four values, repeated in the upper lanes
+    __m128i BlockMean(__m128i a, __m128i b) {
+        __m128i sum = _mm_madd_epi16(_mm_add_epi16(a, b), _mm_set1_epi16(1));
+        sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+        return _mm_packs_epi32(sum, sum);
+    }
+
+    void StoreChroma(const Channels& mean, short wr, short wg, short wb, uint8_t* out) {
+        __m128i c = _mm_add_epi16(_mm_srai_epi16(Weigh(mean, wr, wg, wb), 8), _mm_set1_epi16(128));
+        uint32_t bytes = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+        memcpy(out, &bytes, 4);
+    }
+
+    // Eight pixels of two rows per step: 16 luma and 4 of each chroma sample
+    void ConvertPairSse2(const uint32_t* row0, const uint32_t* row1, int width,
+                         uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            Channels top = Split(row0 + x);
+            Channels bottom = Split(row1 + x);
+            StoreLuma(top, y0 + x);
+            StoreLuma(bottom, y1 + x);
+
+            Channels mean = { BlockMean(top.r, bottom.r), BlockMean(top.g, bottom.g), BlockMean(top.b, bottom.b) };
+            StoreChroma(mean, -38, -74, 112, u + x / 2);
+            StoreChroma(mean, 112, -94, -18, v + x / 2);
+        }
+        ConvertPairScalar(row0, row1, x, width, y0, y1, u, v);
+    }
+#endif
+}
+
+VideoRecorder::~VideoRecorder() {
+    Stop();
+}
+
+bool VideoRecorder::Start(const char* fileName, int width, int height, bool bottomUp) {
+    Stop();
+    file = fopen(fileName, "wb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "CAPTURE: Could not open %s", fileName);
+        return false;
+    }
+
+    this->fileName = fileName;
+    this->width = width & ~1;
+    this->height = height & ~1;
+    this->bottomUp = bottomUp;
+    sourceWidth = width;
+    sourceHeight = height;
+    fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", this->width, this->height, Constants::TargetFPS);
+
+    slots.assign(CaptureConst::RingFrames, std::vector<uint32_t>((size_t)width * height));
+    yuv.resize((size_t)this->width * this->height * 3 / 2);
+    head = 0;
+    filled = 0;
+    reserved = false;
+    stopping = false;
+    failed = false;
+    written = 0;
+    dropped = 0;
+    writer = std::thread(&VideoRecorder::Loop, this);
+
+    TraceLog(LOG_INFO, "CAPTURE: Recording %dx%d to %s", this->width, this->height, fileName);
+    return true;
+}
+
+void VideoRecorder::Stop() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    fclose(file);
+    file = nullptr;
+    slots.clear();
+    TraceLog(LOG_INFO, "CAPTURE: Wrote %lu frames to %s, dropped %lu", (unsigned long)written,
+             fileName.c_str(), (unsigned long)dropped);
+}
+
+uint32_t* VideoRecorder::BeginFrame(int frameWidth, int frameHeight) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (reserved || failed || filled == (int)slots.size() ||
+        frameWidth != sourceWidth || frameHeight != sourceHeight) {
+        dropped++;
+        return nullptr;
+    }
+    reserved = true;
+    return slots[(head + filled) % slots.size()].data();
+}
+
+void VideoRecorder::EndFrame() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!reserved) return;
+        reserved = false;
+        filled++;
+    }
+    wake.notify_one();
+}
+
+void VideoRecorder::Loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return filled > 0 || stopping; });
+        // Frames queued before Stop() still get written
+        if (filled == 0) break;
+
+        const std::vector<uint32_t>& frame = slots[head];
+        lock.unlock();
+
+        // Only this thread sets `failed`, so it can read it unlocked
+        bool ok = !failed;
+        if (ok) {
+            const uint32_t* top = bottomUp ? frame.data() + (size_t)(sourceHeight - 1) * sourceWidth : frame.data();
+            uint8_t* y = yuv.data();
+            uint8_t* u = y + (size_t)width * height;
+            uint8_t* v = u + (size_t)width * height / 4;
+            ConvertToYuv420(top, bottomUp ? -sourceWidth : sourceWidth, width, height, y, u, v);
+
+            ok = fputs("FRAME\n", file) >= 0 && fwrite(yuv.data(), 1, yuv.size(), file) == yuv.size();
+            if (ok) written++;
+            else TraceLog(LOG_WARNING, "CAPTURE: Write to %s failed, dropping the rest", fileName.c_str());
+        }
+
+        lock.lock();
+        head = (head + 1) % (int)slots.size();
+        filled--;
+        if (!ok) {
+            dropped++;
+            failed = true;
+        }
+    }
+}
+
+void VideoRecorder::ConvertToYuv420(const uint32_t* topRow, ptrdiff_t stride, int width, int height,
+                                    uint8_t* y, uint8_t* u, uint8_t* v) {
+    for (int row = 0; row < height; row += 2) {
+        const uint32_t* row0 = topRow + row * stride;
+        const uint32_t* row1 = row0 + stride;
+        uint8_t* y0 = y + (size_t)row * width;
+        uint8_t* chromaU = u + (size_t)(row / 2) * (width / 2);
+        uint8_t* chromaV = v + (size_t)(row / 2) * (width / 2);
+#ifdef VIDEO_SSE2
+        ConvertPairSse2(row0, row1, width, y0, y0 + width, chromaU, chromaV);
+#else
+        ConvertPairScalar(row0, row1, 0, width, y0, y0 + width, chromaU, chromaV);
+#endif
+    }
+}
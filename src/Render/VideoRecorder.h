@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams frames to a raw YUV4MPEG2 (.y4m) file. The render thread copies
+// each frame (read back asynchronously, see PixelReadback) into one of
+// Constants::Capture::RingFrames slots; a writer
+// thread converts it from RGBA to YUV 4:2:0 (BT.601, limited range) and
+// writes it out. When every slot is still waiting for the disk the frame
+// is dropped and counted, so capture never stalls the game.
+class VideoRecorder {
+public:
+    ~VideoRecorder();
+
+    // Odd sizes lose their last column or row (4:2:0 needs even ones).
+    // `bottomUp` says the frames arrive with the bottom row first, as GL reads them back.
+    bool Start(const char* fileName, int width, int height, bool bottomUp);
+    // Waits for the queued frames to be written and logs the totals
+    void Stop();
+    bool IsRecording() const { return writer.joinable(); }
+
+    // Slot for the next frame, width * height RGBA8 pixels as given to
+    // Start(), or nullptr if the ring is full or the size has changed since
+    // (the frame counts as dropped). Commit it with EndFrame().
+    uint32_t* BeginFrame(int frameWidth, int frameHeight);
+    void EndFrame();
+    // Counts a frame that never reached BeginFrame()
+    void DropFrame() { dropped++; }
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    unsigned long GetWrittenCount() const { return written; }
+    unsigned long GetDroppedCount() const { return dropped; }
+
+    // Converts even-sized RGBA8 to planar Y, U, V. `stride` is in pixels
+    // from one row to the next below it, negative for bottom-up frames.
+    static void ConvertToYuv420(const uint32_t* topRow, ptrdiff_t stride, int width, int height,
+                                uint8_t* y, uint8_t* u, uint8_t* v);
+
+private:
+    void Loop();
+
+    FILE* file = nullptr;
+    std::string fileName;
+    int width = 0;
+    int height = 0;
+    int sourceWidth = 0;        // Size of the submitted frames
+    int sourceHeight = 0;
+    bool bottomUp = false;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::vector<uint32_t>> slots;
+    int head = 0;               // Oldest filled slot, next to be written
+    int filled = 0;
+    bool reserved = false;      // The render thread holds slot (head + filled)
+    bool stopping = false;
+    bool failed = false;        // A write failed; the rest is dropped
+
+    std::vector<uint8_t> yuv;   // Writer thread only
+    std::atomic<unsigned long> written{0};
+    std::atomic<unsigned long> dropped{0};
+};